@@ -0,0 +1,96 @@
+#include "AutoExposure.h"
+#include "GLPlatform.h"
+#include "Trace.h"
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+	// Plage de l'histogramme, en log2 de la luminance ; la case 0 reçoit les pixels noirs
+	const float MIN_LOG_LUMINANCE = -10.0f;
+	const float MAX_LOG_LUMINANCE = 4.0f;
+}
+
+bool AutoExposure::Create()
+{
+#ifdef GL_VERSION_4_3
+	if (!GetGLCaps().computeShader)
+		return false;
+	if (!m_HistogramShader.LoadComputeShader("shaders/luminance_histogram.comp") || !m_HistogramShader.Create() ||
+		!m_AverageShader.LoadComputeShader("shaders/luminance_average.comp") || !m_AverageShader.Create())
+	{
+		m_HistogramShader.Destroy();
+		m_AverageShader.Destroy();
+		return false;
+	}
+
+	std::vector<uint32_t> zeros(BIN_COUNT, 0);
+	glGenBuffers(1, &m_Histogram);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_Histogram);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, BIN_COUNT * sizeof(uint32_t), zeros.data(), GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	// Luminance de départ : gris moyen, remplacé dès la première frame
+	float initial = 0.5f;
+	glGenTextures(1, &m_Texture);
+	glBindTexture(GL_TEXTURE_2D, m_Texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, 1, 1, 0, GL_RED, GL_FLOAT, &initial);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void AutoExposure::Destroy()
+{
+	m_HistogramShader.Destroy();
+	m_AverageShader.Destroy();
+	glDeleteBuffers(1, &m_Histogram);
+	glDeleteTextures(1, &m_Texture);
+	m_Histogram = m_Texture = 0;
+	m_LastUpdateUs = -1;
+}
+
+void AutoExposure::Update(uint32_t source, int width, int height, float adaptationSpeed)
+{
+#ifdef GL_VERSION_4_3
+	// Adaptation indépendante de la cadence : 1 - exp(-dt * vitesse)
+	int64_t now = Trace::NowUs();
+	float adaptation = 1.0f;
+	if (m_LastUpdateUs >= 0)
+		adaptation = 1.0f - std::exp(-(float)((now - m_LastUpdateUs) * 1.0e-6) * adaptationSpeed);
+	m_LastUpdateUs = now;
+
+	const float range = MAX_LOG_LUMINANCE - MIN_LOG_LUMINANCE;
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_Histogram);
+
+	uint32_t histogram = m_HistogramShader.GetProgram();
+	glUseProgram(histogram);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, source);
+	glUniform1i(glGetUniformLocation(histogram, "u_source"), 0);
+	glUniform2i(glGetUniformLocation(histogram, "u_size"), width, height);
+	glUniform1f(glGetUniformLocation(histogram, "u_minLogLuminance"), MIN_LOG_LUMINANCE);
+	glUniform1f(glGetUniformLocation(histogram, "u_inverseLogLuminanceRange"), 1.0f / range);
+	glDispatchCompute((width + GROUP_SIZE - 1) / GROUP_SIZE, (height + GROUP_SIZE - 1) / GROUP_SIZE, 1);
+	glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+	uint32_t average = m_AverageShader.GetProgram();
+	glUseProgram(average);
+	glBindImageTexture(0, m_Texture, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32F);
+	glUniform1i(glGetUniformLocation(average, "u_luminance"), 0);
+	glUniform1ui(glGetUniformLocation(average, "u_pixelCount"), (uint32_t)(width * height));
+	glUniform1f(glGetUniformLocation(average, "u_minLogLuminance"), MIN_LOG_LUMINANCE);
+	glUniform1f(glGetUniformLocation(average, "u_logLuminanceRange"), range);
+	glUniform1f(glGetUniformLocation(average, "u_adaptation"), adaptation);
+	glDispatchCompute(1, 1, 1);
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32F);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+#else
+	(void)source; (void)width; (void)height; (void)adaptationSpeed;
+#endif
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "GLShader.h"
+
+#include <cstdint>
+
+// Exposition automatique (compute shaders, GL 4.3). Deux dispatchs par frame :
+// - histogramme : chaque groupe de 16x16 pixels range la luminance logarithmique de ses pixels
+//   dans BIN_COUNT cases en mémoire partagée, puis ajoute ses compteurs à l'histogramme global ;
+// - moyenne : un seul groupe de BIN_COUNT threads réduit l'histogramme en parallèle (somme par
+//   dichotomie en mémoire partagée), remet les cases à zéro et rapproche la luminance adaptée
+//   de la moyenne de la frame, exponentiellement dans le temps.
+// La luminance adaptée reste sur le GPU (texture R32F 1x1 lue par le tonemapping) : aucune relecture.
+class AutoExposure
+{
+public:
+	static const int BIN_COUNT = 256;          // mêmes valeurs que shaders/luminance_*.comp
+	static const int GROUP_SIZE = 16;
+
+	AutoExposure() : m_Histogram(0), m_Texture(0), m_LastUpdateUs(-1) {}
+
+	// false sans compute shaders : l'exposition reste manuelle
+	bool Create();
+	void Destroy();
+	bool IsAvailable() const { return m_Texture != 0; }
+
+	// Texture R32F 1x1 : luminance moyenne adaptée (écrite par image)
+	uint32_t GetTexture() const { return m_Texture; }
+
+	// Histogramme de la zone [0, width] x [0, height] de la source, puis adaptation à la vitesse
+	// donnée (1/s) ; barrière avant lecture de la texture à la charge de l'appelant
+	void Update(uint32_t source, int width, int height, float adaptationSpeed);
+
+private:
+	GLShader m_HistogramShader;
+	GLShader m_AverageShader;
+	uint32_t m_Histogram;     // SSBO de BIN_COUNT compteurs
+	uint32_t m_Texture;
+	int64_t m_LastUpdateUs;   // -1 : première mise à jour, sans adaptation progressive
+};
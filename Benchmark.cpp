@@ -0,0 +1,233 @@
+#include "Benchmark.h"
+#include "GLPlatform.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdio.h>
+
+static double NowMs()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+CameraPath CameraPath::MakeOrbit()
+{
+	CameraPath path;
+	path.m_Name = "orbit";
+	const int poseCount = 64;
+	for (int i = 0; i <= poseCount; ++i)
+	{
+		float t = (float)i / poseCount;
+		CameraPose pose;
+		pose.yaw = 2.0f * 3.14159265f * t;
+		pose.pitch = 0.35f + 0.15f * sinf(4.0f * 3.14159265f * t);
+		pose.distance = 8.0f + 2.0f * cosf(2.0f * 3.14159265f * t);
+		path.Add(pose);
+	}
+	return path;
+}
+
+bool CameraPath::Load(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return false;
+	m_Poses.clear();
+	m_Name = path;
+	char line[256];
+	while (fgets(line, sizeof(line), file))
+	{
+		CameraPose pose;
+		if (line[0] != '#' && sscanf(line, "%f %f %f", &pose.yaw, &pose.pitch, &pose.distance) == 3)
+			m_Poses.push_back(pose);
+	}
+	fclose(file);
+	return !m_Poses.empty();
+}
+
+bool CameraPath::Save(const char* path) const
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+	fprintf(file, "# yaw pitch distance\n");
+	for (size_t i = 0; i < m_Poses.size(); ++i)
+		fprintf(file, "%.6f %.6f %.6f\n", m_Poses[i].yaw, m_Poses[i].pitch, m_Poses[i].distance);
+	fclose(file);
+	return true;
+}
+
+CameraPose CameraPath::Sample(float t) const
+{
+	if (m_Poses.size() < 2)
+		return m_Poses.empty() ? CameraPose{ 0.0f, 0.0f, 5.0f } : m_Poses[0];
+	float position = std::min(std::max(t, 0.0f), 1.0f) * (m_Poses.size() - 1);
+	size_t index = std::min((size_t)position, m_Poses.size() - 2);
+	float f = position - index;
+	const CameraPose& a = m_Poses[index];
+	const CameraPose& b = m_Poses[index + 1];
+	CameraPose pose;
+	pose.yaw = a.yaw + (b.yaw - a.yaw) * f;
+	pose.pitch = a.pitch + (b.pitch - a.pitch) * f;
+	pose.distance = a.distance + (b.distance - a.distance) * f;
+	return pose;
+}
+
+FrameTimeStats ComputeFrameTimeStats(const std::vector<double>& samples)
+{
+	FrameTimeStats stats;
+	if (samples.empty())
+		return stats;
+	std::vector<double> sorted = samples;
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0.0;
+	for (size_t i = 0; i < sorted.size(); ++i)
+		total += sorted[i];
+	// Percentiles au rang le plus proche
+	size_t last = sorted.size() - 1;
+	stats.min = sorted[0];
+	stats.mean = total / sorted.size();
+	stats.p50 = sorted[last * 50 / 100];
+	stats.p95 = sorted[last * 95 / 100];
+	stats.p99 = sorted[last * 99 / 100];
+	stats.max = sorted[last];
+	return stats;
+}
+
+void Benchmark::Start(const CameraPath& path, int warmupFrames, int measuredFrames)
+{
+	m_Path = path;
+	m_WarmupFrames = warmupFrames;
+	m_MeasuredFrames = measuredFrames;
+	m_Frame = -1;
+	m_Running = true;
+	m_CpuTimes.assign(measuredFrames, 0.0);
+	m_GpuTimes.assign(measuredFrames, -1.0);
+	if (!m_Queries[0][0])
+		glGenQueries(QUERY_LATENCY * 2, &m_Queries[0][0]);
+	for (uint32_t i = 0; i < QUERY_LATENCY; ++i)
+		m_QueryFrames[i] = -1;
+}
+
+void Benchmark::Destroy()
+{
+	if (m_Queries[0][0])
+		glDeleteQueries(QUERY_LATENCY * 2, &m_Queries[0][0]);
+	m_Queries[0][0] = 0;
+	m_Running = false;
+}
+
+CameraPose Benchmark::BeginFrame()
+{
+	m_Frame++;
+	int measured = GetMeasuredFrame();
+	if (measured >= 0)
+	{
+		// La paire de requêtes réutilisée date d'il y a QUERY_LATENCY frames : son résultat est prêt
+		uint32_t slot = (uint32_t)measured % QUERY_LATENCY;
+		ReadQueries(slot);
+		glQueryCounter(m_Queries[slot][0], GL_TIMESTAMP);
+		m_QueryFrames[slot] = measured;
+	}
+	m_FrameStart = NowMs();
+	return GetPose(m_Frame);
+}
+
+CameraPose Benchmark::GetPose(int frame) const
+{
+	int measured = frame - m_WarmupFrames;
+	if (measured < 0)
+		return m_Path.Sample(0.0f);
+	return m_Path.Sample(m_MeasuredFrames > 1 ? (float)measured / (m_MeasuredFrames - 1) : 0.0f);
+}
+
+void Benchmark::EndFrame()
+{
+	int measured = GetMeasuredFrame();
+	if (measured < 0 || measured >= m_MeasuredFrames)
+		return;
+	glQueryCounter(m_Queries[(uint32_t)measured % QUERY_LATENCY][1], GL_TIMESTAMP);
+	m_CpuTimes[measured] = NowMs() - m_FrameStart;
+}
+
+void Benchmark::ReadQueries(uint32_t slot)
+{
+	int frame = m_QueryFrames[slot];
+	if (frame < 0)
+		return;
+	GLuint64 begin = 0, end = 0;
+	glGetQueryObjectui64v(m_Queries[slot][0], GL_QUERY_RESULT, &begin);
+	glGetQueryObjectui64v(m_Queries[slot][1], GL_QUERY_RESULT, &end);
+	m_GpuTimes[frame] = (double)(end - begin) / 1000000.0;
+	m_QueryFrames[slot] = -1;
+}
+
+void Benchmark::Finish()
+{
+	for (uint32_t i = 0; i < QUERY_LATENCY; ++i)
+		ReadQueries(i);
+}
+
+static void PrintStats(const char* label, const FrameTimeStats& stats)
+{
+	printf("%s (ms): min %.3f  moy %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+		label, stats.min, stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+void Benchmark::PrintSummary() const
+{
+	FrameTimeStats cpu = ComputeFrameTimeStats(m_CpuTimes);
+	printf("benchmark: %s, %d + %d frames\n", m_Path.GetName().c_str(), m_WarmupFrames, m_MeasuredFrames);
+	PrintStats("frame CPU", cpu);
+	PrintStats("frame GPU", ComputeFrameTimeStats(m_GpuTimes));
+	if (cpu.mean > 0.0)
+		printf("%.1f fps\n", 1000.0 / cpu.mean);
+}
+
+static void WriteStatsJson(FILE* file, const char* name, const FrameTimeStats& stats)
+{
+	fprintf(file, "  \"%s\": { \"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+		name, stats.min, stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+static void WriteSamplesJson(FILE* file, const char* name, const std::vector<double>& samples, bool lastField)
+{
+	fprintf(file, "  \"%s\": [", name);
+	for (size_t i = 0; i < samples.size(); ++i)
+		fprintf(file, "%s%.4f", i ? ", " : "", samples[i]);
+	fprintf(file, "]%s\n", lastField ? "" : ",");
+}
+
+static std::string EscapeJson(const char* text)
+{
+	std::string escaped;
+	for (const char* c = text ? text : ""; *c; ++c)
+	{
+		if (*c == '"' || *c == '\\')
+			escaped += '\\';
+		escaped += *c;
+	}
+	return escaped;
+}
+
+bool Benchmark::WriteJson(const char* path, const char* renderer, const char* version) const
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+	fprintf(file, "{\n");
+	fprintf(file, "  \"renderer\": \"%s\",\n", EscapeJson(renderer).c_str());
+	fprintf(file, "  \"version\": \"%s\",\n", EscapeJson(version).c_str());
+	fprintf(file, "  \"path\": \"%s\",\n", EscapeJson(m_Path.GetName().c_str()).c_str());
+	fprintf(file, "  \"warmupFrames\": %d,\n", m_WarmupFrames);
+	fprintf(file, "  \"measuredFrames\": %d,\n", m_MeasuredFrames);
+	WriteStatsJson(file, "cpuMs", ComputeFrameTimeStats(m_CpuTimes));
+	WriteStatsJson(file, "gpuMs", ComputeFrameTimeStats(m_GpuTimes));
+	WriteSamplesJson(file, "cpuFrameMs", m_CpuTimes, false);
+	WriteSamplesJson(file, "gpuFrameMs", m_GpuTimes, true);
+	fprintf(file, "}\n");
+	bool ok = ferror(file) == 0;
+	fclose(file);
+	return ok;
+}
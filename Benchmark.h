@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Paramètres de la caméra orbitale (g_cameraYaw, g_cameraPitch, g_cameraDistance)
+struct CameraPose
+{
+	float yaw;
+	float pitch;
+	float distance;
+};
+
+// Trajectoire rejouée par le benchmark. Elle est échantillonnée par numéro de frame et non
+// par le temps réel : deux exécutions voient exactement les mêmes poses, quelle que soit la machine.
+class CameraPath
+{
+public:
+	// Tour complet de la scène avec un pitch et une distance qui oscillent
+	static CameraPath MakeOrbit();
+
+	// Une pose "yaw pitch distance" par ligne, '#' en début de ligne pour un commentaire
+	bool Load(const char* path);
+	bool Save(const char* path) const;
+
+	void Add(const CameraPose& pose) { m_Poses.push_back(pose); }
+	// t dans [0, 1], interpolation linéaire entre poses consécutives
+	CameraPose Sample(float t) const;
+
+	bool IsEmpty() const { return m_Poses.empty(); }
+	size_t GetCount() const { return m_Poses.size(); }
+	const std::string& GetName() const { return m_Name; }
+
+private:
+	std::vector<CameraPose> m_Poses;
+	std::string m_Name;
+};
+
+struct FrameTimeStats
+{
+	double min = 0.0;
+	double mean = 0.0;
+	double p50 = 0.0;
+	double p95 = 0.0;
+	double p99 = 0.0;
+	double max = 0.0;
+};
+
+FrameTimeStats ComputeFrameTimeStats(const std::vector<double>& samples);
+
+// N frames de chauffe (première pose) puis M frames mesurées le long de la trajectoire.
+// Temps CPU : de BeginFrame à EndFrame. Temps GPU : écart entre deux GL_TIMESTAMP posés aux
+// mêmes points, relus QUERY_LATENCY frames plus tard pour ne pas bloquer le pipeline.
+class Benchmark
+{
+public:
+	static const uint32_t QUERY_LATENCY = 4;
+
+	Benchmark() : m_WarmupFrames(0), m_MeasuredFrames(0), m_Frame(-1), m_Running(false), m_FrameStart(0.0),
+		m_Queries{}, m_QueryFrames{} {}
+
+	void Start(const CameraPath& path, int warmupFrames, int measuredFrames);
+	void Destroy();
+
+	bool IsRunning() const { return m_Running; }
+	// Toutes les frames mesurées ont été rendues
+	bool IsFinished() const { return m_Running && m_Frame + 1 >= m_WarmupFrames + m_MeasuredFrames; }
+	// Indice de la frame mesurée en cours (-1 pendant la chauffe)
+	int GetMeasuredFrame() const { return m_Frame - m_WarmupFrames; }
+
+	// Passe à la frame suivante et renvoie sa pose
+	CameraPose BeginFrame();
+	// Pose de la frame d'indice "frame" (chauffe comprise), sans toucher aux mesures : pour un
+	// thread qui prépare les frames en avance sur celui qui appelle BeginFrame
+	CameraPose GetPose(int frame) const;
+	int GetFrameCount() const { return m_WarmupFrames + m_MeasuredFrames; }
+	// À appeler une fois la frame soumise (après le swap ou le glFinish)
+	void EndFrame();
+	// Relit les requêtes encore en vol ; à appeler après la dernière frame
+	void Finish();
+
+	const std::vector<double>& GetCpuTimes() const { return m_CpuTimes; }
+	const std::vector<double>& GetGpuTimes() const { return m_GpuTimes; }
+
+	void PrintSummary() const;
+	bool WriteJson(const char* path, const char* renderer, const char* version) const;
+
+private:
+	void ReadQueries(uint32_t slot);
+
+	CameraPath m_Path;
+	int m_WarmupFrames;
+	int m_MeasuredFrames;
+	int m_Frame;
+	bool m_Running;
+	double m_FrameStart;                   // ms, horloge haute résolution
+	uint32_t m_Queries[QUERY_LATENCY][2];  // GL_TIMESTAMP début / fin par frame en vol
+	int m_QueryFrames[QUERY_LATENCY];      // frame mesurée associée à chaque paire (-1 : libre)
+	std::vector<double> m_CpuTimes;
+	std::vector<double> m_GpuTimes;
+};
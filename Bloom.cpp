@@ -0,0 +1,74 @@
+#include "Bloom.h"
+#include "GLPlatform.h"
+
+#include <algorithm>
+
+bool Bloom::Create()
+{
+	m_DownsampleShader.LoadVertexShader("shaders/fullscreen.vs");
+	m_DownsampleShader.LoadFragmentShader("shaders/bloom_downsample.fs");
+	m_UpsampleShader.LoadVertexShader("shaders/fullscreen.vs");
+	m_UpsampleShader.LoadFragmentShader("shaders/bloom_upsample.fs");
+	if (!m_DownsampleShader.Create() || !m_UpsampleShader.Create())
+		return false;
+	glGenVertexArrays(1, &m_Vao);
+	return true;
+}
+
+void Bloom::Destroy()
+{
+	m_DownsampleShader.Destroy();
+	m_UpsampleShader.Destroy();
+	glDeleteVertexArrays(1, &m_Vao);
+	m_Vao = 0;
+}
+
+void Bloom::LevelSize(int width, int height, int level, int& levelWidth, int& levelHeight)
+{
+	levelWidth = std::max(width >> level, 1);
+	levelHeight = std::max(height >> level, 1);
+}
+
+void Bloom::Downsample(uint32_t source, int sourceWidth, int sourceHeight, const float uvScale[2],
+	int targetWidth, int targetHeight, bool karisAverage)
+{
+	uint32_t program = m_DownsampleShader.GetProgram();
+	glUseProgram(program);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, source);
+	glUniform1i(glGetUniformLocation(program, "u_source"), 0);
+	glUniform2f(glGetUniformLocation(program, "u_sourceTexel"), 1.0f / sourceWidth, 1.0f / sourceHeight);
+	glUniform2f(glGetUniformLocation(program, "u_targetSize"), (float)targetWidth, (float)targetHeight);
+	glUniform2f(glGetUniformLocation(program, "u_uvScale"), uvScale[0], uvScale[1]);
+	// Dernier centre de texel de la zone lue : le filtrage bilinéaire ne déborde pas
+	glUniform2f(glGetUniformLocation(program, "u_uvMax"), uvScale[0] - 0.5f / sourceWidth, uvScale[1] - 0.5f / sourceHeight);
+	glUniform1i(glGetUniformLocation(program, "u_karisAverage"), karisAverage ? 1 : 0);
+
+	glViewport(0, 0, targetWidth, targetHeight);
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(m_Vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+}
+
+void Bloom::Upsample(uint32_t source, int sourceWidth, int sourceHeight, int targetWidth, int targetHeight)
+{
+	uint32_t program = m_UpsampleShader.GetProgram();
+	glUseProgram(program);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, source);
+	glUniform1i(glGetUniformLocation(program, "u_source"), 0);
+	glUniform2f(glGetUniformLocation(program, "u_sourceTexel"), 1.0f / sourceWidth, 1.0f / sourceHeight);
+	glUniform2f(glGetUniformLocation(program, "u_targetSize"), (float)targetWidth, (float)targetHeight);
+
+	glViewport(0, 0, targetWidth, targetHeight);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_ONE, GL_ONE);
+	glBindVertexArray(m_Vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glDisable(GL_BLEND);
+	glEnable(GL_DEPTH_TEST);
+}
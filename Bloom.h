@@ -0,0 +1,37 @@
+#pragma once
+
+#include "GLShader.h"
+
+#include <cstdint>
+
+// Bloom par pyramide de demi-résolutions (méthode présentée pour Call of Duty: Advanced Warfare),
+// sans seuil : toute la scène HDR diffuse, et seules les zones très lumineuses restent visibles
+// une fois mélangées avec un faible poids au tonemapping.
+// - descente : filtre à 13 lectures (cinq carrés de 4 texels qui se chevauchent), avec la
+//   moyenne de Karis au premier niveau pour éviter le scintillement des pixels isolés ;
+// - remontée : filtre tente 3x3 du niveau inférieur, ajouté au niveau courant (blending additif).
+// Le niveau 1 contient alors la somme de tous les niveaux.
+class Bloom
+{
+public:
+	static const int MAX_LEVELS = 6;
+
+	Bloom() : m_Vao(0) {}
+
+	bool Create();
+	void Destroy();
+
+	// Taille du niveau "level" (1 : moitié de la cible), au moins 1 texel
+	static void LevelSize(int width, int height, int level, int& levelWidth, int& levelHeight);
+
+	// Vers le framebuffer lié (targetWidth x targetHeight). Seule la zone [0, uvScale] de la source
+	// est lue : au premier niveau, la partie de la scène rendue (résolution dynamique).
+	void Downsample(uint32_t source, int sourceWidth, int sourceHeight, const float uvScale[2],
+		int targetWidth, int targetHeight, bool karisAverage);
+	void Upsample(uint32_t source, int sourceWidth, int sourceHeight, int targetWidth, int targetHeight);
+
+private:
+	GLShader m_DownsampleShader;
+	GLShader m_UpsampleShader;
+	uint32_t m_Vao;      // vide : triangle plein écran (shaders/fullscreen.vs)
+};
@@ -0,0 +1,111 @@
+#include "ColorGrading.h"
+#include "JobSystem.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	float Luminance(const float rgb[3])
+	{
+		return rgb[0] * 0.2126f + rgb[1] * 0.7152f + rgb[2] * 0.0722f;
+	}
+
+	float Clamp01(float value)
+	{
+		return std::min(std::max(value, 0.0f), 1.0f);
+	}
+}
+
+bool ColorGrading::SetOperations(const std::vector<ColorOperation>& operations)
+{
+	bool changed = !m_Valid || operations.size() != m_Operations.size();
+	for (size_t i = 0; i < operations.size() && !changed; ++i)
+	{
+		changed = operations[i].type != m_Operations[i].type || operations[i].amount != m_Operations[i].amount;
+	}
+	m_Operations = operations;
+	return changed;
+}
+
+void ColorGrading::Apply(float rgb[3]) const
+{
+	for (size_t i = 0; i < m_Operations.size(); ++i)
+	{
+		const ColorOperation& operation = m_Operations[i];
+		switch (operation.type)
+		{
+		case COLOR_GRAYSCALE:
+		{
+			float gray = Luminance(rgb);
+			rgb[0] = rgb[1] = rgb[2] = gray;
+			break;
+		}
+		case COLOR_INVERT:
+			for (int c = 0; c < 3; ++c)
+				rgb[c] = 1.0f - rgb[c];
+			break;
+		case COLOR_SEPIA:
+		{
+			float r = rgb[0] * 0.393f + rgb[1] * 0.769f + rgb[2] * 0.189f;
+			float g = rgb[0] * 0.349f + rgb[1] * 0.686f + rgb[2] * 0.168f;
+			float b = rgb[0] * 0.272f + rgb[1] * 0.534f + rgb[2] * 0.131f;
+			rgb[0] = Clamp01(r);
+			rgb[1] = Clamp01(g);
+			rgb[2] = Clamp01(b);
+			break;
+		}
+		case COLOR_SATURATION:
+		{
+			float luminance = Luminance(rgb);
+			for (int c = 0; c < 3; ++c)
+				rgb[c] = luminance + (rgb[c] - luminance) * operation.amount;
+			break;
+		}
+		case COLOR_CONTRAST:
+			for (int c = 0; c < 3; ++c)
+				rgb[c] = (rgb[c] - 0.5f) * operation.amount + 0.5f;
+			break;
+		}
+	}
+	for (int c = 0; c < 3; ++c)
+		rgb[c] = Clamp01(rgb[c]);
+}
+
+void ColorGrading::Bake(JobSystem& jobs, std::vector<uint8_t>& texels)
+{
+	TRACE_SCOPE("ColorGrading::Bake");
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	texels.resize(LUT_SIZE * LUT_SIZE * LUT_SIZE * 4);
+	m_Texels = texels.data();
+	jobs.ParallelFor(LUT_SIZE, 1, BakeSlices, this);
+	m_Texels = nullptr;
+	m_Valid = true;
+	m_BakeCount++;
+	m_BakeMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void ColorGrading::BakeSlices(void* data, uint32_t begin, uint32_t end)
+{
+	ColorGrading* grading = (ColorGrading*)data;
+	const float step = 1.0f / (LUT_SIZE - 1);
+	for (uint32_t b = begin; b < end; ++b)
+	{
+		uint8_t* texel = grading->m_Texels + b * LUT_SIZE * LUT_SIZE * 4;
+		for (int g = 0; g < LUT_SIZE; ++g)
+		{
+			for (int r = 0; r < LUT_SIZE; ++r)
+			{
+				// Nœuds aux extrémités du cube : 0 et 1 sont représentés exactement
+				float rgb[3] = { r * step, g * step, b * step };
+				grading->Apply(rgb);
+				texel[0] = (uint8_t)(rgb[0] * 255.0f + 0.5f);
+				texel[1] = (uint8_t)(rgb[1] * 255.0f + 0.5f);
+				texel[2] = (uint8_t)(rgb[2] * 255.0f + 0.5f);
+				texel[3] = 255;
+				texel += 4;
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class JobSystem;
+
+// Opérations de couleur du post-traitement, appliquées dans l'ordre de la chaîne
+enum ColorOperationType
+{
+	COLOR_GRAYSCALE = 0,
+	COLOR_INVERT = 1,
+	COLOR_SEPIA = 2,
+	COLOR_SATURATION = 3, // amount : 0 gris, 1 inchangé, 2 saturé
+	COLOR_CONTRAST = 4    // amount : autour de 0.5, 1 inchangé
+};
+
+struct ColorOperation
+{
+	ColorOperationType type;
+	float amount;
+};
+
+// Étalonnage des couleurs par LUT 3D : la chaîne d'opérations est évaluée sur le CPU pour
+// chaque nœud d'une grille LUT_SIZE^3 du cube RGB, et le shader du quad plein écran ne fait
+// plus qu'une lecture filtrée de cette texture. Le coût par pixel ne dépend donc pas du
+// nombre d'opérations ; la LUT n'est recalculée que lorsque la chaîne change.
+class ColorGrading
+{
+public:
+	static const int LUT_SIZE = 32;
+	// Unité de texture de la LUT dans le shader du quad (0 : scène, 1 : tableau des matériaux)
+	static const uint32_t LUT_TEXTURE_UNIT = 2;
+
+	ColorGrading() : m_Valid(false), m_Texels(nullptr), m_BakeCount(0), m_BakeMs(0.0f) {}
+
+	// Renvoie true si la chaîne diffère de celle de la dernière LUT (à recalculer)
+	bool SetOperations(const std::vector<ColorOperation>& operations);
+	const std::vector<ColorOperation>& GetOperations() const { return m_Operations; }
+
+	// Référence CPU : couleur dans [0, 1], résultat borné à [0, 1]
+	void Apply(float rgb[3]) const;
+
+	// Remplit "texels" (RGBA8, rouge le plus rapide puis vert puis bleu), une tranche de bleu par tâche
+	void Bake(JobSystem& jobs, std::vector<uint8_t>& texels);
+
+	uint32_t GetBakeCount() const { return m_BakeCount; }
+	float GetBakeMs() const { return m_BakeMs; }
+
+private:
+	static void BakeSlices(void* data, uint32_t begin, uint32_t end);
+
+	std::vector<ColorOperation> m_Operations;
+	bool m_Valid;              // une LUT a déjà été calculée pour m_Operations
+	uint8_t* m_Texels;
+	uint32_t m_BakeCount;
+	float m_BakeMs;
+};
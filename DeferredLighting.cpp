@@ -0,0 +1,51 @@
+#include "DeferredLighting.h"
+#include "GLPlatform.h"
+
+DeferredLighting::DeferredLighting()
+	: m_Vao(0)
+{
+}
+
+bool DeferredLighting::Create()
+{
+	m_Shader.LoadVertexShader("shaders/fullscreen.vs");
+	m_Shader.LoadFragmentShader("shaders/deferred_lighting.fs");
+	if (!m_Shader.Create())
+		return false;
+	glGenVertexArrays(1, &m_Vao);
+	return true;
+}
+
+void DeferredLighting::Destroy()
+{
+	m_Shader.Destroy();
+	glDeleteVertexArrays(1, &m_Vao);
+	m_Vao = 0;
+}
+
+void DeferredLighting::Draw(uint32_t albedo, uint32_t normal, uint32_t depth, const mat4& view, const mat4& projection,
+	int renderWidth, int renderHeight, UniformsFunction uniforms, void* user)
+{
+	uint32_t program = m_Shader.GetProgram();
+	glUseProgram(program);
+	const uint32_t textures[3] = { albedo, normal, depth };
+	const char* samplers[3] = { "u_gbufferAlbedo", "u_gbufferNormal", "u_depth" };
+	for (int i = 0; i < 3; ++i)
+	{
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, textures[i]);
+		glUniform1i(glGetUniformLocation(program, samplers[i]), i);
+	}
+	glActiveTexture(GL_TEXTURE0);
+	mat4 inverseViewProjection = mat4::inverse(projection * view);
+	glUniformMatrix4fv(glGetUniformLocation(program, "u_inverseViewProjection"), 1, GL_FALSE, inverseViewProjection.getPtr());
+	glUniform2f(glGetUniformLocation(program, "u_renderSize"), (float)renderWidth, (float)renderHeight);
+	uniforms(program, user);
+
+	glViewport(0, 0, renderWidth, renderHeight);
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(m_Vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "GLShader.h"
+#include "mat4.h"
+
+#include <cstdint>
+
+// Rendu différé : passe d'éclairage plein écran sur le G-buffer. Le G-buffer est rempli par les
+// variantes gbuffer*.fs des shaders d'objets, en deux cibles de couleur et la profondeur de scène :
+// - albedo (RGBA8) : rgb racine carrée de l'albedo (sombres plus précis sur 8 bits), a intensité
+//   spéculaire (Ks ramené à sa plus grande composante) ;
+// - normale (RGB10_A2) : rg normale en projection octaédrique, b rugosité (brillance Ns encodée
+//   par sqrt(2 / (Ns + 2))), a 1 pour une surface éclairée, 0 pour une couleur telle quelle
+//   (texture seule, réflexion de l'environnement) ;
+// - profondeur : la position monde en est reconstruite avec la projection de la frame.
+// Chaque pixel n'est éclairé qu'une fois, quel que soit le surdessin de la géométrie : lumière
+// principale, puis lumières dynamiques de son cluster (LightClusters), avec les mêmes formules
+// que phong.fs.
+class DeferredLighting
+{
+public:
+	// Uniforms communs au rendu forward (lumière principale, clusters...) du programme lié
+	typedef void (*UniformsFunction)(uint32_t program, void* user);
+
+	DeferredLighting();
+
+	bool Create();
+	void Destroy();
+
+	// Programme de la passe, pour la liaison des blocs uniformes (Matrices)
+	uint32_t GetProgram() const { return m_Shader.GetProgram(); }
+
+	// Vers le framebuffer lié, sur la zone rendue : albedo, normal et depth en couvrent le coin
+	// renderWidth x renderHeight ; projection décalée par le TAA le cas échéant
+	void Draw(uint32_t albedo, uint32_t normal, uint32_t depth, const mat4& view, const mat4& projection,
+		int renderWidth, int renderHeight, UniformsFunction uniforms, void* user);
+
+private:
+	GLShader m_Shader;
+	uint32_t m_Vao;                  // vide : triangle plein écran (shaders/fullscreen.vs)
+};
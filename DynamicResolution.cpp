@@ -0,0 +1,77 @@
+#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+void DynamicResolution::SetEnabled(bool enabled)
+{
+	if (enabled == m_Enabled)
+		return;
+	m_Enabled = enabled;
+	if (m_Enabled)
+		m_Scale = std::min(std::max(m_Scale, m_MinScale), m_MaxScale);
+}
+
+void DynamicResolution::SetBounds(float minScale, float maxScale)
+{
+	m_MaxScale = std::min(std::max(maxScale, 0.1f), 1.0f);
+	m_MinScale = std::min(std::max(minScale, 0.1f), m_MaxScale);
+	if (m_Enabled)
+		m_Scale = std::min(std::max(m_Scale, m_MinScale), m_MaxScale);
+}
+
+void DynamicResolution::SetScale(float scale, uint32_t frame)
+{
+	scale = std::min(std::max(scale, 0.1f), 1.0f);
+	if (scale == m_Scale)
+		return;
+	m_Scale = scale;
+	m_SettleFrame = frame;
+	m_Samples = 0;
+	m_GpuMs = 0.0f;
+	m_Changes++;
+}
+
+void DynamicResolution::AddSample(uint32_t frame, float gpuMs)
+{
+	// Frame rendue avec une ancienne échelle
+	if (frame < m_SettleFrame || gpuMs <= 0.0f)
+		return;
+	// Même résultat relu plusieurs fois quand le GPU prend du retard : une seule mesure par frame
+	if (frame < m_NextSampleFrame)
+		return;
+	m_NextSampleFrame = frame + 1;
+	m_GpuMs = m_Samples == 0 ? gpuMs : m_GpuMs * 0.7f + gpuMs * 0.3f;
+	m_Samples++;
+}
+
+float DynamicResolution::Update(uint32_t frame)
+{
+	if (!m_Enabled || m_Samples < SETTLE_SAMPLES || m_BudgetMs <= 0.0f)
+		return m_Scale;
+
+	float ratio = m_BudgetMs / m_GpuMs;
+	float target = m_Scale;
+	if (ratio < 1.0f)
+	{
+		// Hors budget : on vise 95 % du budget en une fois
+		target = m_Scale * std::sqrt(ratio * 0.95f);
+	}
+	else if (ratio > 1.25f)
+	{
+		// Marge confortable : hausse d'au plus 10 % par ajustement
+		target = m_Scale * std::min(std::sqrt(ratio * 0.9f), 1.1f);
+	}
+
+	target = std::floor(target * SCALE_STEPS) / SCALE_STEPS;
+	target = std::min(std::max(target, m_MinScale), m_MaxScale);
+	if (target != m_Scale)
+		SetScale(target, frame);
+	return m_Scale;
+}
+
+void DynamicResolution::ScaledSize(int width, int height, float scale, int& scaledWidth, int& scaledHeight)
+{
+	scaledWidth = std::max(1, (int)(width * scale + 0.5f));
+	scaledHeight = std::max(1, (int)(height * scale + 0.5f));
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+// Résolution dynamique : échelle de la résolution interne de la scène (rapport à la taille de
+// sortie, appliquée aux deux axes) pilotée par le temps GPU des frames. Le coût de la scène
+// est supposé proportionnel au nombre de pixels, donc au carré de l'échelle : l'échelle visée
+// est scale * sqrt(budget / temps mesuré). La baisse est rapide, la hausse plus lente et
+// soumise à une marge, pour éviter d'osciller autour du budget.
+// Les temps GPU arrivent avec quelques frames de retard : après un changement d'échelle, les
+// mesures des frames rendues avec l'ancienne échelle sont ignorées.
+class DynamicResolution
+{
+public:
+	// Pas de l'échelle : évite de changer le viewport pour quelques pixels
+	static const int SCALE_STEPS = 40;
+	// Mesures nécessaires après un changement avant d'ajuster de nouveau
+	static const int SETTLE_SAMPLES = 4;
+
+	DynamicResolution() : m_Enabled(false), m_MinScale(0.5f), m_MaxScale(1.0f), m_BudgetMs(16.0f),
+		m_Scale(1.0f), m_GpuMs(0.0f), m_SettleFrame(0), m_NextSampleFrame(0), m_Samples(0), m_Changes(0) {}
+
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const { return m_Enabled; }
+
+	// Bornes de l'échelle, dans ]0, 1]
+	void SetBounds(float minScale, float maxScale);
+	void SetBudgetMs(float budgetMs) { m_BudgetMs = budgetMs; }
+	float GetMinScale() const { return m_MinScale; }
+	float GetMaxScale() const { return m_MaxScale; }
+	float GetBudgetMs() const { return m_BudgetMs; }
+
+	// Échelle imposée : mode fixe, ou point de départ du contrôleur. "frame" est la première
+	// frame rendue avec cette échelle.
+	void SetScale(float scale, uint32_t frame);
+
+	// Temps GPU de la frame d'indice "frame", une fois relu ; une frame déjà prise est ignorée
+	void AddSample(uint32_t frame, float gpuMs);
+	// Échelle de la frame d'indice "frame" (à appeler avant son rendu)
+	float Update(uint32_t frame);
+
+	float GetScale() const { return m_Scale; }
+	// Moyenne lissée des mesures prises depuis le dernier changement d'échelle
+	float GetGpuMs() const { return m_GpuMs; }
+	uint32_t GetChangeCount() const { return m_Changes; }
+
+	// Taille de rendu pour une sortie donnée, au moins 1x1
+	static void ScaledSize(int width, int height, float scale, int& scaledWidth, int& scaledHeight);
+
+private:
+	bool m_Enabled;
+	float m_MinScale;
+	float m_MaxScale;
+	float m_BudgetMs;
+	float m_Scale;
+	float m_GpuMs;
+	uint32_t m_SettleFrame;   // première frame rendue avec l'échelle courante
+	uint32_t m_NextSampleFrame; // frame suivant la dernière mesure prise
+	int m_Samples;            // mesures valides depuis ce changement
+	uint32_t m_Changes;
+};
@@ -0,0 +1,92 @@
+#include "FramePacer.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <mmsystem.h>
+#endif
+
+static double NowMs()
+{
+	return Trace::NowUs() / 1000.0;
+}
+
+static float Smooth(float value, float sample)
+{
+	return value == 0.0f ? sample : value * 0.9f + sample * 0.1f;
+}
+
+void FramePacer::Create()
+{
+#ifdef _WIN32
+	// Granularité du sommeil à 1 ms au lieu de 15,6 ms
+	timeBeginPeriod(1);
+#endif
+}
+
+void FramePacer::Destroy()
+{
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::SetTargetFps(float fps)
+{
+	if (fps != m_TargetFps)
+		m_NextDeadline = 0.0;
+	m_TargetFps = fps;
+}
+
+void FramePacer::Wait()
+{
+	if (m_TargetFps <= 0.0f)
+	{
+		m_SleepMs = m_SpinMs = 0.0f;
+		return;
+	}
+
+	double period = 1000.0 / m_TargetFps;
+	double now = NowMs();
+	// Échéances régulières ; après un retard de plus d'une période, on repart de maintenant
+	// plutôt que d'enchaîner des frames pour rattraper
+	m_NextDeadline = (m_NextDeadline == 0.0 || now - m_NextDeadline > period) ? now + period : m_NextDeadline + period;
+
+	double sleepStart = now;
+	double wakeTarget = m_NextDeadline - m_SpinMarginMs;
+	if (wakeTarget > now)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds((int64_t)((wakeTarget - now) * 1000.0)));
+		double overshoot = NowMs() - wakeTarget;
+		// Marge = 1,5 x le dépassement observé, bornée entre 0,5 et 4 ms
+		double wanted = std::min(4.0, std::max(0.5, overshoot * 1.5));
+		m_SpinMarginMs = m_SpinMarginMs * 0.9 + wanted * 0.1;
+	}
+	double spinStart = NowMs();
+	while (NowMs() < m_NextDeadline)
+		std::this_thread::yield();
+	double end = NowMs();
+
+	m_SleepMs = Smooth(m_SleepMs, (float)(spinStart - sleepStart));
+	m_SpinMs = Smooth(m_SpinMs, (float)(end - spinStart));
+}
+
+double FramePacer::MarkInputSampled()
+{
+	return NowMs();
+}
+
+void FramePacer::MarkPresented(double inputSampleMs)
+{
+	double now = NowMs();
+	if (m_LastPresent > 0.0)
+		m_FrameMs = Smooth(m_FrameMs, (float)(now - m_LastPresent));
+	if (inputSampleMs > 0.0)
+		m_LatencyMs = Smooth(m_LatencyMs, (float)(now - inputSampleMs));
+	m_LastPresent = now;
+}
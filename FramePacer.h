@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+// Cadencement de la boucle principale : limite de fréquence optionnelle et mesure de latence.
+// L'attente se fait par un sommeil jusqu'à une marge avant l'échéance, puis une attente active
+// pour la fin : le sommeil de l'OS dépasse souvent d'une ou deux millisecondes. La marge
+// s'adapte au dépassement observé.
+// Avec un thread de rendu, Wait et MarkInputSampled sont appelés par le thread principal et
+// MarkPresented par le thread de rendu : chaque membre n'est écrit que d'un côté, et les valeurs
+// de MarkPresented (GetFrameMs, GetLatencyMs) ne doivent être lues que par le thread de rendu.
+class FramePacer
+{
+public:
+	FramePacer() : m_TargetFps(0.0f), m_NextDeadline(0.0), m_SpinMarginMs(2.0), m_LastPresent(0.0),
+		m_FrameMs(0.0f), m_LatencyMs(0.0f), m_SleepMs(0.0f), m_SpinMs(0.0f) {}
+
+	void Create();
+	void Destroy();
+
+	// 0 : pas de limite (seule la vsync cadence la boucle)
+	void SetTargetFps(float fps);
+	float GetTargetFps() const { return m_TargetFps; }
+
+	// Bloque jusqu'à l'échéance de la frame suivante (retour immédiat sans limite)
+	void Wait();
+	// Juste après la lecture des entrées (glfwPollEvents) ; renvoie la date à passer à MarkPresented
+	double MarkInputSampled();
+	// Juste après le swap de la frame dont les entrées ont été lues à "inputSampleMs" : clôt la
+	// mesure de la frame et de la latence entrée -> présentation
+	void MarkPresented(double inputSampleMs);
+
+	// Valeurs lissées, en ms
+	float GetFrameMs() const { return m_FrameMs; }
+	float GetLatencyMs() const { return m_LatencyMs; }
+	float GetSleepMs() const { return m_SleepMs; }
+	float GetSpinMs() const { return m_SpinMs; }
+	float GetSpinMarginMs() const { return (float)m_SpinMarginMs; }
+
+private:
+	float m_TargetFps;
+	double m_NextDeadline;   // ms, horloge de Trace::NowUs
+	double m_SpinMarginMs;
+	double m_LastPresent;
+	float m_FrameMs;
+	float m_LatencyMs;
+	float m_SleepMs;
+	float m_SpinMs;
+};
@@ -0,0 +1,47 @@
+#include "GLPlatform.h"
+
+#include <cstring>
+
+static GLCaps s_Caps;
+
+bool HasGLExtension(const char* name)
+{
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; ++i)
+	{
+		const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (extension && strcmp(extension, name) == 0)
+			return true;
+	}
+	return false;
+}
+
+void DetectGLCaps()
+{
+	glGetIntegerv(GL_MAJOR_VERSION, &s_Caps.major);
+	glGetIntegerv(GL_MINOR_VERSION, &s_Caps.minor);
+	int version = s_Caps.major * 10 + s_Caps.minor;
+	glGetIntegerv(GL_MAX_SAMPLES, &s_Caps.maxSamples);
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &s_Caps.maxTextureBufferSize);
+
+#ifdef GL_VERSION_4_3
+	// Les shaders correspondants sont en #version 430 : on exige le contexte, pas l'extension
+	s_Caps.multiDrawIndirect = version >= 43;
+	s_Caps.shaderStorageBuffer = version >= 43;
+	s_Caps.computeShader = version >= 43;
+#else
+	(void)version;
+#endif
+#ifdef GL_VERSION_4_4
+	s_Caps.bufferStorage = version >= 44 || HasGLExtension("GL_ARB_buffer_storage");
+#endif
+#ifdef GL_ARB_bindless_texture
+	s_Caps.bindlessTexture = HasGLExtension("GL_ARB_bindless_texture");
+#endif
+}
+
+const GLCaps& GetGLCaps()
+{
+	return s_Caps;
+}
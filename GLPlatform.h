@@ -0,0 +1,38 @@
+#pragma once
+
+// En-têtes OpenGL selon la plateforme (GLEW sous Windows, framework OpenGL sous macOS,
+// prototypes de glext.h sous Linux avec GL_GLEXT_PROTOTYPES)
+#ifdef _WIN32
+#include <GL/glew.h>
+#include <GL/wglew.h>
+#endif
+
+#ifdef __APPLE__
+#include <OpenGL/gl3.h>
+#include <OpenGL/OpenGL.h>
+#endif
+
+#ifdef __linux__
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+// Fonctionnalités détectées à l'exécution sur le contexte courant. Les chemins 4.x sont
+// en plus protégés à la compilation par GL_VERSION_4_x (absents des en-têtes macOS).
+struct GLCaps
+{
+	int major = 3;
+	int minor = 3;
+	bool multiDrawIndirect = false;   // glMultiDrawElementsIndirect (GL 4.3)
+	bool shaderStorageBuffer = false; // SSBO (GL 4.3)
+	bool computeShader = false;       // compute shaders et images (GL 4.3)
+	bool bufferStorage = false;       // glBufferStorage + mapping persistant (GL 4.4 ou ARB_buffer_storage)
+	bool bindlessTexture = false;     // ARB_bindless_texture (extension seulement)
+	int maxSamples = 1;               // GL_MAX_SAMPLES : MSAA des renderbuffers
+	int maxTextureBufferSize = 65536; // GL_MAX_TEXTURE_BUFFER_SIZE, en texels
+};
+
+// À appeler une fois le contexte courant créé
+void DetectGLCaps();
+const GLCaps& GetGLCaps();
+bool HasGLExtension(const char* name);
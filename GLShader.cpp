@@ -1,38 +1,63 @@
 #include "GLShader.h"
-#ifdef _WIN32
-#include <GL/glew.h>
-#include <GL/wglew.h>
-#endif
-
-#ifdef __APPLE__
-#include <OpenGL/gl3.h>
-#include <OpenGL/OpenGL.h>
-#endif
+#include "GLPlatform.h"
+#include "Trace.h"
 
 #include <fstream>
+#include <string>
 // <iostream> is no longer needed here as debug outputs are removed
 
+namespace
+{
+	const char INCLUDE_DIRECTIVE[] = "#include \"";
+	const int MAX_INCLUDE_DEPTH = 8;
+
+	// Source d'un shader : chaque ligne #include "fichier" (chemin relatif au fichier qui
+	// l'inclut) est remplacée par le contenu du fichier, lui-même développé. Partage le code
+	// d'éclairage entre shaders (GLSL n'a pas d'inclusion)
+	bool ReadSource(const std::string& filename, std::string& source, int depth)
+	{
+		std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+		if (!fin)
+			return false;
+		size_t slash = filename.find_last_of("/\\");
+		std::string directory = slash == std::string::npos ? std::string() : filename.substr(0, slash + 1);
+		const size_t directiveLength = sizeof(INCLUDE_DIRECTIVE) - 1;
+		std::string line;
+		while (std::getline(fin, line))
+		{
+			size_t start = line.find_first_not_of(" \t");
+			if (start != std::string::npos && line.compare(start, directiveLength, INCLUDE_DIRECTIVE) == 0)
+			{
+				size_t nameStart = start + directiveLength;
+				size_t nameEnd = line.find('"', nameStart);
+				if (nameEnd == std::string::npos || depth >= MAX_INCLUDE_DEPTH ||
+					!ReadSource(directory + line.substr(nameStart, nameEnd - nameStart), source, depth + 1))
+					return false;
+				continue;
+			}
+			source += line;
+			source += '\n';
+		}
+		return true;
+	}
+}
+
 bool GLShader::LoadVertexShader(const char* filename)
 {
-	// 1. Load the file content
-	std::ifstream fin(filename, std::ios::in | std::ios::binary);
-	fin.seekg(0, std::ios::end);
-	uint32_t length = (uint32_t)fin.tellg();
-	fin.seekg(0, std::ios::beg);
-	char* buffer = new char[length + 1];
-	buffer[length] = '\0';
-	fin.read(buffer, length);
-	fin.close();
+	TRACE_SCOPE_DETAIL("GLShader::LoadVertexShader", filename);
+	// 1. Load the file content (#include expanded)
+	std::string source;
+	if (!ReadSource(filename, source, 0))
+		return false;
+	const char* buffer = source.c_str();
 	
 	// 2. Create the shader object
 	m_VertexShader = glCreateShader(GL_VERTEX_SHADER);
 	glShaderSource(m_VertexShader, 1, &buffer, nullptr);
 	// 3. Compile the shader
 	glCompileShader(m_VertexShader);
-	// 4. Clean up buffer
-	delete[] buffer;
 	
-	// 5. Check compilation status
+	// 4. Check compilation status
     GLint compiled;
     glGetShaderiv(m_VertexShader, GL_COMPILE_STATUS, &compiled);
     if (!compiled) {
@@ -45,25 +70,20 @@ bool GLShader::LoadVertexShader(const char* filename)
 
 bool GLShader::LoadGeometryShader(const char* filename)
 {
-	// 1. Load the file content
-	std::ifstream fin(filename, std::ios::in | std::ios::binary);
-	fin.seekg(0, std::ios::end);
-	uint32_t length = (uint32_t)fin.tellg();
-	fin.seekg(0, std::ios::beg);
-	char* buffer = new char[length + 1];
-	buffer[length] = '\0';
-	fin.read(buffer, length);
-	fin.close();
+	TRACE_SCOPE_DETAIL("GLShader::LoadGeometryShader", filename);
+	// 1. Load the file content (#include expanded)
+	std::string source;
+	if (!ReadSource(filename, source, 0))
+		return false;
+	const char* buffer = source.c_str();
 
 	// 2. Create the shader object
 	m_GeometryShader = glCreateShader(GL_GEOMETRY_SHADER);
 	glShaderSource(m_GeometryShader, 1, &buffer, nullptr);
 	// 3. Compile the shader
 	glCompileShader(m_GeometryShader);
-	// 4. Clean up buffer
-	delete[] buffer;
 
-    // 5. Check compilation status
+    // 4. Check compilation status
     GLint compiled;
     glGetShaderiv(m_GeometryShader, GL_COMPILE_STATUS, &compiled);
     if (!compiled) {
@@ -76,24 +96,20 @@ bool GLShader::LoadGeometryShader(const char* filename)
 
 bool GLShader::LoadFragmentShader(const char* filename)
 {
-	std::ifstream fin(filename, std::ios::in | std::ios::binary);
-	fin.seekg(0, std::ios::end);
-	uint32_t length = (uint32_t)fin.tellg();
-	fin.seekg(0, std::ios::beg);
-	char* buffer = new char[length + 1];
-	buffer[length] = '\0';
-	fin.read(buffer, length);
-	fin.close();
+	TRACE_SCOPE_DETAIL("GLShader::LoadFragmentShader", filename);
+	// 1. Load the file content (#include expanded)
+	std::string source;
+	if (!ReadSource(filename, source, 0))
+		return false;
+	const char* buffer = source.c_str();
 	
 	// 2. Create the shader object
 	m_FragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
 	glShaderSource(m_FragmentShader, 1, &buffer, nullptr);
 	// 3. Compile the shader
 	glCompileShader(m_FragmentShader);
-	// 4. Clean up buffer
-	delete[] buffer;
 	
-	// 5. Check compilation status
+	// 4. Check compilation status
     GLint compiled;
     glGetShaderiv(m_FragmentShader, GL_COMPILE_STATUS, &compiled);
     if (!compiled) {
@@ -104,9 +120,55 @@ bool GLShader::LoadFragmentShader(const char* filename)
 	return true;
 }
 
+bool GLShader::LoadComputeShader(const char* filename)
+{
+	TRACE_SCOPE_DETAIL("GLShader::LoadComputeShader", filename);
+#ifdef GL_VERSION_4_3
+	// 1. Load the file content (#include expanded)
+	std::string source;
+	if (!ReadSource(filename, source, 0))
+		return false;
+	const char* buffer = source.c_str();
+
+	m_ComputeShader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(m_ComputeShader, 1, &buffer, nullptr);
+	glCompileShader(m_ComputeShader);
+
+    GLint compiled;
+    glGetShaderiv(m_ComputeShader, GL_COMPILE_STATUS, &compiled);
+    if (!compiled) {
+        glDeleteShader(m_ComputeShader);
+        m_ComputeShader = 0;
+        return false;
+    }
+	return true;
+#else
+	return false;
+#endif
+}
+
 bool GLShader::Create()
 {
+	TRACE_SCOPE("GLShader::Create");
 	m_Program = glCreateProgram();
+	if (m_ComputeShader)
+	{
+		// Programme de calcul : pas d'étages graphiques
+		glAttachShader(m_Program, m_ComputeShader);
+		glLinkProgram(m_Program);
+		GLint linked = 0;
+		glGetProgramiv(m_Program, GL_LINK_STATUS, &linked);
+		glDetachShader(m_Program, m_ComputeShader);
+		glDeleteShader(m_ComputeShader);
+		m_ComputeShader = 0;
+		if (!linked)
+		{
+			glDeleteProgram(m_Program);
+			m_Program = 0;
+			return false;
+		}
+		return true;
+	}
 	glAttachShader(m_Program, m_VertexShader);
 	if (m_GeometryShader) // Check if geometry shader was loaded
 		glAttachShader(m_Program, m_GeometryShader);
@@ -156,4 +218,5 @@ void GLShader::Destroy()
     m_VertexShader = 0;
     m_GeometryShader = 0;
     m_FragmentShader = 0;
+    m_ComputeShader = 0;
 }
@@ -14,19 +14,22 @@ private:
 	// Un Fragment Shader est execute pour chaque "pixel"
 	// lors de la rasterization/remplissage de la primitive
 	uint32_t m_FragmentShader;
+	// Un Compute Shader est execute hors du pipeline graphique, seul dans son programme
+	uint32_t m_ComputeShader;
 
 public:
 	// Initialisation des membres dans le constructeur
 	GLShader() : m_Program(0), m_VertexShader(0),
-		m_GeometryShader(0), m_FragmentShader(0) {
+		m_GeometryShader(0), m_FragmentShader(0), m_ComputeShader(0) {
 	}
 	~GLShader() {}
 
-	inline uint32_t GetProgram() { return m_Program; }
+	inline uint32_t GetProgram() const { return m_Program; }
 
 	bool LoadVertexShader(const char* filename);
 	bool LoadGeometryShader(const char* filename);
 	bool LoadFragmentShader(const char* filename);
+	bool LoadComputeShader(const char* filename);
 	bool Create();
 	void Destroy();
 };
@@ -0,0 +1,166 @@
+#include "GpuProfiler.h"
+#include "GLPlatform.h"
+#include "Trace.h"
+
+#include <cstddef>
+
+// Même horloge que les traces, pour y reporter les sections telles quelles
+static double NowMs()
+{
+	return Trace::NowUs() / 1000.0;
+}
+
+void GpuProfiler::Destroy()
+{
+	for (uint32_t i = 0; i < FRAME_LATENCY; ++i)
+	{
+		FrameData& data = m_Frames[i];
+		if (!data.queries.empty())
+			glDeleteQueries((GLsizei)data.queries.size(), data.queries.data());
+		data.queries.clear();
+		data.scopes.clear();
+		data.pending = false;
+	}
+}
+
+void GpuProfiler::BeginFrame()
+{
+	// Décalage entre l'horloge GPU et celle des traces, mesuré au début de chaque enregistrement
+	if (Trace::IsRecording() && !m_TraceCalibrated)
+	{
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		m_GpuToTraceUs = Trace::NowUs() - gpuNow / 1000;
+		m_TraceCalibrated = true;
+	}
+	else if (!Trace::IsRecording())
+	{
+		m_TraceCalibrated = false;
+	}
+
+	// Relecture non bloquante des frames en vol, de la plus ancienne à la plus récente
+	for (uint32_t age = FRAME_LATENCY; age > 0; --age)
+	{
+		if (m_Frame < age)
+			continue;
+		FrameData& data = m_Frames[(m_Frame - age) % FRAME_LATENCY];
+		if (data.pending && data.frame == m_Frame - age && Resolve(data))
+			PushHistory();
+	}
+
+	FrameData& data = m_Frames[m_Frame % FRAME_LATENCY];
+	if (data.pending)
+	{
+		// Le GPU a plus de FRAME_LATENCY frames de retard : on réutilise les requêtes sans attendre
+		m_DroppedFrames++;
+		data.pending = false;
+	}
+	data.scopes.clear();
+	data.cpuStarts.clear();
+	data.stack.clear();
+	data.frame = m_Frame;
+	data.cpuOrigin = NowMs();
+	m_Active = m_Enabled;
+	BeginScope("Frame");
+}
+
+void GpuProfiler::EndFrame()
+{
+	FrameData& data = m_Frames[m_Frame % FRAME_LATENCY];
+	while (!data.stack.empty())
+		EndScope();
+	data.pending = m_Active && !data.scopes.empty();
+	m_Frame++;
+}
+
+void GpuProfiler::BeginScope(const char* name)
+{
+	if (!m_Active)
+		return;
+	FrameData& data = m_Frames[m_Frame % FRAME_LATENCY];
+	size_t index = data.scopes.size();
+	if (data.queries.size() < (index + 1) * 2)
+	{
+		// Le pool de requêtes grandit avec le nombre de sections, puis est réutilisé
+		size_t previous = data.queries.size();
+		data.queries.resize((index + 1) * 2);
+		glGenQueries((GLsizei)(data.queries.size() - previous), data.queries.data() + previous);
+	}
+	ProfileScope scope = { name, (int)data.stack.size(), 0.0f, 0.0f, 0.0f, 0.0f };
+	data.scopes.push_back(scope);
+	data.cpuStarts.push_back(NowMs());
+	data.stack.push_back((int)index);
+	glQueryCounter(data.queries[index * 2], GL_TIMESTAMP);
+}
+
+void GpuProfiler::EndScope()
+{
+	FrameData& data = m_Frames[m_Frame % FRAME_LATENCY];
+	if (data.stack.empty())
+		return;
+	int index = data.stack.back();
+	data.stack.pop_back();
+	glQueryCounter(data.queries[index * 2 + 1], GL_TIMESTAMP);
+	ProfileScope& scope = data.scopes[index];
+	scope.cpuStartMs = (float)(data.cpuStarts[index] - data.cpuOrigin);
+	scope.cpuMs = (float)(NowMs() - data.cpuStarts[index]);
+	if (Trace::IsRecording())
+		Trace::RecordCpu(scope.name, (int64_t)(data.cpuStarts[index] * 1000.0), (int64_t)(scope.cpuMs * 1000.0));
+}
+
+bool GpuProfiler::Resolve(FrameData& data)
+{
+	// Les requêtes aboutissent dans l'ordre : la fin de la racine, posée en dernier, suffit
+	GLint available = 0;
+	glGetQueryObjectiv(data.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available)
+		return false;
+
+	GLuint64 origin = 0;
+	glGetQueryObjectui64v(data.queries[0], GL_QUERY_RESULT, &origin);
+	for (size_t i = 0; i < data.scopes.size(); ++i)
+	{
+		GLuint64 begin = 0, end = 0;
+		glGetQueryObjectui64v(data.queries[i * 2], GL_QUERY_RESULT, &begin);
+		glGetQueryObjectui64v(data.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+		data.scopes[i].gpuStartMs = (float)((double)(begin - origin) / 1000000.0);
+		data.scopes[i].gpuMs = (float)((double)(end - begin) / 1000000.0);
+		if (m_TraceCalibrated)
+			Trace::RecordGpu(data.scopes[i].name, (int64_t)(begin / 1000) + m_GpuToTraceUs, (int64_t)((end - begin) / 1000));
+	}
+	m_Results = data.scopes;
+	m_ResultFrame = data.frame;
+	data.pending = false;
+	return true;
+}
+
+void GpuProfiler::PushHistory()
+{
+	// Une colonne par frame relue ; les sections absentes de cette frame valent 0
+	for (size_t h = 0; h < m_History.size(); ++h)
+	{
+		m_History[h].cpuMs[m_HistoryOffset] = 0.0f;
+		m_History[h].gpuMs[m_HistoryOffset] = 0.0f;
+	}
+	for (size_t i = 0; i < m_Results.size(); ++i)
+	{
+		const ProfileScope& scope = m_Results[i];
+		ScopeHistory* history = nullptr;
+		for (size_t h = 0; h < m_History.size() && !history; ++h)
+		{
+			if (m_History[h].name == scope.name)
+				history = &m_History[h];
+		}
+		if (!history)
+		{
+			m_History.push_back(ScopeHistory());
+			history = &m_History.back();
+			history->name = scope.name;
+			for (uint32_t k = 0; k < HISTORY_SIZE; ++k)
+				history->cpuMs[k] = history->gpuMs[k] = 0.0f;
+		}
+		history->cpuMs[m_HistoryOffset] += scope.cpuMs;
+		history->gpuMs[m_HistoryOffset] += scope.gpuMs;
+	}
+	m_HistoryOffset = (m_HistoryOffset + 1) % HISTORY_SIZE;
+}
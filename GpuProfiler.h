@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Résultat d'une section mesurée. Les temps de début sont relatifs au début de la frame.
+struct ProfileScope
+{
+	const char* name;  // chaîne littérale, sert aussi d'identifiant pour l'historique
+	int depth;         // 0 : la frame entière
+	float cpuStartMs;
+	float cpuMs;
+	float gpuStartMs;
+	float gpuMs;
+};
+
+// Profileur de passes : chaque section pose deux requêtes GL_TIMESTAMP (imbrication possible,
+// contrairement à GL_TIME_ELAPSED) et mesure aussi son temps CPU. Les requêtes de FRAME_LATENCY
+// frames sont en vol en même temps ; une frame n'est relue que si ses résultats sont disponibles,
+// sinon elle est abandonnée : aucun appel ne bloque le CPU sur le GPU.
+// Pendant un enregistrement Trace, chaque section est aussi émise sur les pistes CPU et GPU.
+class GpuProfiler
+{
+public:
+	static const uint32_t FRAME_LATENCY = 3;
+	static const uint32_t HISTORY_SIZE = 120;
+
+	// Historique glissant d'une section (ms par frame, la plus ancienne à m_HistoryOffset)
+	struct ScopeHistory
+	{
+		const char* name;
+		float cpuMs[HISTORY_SIZE];
+		float gpuMs[HISTORY_SIZE];
+	};
+
+	GpuProfiler() : m_Frame(0), m_ResultFrame(0), m_HistoryOffset(0), m_DroppedFrames(0), m_Enabled(true), m_Active(false),
+		m_TraceCalibrated(false), m_GpuToTraceUs(0) {}
+
+	void Destroy();
+
+	// Ouvre la section racine "Frame" ; relit au passage les frames précédentes terminées
+	void BeginFrame();
+	void EndFrame();
+
+	void BeginScope(const char* name);
+	void EndScope();
+
+	// Pris en compte à la frame suivante
+	void SetEnabled(bool enabled) { m_Enabled = enabled; }
+	bool IsEnabled() const { return m_Enabled; }
+
+	// Dernière frame complète relue
+	const std::vector<ProfileScope>& GetScopes() const { return m_Results; }
+	// Indice de la frame relue par GetScopes, et de la frame en cours
+	uint32_t GetResultFrame() const { return m_ResultFrame; }
+	uint32_t GetFrameIndex() const { return m_Frame; }
+	const std::vector<ScopeHistory>& GetHistory() const { return m_History; }
+	uint32_t GetHistoryOffset() const { return m_HistoryOffset; }
+	uint32_t GetDroppedFrames() const { return m_DroppedFrames; }
+
+private:
+	struct FrameData
+	{
+		std::vector<uint32_t> queries;     // début / fin par section
+		std::vector<ProfileScope> scopes;
+		std::vector<double> cpuStarts;     // ms absolues, converties à la relecture
+		std::vector<int> stack;            // sections ouvertes
+		double cpuOrigin = 0.0;
+		bool pending = false;              // requêtes émises, pas encore relues
+		uint32_t frame = 0;
+	};
+
+	bool Resolve(FrameData& data);
+	void PushHistory();
+
+	FrameData m_Frames[FRAME_LATENCY];
+	std::vector<ProfileScope> m_Results;
+	std::vector<ScopeHistory> m_History;
+	uint32_t m_Frame;
+	uint32_t m_ResultFrame;
+	uint32_t m_HistoryOffset;
+	uint32_t m_DroppedFrames;
+	bool m_Enabled;
+	bool m_Active;   // m_Enabled figé pour la frame en cours
+	bool m_TraceCalibrated;
+	int64_t m_GpuToTraceUs;  // à ajouter aux timestamps GPU (en µs) pour la piste GPU des traces
+};
+
+// Section délimitée par la portée C++
+class ProfileScopeGuard
+{
+public:
+	ProfileScopeGuard(GpuProfiler& profiler, const char* name) : m_Profiler(profiler) { m_Profiler.BeginScope(name); }
+	~ProfileScopeGuard() { m_Profiler.EndScope(); }
+
+private:
+	GpuProfiler& m_Profiler;
+};
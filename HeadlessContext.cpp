@@ -0,0 +1,111 @@
+#include "HeadlessContext.h"
+
+#ifdef __linux__
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+#include <stdio.h>
+
+bool HeadlessContext::Create(int major, int minor)
+{
+	// Plateforme surfaceless si l'extension client existe, sinon l'affichage par défaut
+	EGLDisplay display = EGL_NO_DISPLAY;
+	const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+	if (clientExtensions && strstr(clientExtensions, "EGL_MESA_platform_surfaceless"))
+	{
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+			(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+		if (getPlatformDisplay)
+			display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+	}
+	if (display == EGL_NO_DISPLAY)
+		display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	EGLint eglMajor = 0, eglMinor = 0;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &eglMajor, &eglMinor))
+	{
+		fprintf(stderr, "headless: EGL indisponible\n");
+		return false;
+	}
+	m_Display = display;
+
+	if (!eglBindAPI(EGL_OPENGL_API))
+	{
+		Destroy();
+		return false;
+	}
+
+	const EGLint configAttributes[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		Destroy();
+		return false;
+	}
+
+	const EGLint contextAttributes[] = {
+		EGL_CONTEXT_MAJOR_VERSION, major,
+		EGL_CONTEXT_MINOR_VERSION, minor,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+	if (context == EGL_NO_CONTEXT)
+	{
+		Destroy();
+		return false;
+	}
+	m_Context = context;
+
+	// EGL_KHR_surfaceless_context : pas de surface du tout ; sinon un pbuffer minimal
+	const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+	EGLSurface surface = EGL_NO_SURFACE;
+	if (!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context"))
+	{
+		const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+		surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+		m_Surface = surface;
+	}
+	if (!eglMakeCurrent(display, surface, surface, context))
+	{
+		Destroy();
+		return false;
+	}
+	return true;
+}
+
+void HeadlessContext::Destroy()
+{
+	if (!m_Display)
+		return;
+	EGLDisplay display = (EGLDisplay)m_Display;
+	eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (m_Surface)
+		eglDestroySurface(display, (EGLSurface)m_Surface);
+	if (m_Context)
+		eglDestroyContext(display, (EGLContext)m_Context);
+	eglTerminate(display);
+	m_Surface = nullptr;
+	m_Context = nullptr;
+	m_Display = nullptr;
+}
+
+#else
+
+bool HeadlessContext::Create(int major, int minor)
+{
+	(void)major;
+	(void)minor;
+	return false;
+}
+
+void HeadlessContext::Destroy()
+{
+}
+
+#endif
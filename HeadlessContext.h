@@ -0,0 +1,22 @@
+#pragma once
+
+// Contexte OpenGL sans fenêtre ni serveur d'affichage, pour les benchmarks et la CI.
+// Linux : EGL sur la plateforme "surfaceless" de Mesa (llvmpipe sur une machine sans GPU,
+// ou le pilote Mesa du GPU). Le contexte n'a pas de framebuffer par défaut : tout le rendu
+// doit aller dans des FBO. Non disponible sur les autres plateformes (Create renvoie false).
+class HeadlessContext
+{
+public:
+	HeadlessContext() : m_Display(nullptr), m_Context(nullptr), m_Surface(nullptr) {}
+
+	// Contexte core profile de la version demandée, rendu courant sur ce thread
+	bool Create(int major, int minor);
+	void Destroy();
+
+	bool IsValid() const { return m_Context != nullptr; }
+
+private:
+	void* m_Display;   // EGLDisplay
+	void* m_Context;   // EGLContext
+	void* m_Surface;   // pbuffer 1x1 si le pilote refuse un contexte sans surface
+};
@@ -0,0 +1,65 @@
+#include "ImGuiSnapshot.h"
+
+#include <string.h>
+
+template <typename T>
+static void CopyVector(ImVector<T>& dst, const ImVector<T>& src)
+{
+	// resize garde la capacité : pas d'allocation une fois la taille de croisière atteinte
+	dst.resize(src.Size);
+	if (src.Size > 0)
+		memcpy(dst.Data, src.Data, (size_t)src.Size * sizeof(T));
+}
+
+ImGuiSnapshot::~ImGuiSnapshot()
+{
+	Release();
+}
+
+void ImGuiSnapshot::Release()
+{
+	m_DrawData.Clear();
+	for (size_t i = 0; i < m_Lists.size(); ++i)
+		IM_DELETE(m_Lists[i]);
+	m_Lists.clear();
+}
+
+bool ImGuiSnapshot::Capture(const ImDrawData* drawData)
+{
+	m_DrawData.Clear();
+	if (!drawData || !drawData->Valid)
+		return false;
+
+	while ((int)m_Lists.size() < drawData->CmdListsCount)
+		m_Lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+	for (int i = 0; i < drawData->CmdListsCount; ++i)
+	{
+		const ImDrawList* source = drawData->CmdLists[i];
+		ImDrawList* copy = m_Lists[i];
+		CopyVector(copy->CmdBuffer, source->CmdBuffer);
+		CopyVector(copy->IdxBuffer, source->IdxBuffer);
+		CopyVector(copy->VtxBuffer, source->VtxBuffer);
+		copy->Flags = source->Flags;
+		m_DrawData.CmdLists.push_back(copy);
+	}
+	m_DrawData.Valid = true;
+	m_DrawData.CmdListsCount = drawData->CmdListsCount;
+	m_DrawData.TotalIdxCount = drawData->TotalIdxCount;
+	m_DrawData.TotalVtxCount = drawData->TotalVtxCount;
+	m_DrawData.DisplayPos = drawData->DisplayPos;
+	m_DrawData.DisplaySize = drawData->DisplaySize;
+	m_DrawData.FramebufferScale = drawData->FramebufferScale;
+
+	bool texturesPending = false;
+	if (drawData->Textures)
+	{
+		for (int i = 0; i < drawData->Textures->Size; ++i)
+		{
+			ImTextureStatus status = (*drawData->Textures)[i]->Status;
+			if (status != ImTextureStatus_OK && status != ImTextureStatus_Destroyed)
+				texturesPending = true;
+		}
+	}
+	m_DrawData.Textures = texturesPending ? drawData->Textures : nullptr;
+	return texturesPending;
+}
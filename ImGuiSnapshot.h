@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include "imgui.h"
+
+// Copie des listes de dessin d'une frame ImGui, pour un rendu par un autre thread : ImGui
+// réutilise ses ImDrawList dès le NewFrame suivant, l'ImDrawData de ImGui::Render() ne peut
+// donc pas être gardé tel quel. Les listes de la copie sont conservées d'une frame à l'autre
+// pour réutiliser leurs tableaux.
+// Les textures (atlas de police dynamique) restent partagées avec le contexte ImGui : la liste
+// des textures n'est transmise que si l'une d'elles attend le backend, et le thread principal
+// doit alors attendre le rendu de cette copie avant le NewFrame suivant.
+class ImGuiSnapshot
+{
+public:
+	ImGuiSnapshot() {}
+	~ImGuiSnapshot();
+
+	// Après ImGui::Render() ; renvoie true si des textures doivent être créées ou mises à jour
+	bool Capture(const ImDrawData* drawData);
+
+	ImDrawData* GetDrawData() { return &m_DrawData; }
+
+	// Libère les listes ; à appeler avant ImGui::DestroyContext() (elles référencent ses données partagées)
+	void Release();
+
+private:
+	ImDrawData m_DrawData;
+	std::vector<ImDrawList*> m_Lists;
+};
@@ -0,0 +1,329 @@
+#include "JobSystem.h"
+#include "WorkStealingDeque.h"
+#include "Trace.h"
+
+#include <stdio.h>
+
+namespace
+{
+	struct Worker
+	{
+		WorkStealingDeque<JobSystem::Job*, JobSystem::MAX_JOBS_PER_THREAD> deque;
+		JobSystem::Job* jobs = nullptr;   // pool circulaire, écrit par ce thread seulement
+		uint32_t allocated = 0;
+		uint32_t random = 0;              // choix des victimes de vol
+		std::atomic<uint32_t> executed;
+		std::atomic<uint32_t> stolen;
+	};
+
+	// Stockage statique : les deques alignées sur les lignes de cache ne passent pas par new
+	Worker s_Workers[JobSystem::MAX_THREADS];
+	JobSystem* s_Active = nullptr;
+	thread_local int t_WorkerIndex = -1;
+
+	uint32_t NextRandom(uint32_t& state)
+	{
+		// xorshift32
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return state;
+	}
+}
+
+bool JobSystem::Create(uint32_t threadCount)
+{
+	if (s_Active)
+		return false;
+	if (threadCount == 0)
+		threadCount = std::thread::hardware_concurrency();
+	if (threadCount == 0)
+		threadCount = 1;
+	if (threadCount > MAX_THREADS)
+		threadCount = MAX_THREADS;
+
+	s_Active = this;
+	m_ThreadCount = threadCount;
+	m_Running.store(true);
+	m_Queued.store(0);
+	m_Sleeping.store(0);
+	for (uint32_t i = 0; i < threadCount; ++i)
+	{
+		Worker& worker = s_Workers[i];
+		worker.jobs = new Job[MAX_JOBS_PER_THREAD];
+		for (uint32_t j = 0; j < MAX_JOBS_PER_THREAD; ++j)
+			worker.jobs[j].unfinished.store(0);
+		worker.allocated = 0;
+		worker.random = 0x9E3779B9u * (i + 1);
+		worker.executed.store(0);
+		worker.stolen.store(0);
+	}
+
+	t_WorkerIndex = 0;
+	for (uint32_t i = 1; i < threadCount; ++i)
+		m_Threads.push_back(std::thread(&JobSystem::WorkerMain, this, i));
+	return true;
+}
+
+void JobSystem::Destroy()
+{
+	if (s_Active != this)
+		return;
+	m_Running.store(false);
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_WakeCondition.notify_all();
+	}
+	for (size_t i = 0; i < m_Threads.size(); ++i)
+		m_Threads[i].join();
+	m_Threads.clear();
+
+	for (uint32_t i = 0; i < m_ThreadCount; ++i)
+	{
+		// Tâches soumises mais jamais attendues : abandonnées
+		Job* job;
+		while (s_Workers[i].deque.Steal(job)) {}
+		delete[] s_Workers[i].jobs;
+		s_Workers[i].jobs = nullptr;
+	}
+	t_WorkerIndex = -1;
+	m_ThreadCount = 0;
+	s_Active = nullptr;
+}
+
+void JobSystem::WorkerMain(uint32_t index)
+{
+	t_WorkerIndex = (int)index;
+	char name[32];
+	snprintf(name, sizeof(name), "Tâches %u", index);
+	Trace::SetThreadName(name);
+
+	uint32_t idle = 0;
+	while (m_Running.load(std::memory_order_acquire))
+	{
+		Job* job = FindJob();
+		if (job)
+		{
+			Execute(job);
+			idle = 0;
+			continue;
+		}
+		// Quelques tours actifs (une tâche arrive souvent juste après), puis sommeil
+		if (++idle < 64)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_SleepMutex);
+		m_Sleeping.fetch_add(1);
+		while (m_Queued.load() == 0 && m_Running.load())
+			m_WakeCondition.wait(lock);
+		m_Sleeping.fetch_sub(1);
+		idle = 0;
+	}
+}
+
+JobSystem::Job* JobSystem::AllocateJob(JobFunction function, void* data)
+{
+	if (t_WorkerIndex < 0)
+		return nullptr;
+	// Une tâche encore en cours (parent d'un ParallelFor, tâche attendue) garde sa place : on
+	// passe à la suivante. Pool entièrement occupé : nullptr, l'appelant exécute sur place.
+	Worker& worker = s_Workers[t_WorkerIndex];
+	Job* job = nullptr;
+	for (uint32_t attempt = 0; attempt < MAX_JOBS_PER_THREAD && !job; ++attempt)
+	{
+		Job* candidate = &worker.jobs[worker.allocated++ & (MAX_JOBS_PER_THREAD - 1)];
+		if (candidate->unfinished.load(std::memory_order_acquire) == 0)
+			job = candidate;
+	}
+	if (!job)
+		return nullptr;
+	job->function = function;
+	job->data = data;
+	job->begin = 0;
+	job->end = 0;
+	job->grainSize = 0;
+	job->parent = nullptr;
+	job->unfinished.store(1, std::memory_order_relaxed);
+	job->dependencies.store(1, std::memory_order_relaxed);
+	job->continuationCount = 0;
+	return job;
+}
+
+JobSystem::Job* JobSystem::CreateJob(JobFunction function, void* data)
+{
+	return AllocateJob(function, data);
+}
+
+JobSystem::Job* JobSystem::CreateChildJob(Job* parent, JobFunction function, void* data)
+{
+	Job* job = AllocateJob(function, data);
+	if (job && parent)
+	{
+		parent->unfinished.fetch_add(1, std::memory_order_relaxed);
+		job->parent = parent;
+	}
+	return job;
+}
+
+JobSystem::Job* JobSystem::CreateParallelFor(uint32_t count, uint32_t grainSize, JobFunction function, void* data)
+{
+	Job* job = AllocateJob(function, data);
+	if (job)
+	{
+		job->begin = 0;
+		job->end = count;
+		job->grainSize = grainSize > 0 ? grainSize : 1;
+	}
+	return job;
+}
+
+bool JobSystem::AddDependency(Job* job, Job* prerequisite)
+{
+	if (prerequisite->continuationCount >= MAX_CONTINUATIONS)
+		return false;
+	prerequisite->continuations[prerequisite->continuationCount++] = job;
+	job->dependencies.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void JobSystem::Submit(Job* job)
+{
+	if (job->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		Push(job);
+}
+
+void JobSystem::Wait(const Job* job)
+{
+	while (!IsFinished(job))
+	{
+		Job* next = t_WorkerIndex >= 0 ? FindJob() : nullptr;
+		if (next)
+			Execute(next);
+		else
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t grainSize, JobFunction function, void* data)
+{
+	if (count == 0)
+		return;
+	Job* job = CreateParallelFor(count, grainSize, function, data);
+	if (!job)
+	{
+		// Thread hors du JobSystem (ou JobSystem non créé) : boucle sur place
+		function(data, 0, count);
+		return;
+	}
+	Submit(job);
+	Wait(job);
+}
+
+JobSystem::Stats JobSystem::GetStats() const
+{
+	Stats stats;
+	for (uint32_t i = 0; i < m_ThreadCount; ++i)
+	{
+		stats.executed += s_Workers[i].executed.load(std::memory_order_relaxed);
+		stats.stolen += s_Workers[i].stolen.load(std::memory_order_relaxed);
+	}
+	return stats;
+}
+
+bool JobSystem::IsWorkerThread()
+{
+	return t_WorkerIndex >= 0;
+}
+
+void JobSystem::Push(Job* job)
+{
+	Worker& worker = s_Workers[t_WorkerIndex];
+	if (!worker.deque.Push(job))
+	{
+		// Deque pleine : exécution immédiate plutôt que d'attendre de la place
+		Execute(job);
+		return;
+	}
+	m_Queued.fetch_add(1);
+	if (m_Sleeping.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_SleepMutex);
+		m_WakeCondition.notify_one();
+	}
+}
+
+JobSystem::Job* JobSystem::FindJob()
+{
+	uint32_t index = (uint32_t)t_WorkerIndex;
+	Worker& worker = s_Workers[index];
+	Job* job;
+	if (worker.deque.Pop(job))
+	{
+		m_Queued.fetch_sub(1);
+		return job;
+	}
+	if (m_ThreadCount < 2)
+		return nullptr;
+	uint32_t start = NextRandom(worker.random) % m_ThreadCount;
+	for (uint32_t i = 0; i < m_ThreadCount; ++i)
+	{
+		uint32_t victim = (start + i) % m_ThreadCount;
+		if (victim != index && s_Workers[victim].deque.Steal(job))
+		{
+			m_Queued.fetch_sub(1);
+			worker.stolen.fetch_add(1, std::memory_order_relaxed);
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+void JobSystem::Execute(Job* job)
+{
+	if (job->grainSize > 0)
+	{
+		// La moitié droite part dans la deque (et peut être volée), on continue sur la gauche
+		uint32_t begin = job->begin;
+		uint32_t end = job->end;
+		while (end - begin > job->grainSize)
+		{
+			uint32_t middle = begin + (end - begin) / 2;
+			Job* right = CreateChildJob(job, job->function, job->data);
+			if (!right)
+				break;
+			right->begin = middle;
+			right->end = end;
+			right->grainSize = job->grainSize;
+			Submit(right);
+			end = middle;
+		}
+		job->function(job->data, begin, end);
+	}
+	else
+	{
+		job->function(job->data, job->begin, job->end);
+	}
+	s_Workers[t_WorkerIndex].executed.fetch_add(1, std::memory_order_relaxed);
+	Finish(job);
+}
+
+void JobSystem::Finish(Job* job)
+{
+	// Liens copiés avant la décrémentation : une fois à zéro, la place peut être réutilisée
+	Job* parent = job->parent;
+	uint32_t continuationCount = job->continuationCount;
+	Job* continuations[MAX_CONTINUATIONS];
+	for (uint32_t i = 0; i < continuationCount; ++i)
+		continuations[i] = job->continuations[i];
+	if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+	for (uint32_t i = 0; i < continuationCount; ++i)
+	{
+		if (continuations[i]->dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Push(continuations[i]);
+	}
+	if (parent)
+		Finish(parent);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Ordonnanceur de tâches par vol de travail : un thread de travail par cœur, plus le thread qui
+// appelle Create (indice 0), qui exécute aussi des tâches pendant Wait. Chaque thread a sa deque
+// de Chase-Lev (WorkStealingDeque) : il y empile les tâches qu'il crée et les reprend en LIFO ;
+// un thread sans travail vole la plus ancienne tâche d'un autre thread pris au hasard.
+// Les tâches sont prises dans un pool circulaire par thread, sans allocation ; les places des
+// tâches non terminées sont sautées. Pool plein : Create* renvoie nullptr et ParallelFor
+// exécute la plage sur place. Un Job* n'est plus valide une fois la tâche terminée et attendue.
+// Seuls les threads du JobSystem créent et soumettent des tâches ; depuis un autre thread (rendu),
+// ParallelFor exécute la boucle sur place. Une seule instance active à la fois.
+class JobSystem
+{
+public:
+	// Corps d'une tâche : la plage [begin, end) n'a de sens que pour les ParallelFor
+	typedef void (*JobFunction)(void* data, uint32_t begin, uint32_t end);
+
+	static const uint32_t MAX_THREADS = 32;
+	static const uint32_t MAX_JOBS_PER_THREAD = 4096;
+	static const uint32_t MAX_CONTINUATIONS = 8;
+
+	struct Job
+	{
+		JobFunction function;
+		void* data;
+		uint32_t begin;
+		uint32_t end;
+		uint32_t grainSize;                  // > 0 : ParallelFor, la plage est découpée à l'exécution
+		Job* parent;
+		std::atomic<int32_t> unfinished;     // la tâche elle-même + ses enfants non terminés
+		std::atomic<int32_t> dependencies;   // prérequis non terminés + 1 jusqu'au Submit
+		uint32_t continuationCount;
+		Job* continuations[MAX_CONTINUATIONS]; // tâches qui dépendent de celle-ci
+	};
+
+	struct Stats
+	{
+		uint32_t executed = 0;
+		uint32_t stolen = 0;
+	};
+
+	JobSystem() : m_ThreadCount(0), m_Running(false), m_Queued(0), m_Sleeping(0) {}
+	~JobSystem() { Destroy(); }
+
+	// threadCount : threads au total, appelant compris ; 0 : un par cœur
+	bool Create(uint32_t threadCount = 0);
+	void Destroy();
+	uint32_t GetThreadCount() const { return m_ThreadCount; }
+	// Thread appelant de Create ou thread de travail : seuls à pouvoir créer des tâches
+	static bool IsWorkerThread();
+
+	// nullptr hors d'un thread du JobSystem ou si le pool du thread est plein
+	Job* CreateJob(JobFunction function, void* data);
+	// Le parent n'est terminé qu'avec tous ses enfants ; à créer avant la fin du parent
+	Job* CreateChildJob(Job* parent, JobFunction function, void* data);
+	// Découpe [0, count) en plages d'au plus grainSize, par dichotomie au fil de l'exécution
+	Job* CreateParallelFor(uint32_t count, uint32_t grainSize, JobFunction function, void* data);
+	// "job" ne démarre qu'après "prerequisite" ; les deux ne doivent pas encore être soumis
+	bool AddDependency(Job* job, Job* prerequisite);
+
+	// La tâche part dès que ses prérequis sont terminés
+	void Submit(Job* job);
+	// Exécute d'autres tâches en attendant la fin de "job"
+	void Wait(const Job* job);
+	static bool IsFinished(const Job* job) { return job->unfinished.load(std::memory_order_acquire) == 0; }
+
+	// Raccourci bloquant : CreateParallelFor + Submit + Wait
+	void ParallelFor(uint32_t count, uint32_t grainSize, JobFunction function, void* data);
+
+	// Cumul depuis Create, tous threads confondus
+	Stats GetStats() const;
+
+private:
+	void WorkerMain(uint32_t index);
+	Job* AllocateJob(JobFunction function, void* data);
+	void Push(Job* job);
+	Job* FindJob();
+	void Execute(Job* job);
+	void Finish(Job* job);
+
+	uint32_t m_ThreadCount;
+	std::vector<std::thread> m_Threads;
+	std::atomic<bool> m_Running;
+	// Tâches en deque, pour réveiller les threads endormis
+	std::atomic<int32_t> m_Queued;
+	std::atomic<int32_t> m_Sleeping;
+	std::mutex m_SleepMutex;
+	std::condition_variable m_WakeCondition;
+};
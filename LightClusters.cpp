@@ -0,0 +1,293 @@
+#include "LightClusters.h"
+#include "GLPlatform.h"
+#include "JobSystem.h"
+
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+	// Fin de la première tranche : près de la caméra, les tranches géométriques seraient très fines
+	const float FIRST_SLICE_DEPTH = 1.0f;
+	const int TILE_COUNT = LightClusters::TILES_X * LightClusters::TILES_Y;
+	// Indice de lumière sur 16 bits dans les paires tuile/lumière
+	const uint32_t MAX_LIGHTS = 65536;
+
+	// Tuiles couvertes par l'intervalle [low, high] (espace vue, x ou y) d'un objet situé entre les
+	// profondeurs dMin et dMax : projection conservative, la plus large des deux profondeurs
+	void TileRange(float low, float high, float dMin, float dMax, float scale, int tiles, int& first, int& last)
+	{
+		float ndcLow = scale * low / (low < 0.0f ? dMin : dMax);
+		float ndcHigh = scale * high / (high > 0.0f ? dMin : dMax);
+		first = (int)std::floor((ndcLow * 0.5f + 0.5f) * tiles);
+		last = (int)std::floor((ndcHigh * 0.5f + 0.5f) * tiles);
+		if (first < 0) first = 0;
+		if (first > tiles - 1) first = tiles - 1;
+		if (last < 0) last = 0;
+		if (last > tiles - 1) last = tiles - 1;
+	}
+
+	bool SphereIntersectsBox(const float* sphere, const float* box)
+	{
+		float distance2 = 0.0f;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			float v = sphere[axis];
+			if (v < box[axis])
+				distance2 += (box[axis] - v) * (box[axis] - v);
+			else if (v > box[3 + axis])
+				distance2 += (v - box[3 + axis]) * (v - box[3 + axis]);
+		}
+		return distance2 <= sphere[3] * sphere[3];
+	}
+}
+
+LightClusters::LightClusters()
+	: m_NearZ(0.01f), m_FarZ(100.0f)
+{
+	for (int i = 0; i < 4; ++i)
+		m_BoundsKey[i] = 0.0f;
+	m_ProjectionScale[0] = m_ProjectionScale[1] = 1.0f;
+	for (int i = 0; i < 3; ++i)
+	{
+		m_Buffers[i] = 0;
+		m_Textures[i] = 0;
+	}
+}
+
+bool LightClusters::Create()
+{
+	const GLenum formats[3] = { GL_RGBA32F, GL_RG32UI, GL_R32UI };
+	glGenBuffers(3, m_Buffers);
+	glGenTextures(3, m_Textures);
+	for (int i = 0; i < 3; ++i)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, m_Buffers[i]);
+		glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, m_Textures[i]);
+		glTexBuffer(GL_TEXTURE_BUFFER, formats[i], m_Buffers[i]);
+	}
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	return true;
+}
+
+void LightClusters::Destroy()
+{
+	glDeleteTextures(3, m_Textures);
+	glDeleteBuffers(3, m_Buffers);
+	for (int i = 0; i < 3; ++i)
+	{
+		m_Buffers[i] = 0;
+		m_Textures[i] = 0;
+	}
+}
+
+float LightClusters::SliceDepth(int slice) const
+{
+	if (slice == 0)
+		return m_NearZ;
+	return FIRST_SLICE_DEPTH * std::pow(m_FarZ / FIRST_SLICE_DEPTH, (float)(slice - 1) / (SLICES - 1));
+}
+
+void LightClusters::UpdateBounds(const mat4& projection, float nearZ, float farZ)
+{
+	// Plans de la frame : ils sont aussi échangés avec les données (SwapData)
+	m_NearZ = nearZ;
+	m_FarZ = farZ;
+	const float key[4] = { projection.m[0], projection.m[5], nearZ, farZ };
+	if (!m_Bounds.empty() && key[0] == m_BoundsKey[0] && key[1] == m_BoundsKey[1] &&
+		key[2] == m_BoundsKey[2] && key[3] == m_BoundsKey[3])
+		return;
+	for (int i = 0; i < 4; ++i)
+		m_BoundsKey[i] = key[i];
+	m_ProjectionScale[0] = projection.m[0];
+	m_ProjectionScale[1] = projection.m[5];
+
+	// Espace vue : x = ndc * profondeur / échelle ; la tuile s'élargit avec la profondeur
+	m_Bounds.resize(CLUSTER_COUNT * 6);
+	for (int slice = 0; slice < SLICES; ++slice)
+	{
+		float dNear = SliceDepth(slice);
+		float dFar = SliceDepth(slice + 1);
+		for (int ty = 0; ty < TILES_Y; ++ty)
+		{
+			for (int tx = 0; tx < TILES_X; ++tx)
+			{
+				float ndc[4] = {
+					-1.0f + 2.0f * tx / TILES_X, -1.0f + 2.0f * (tx + 1) / TILES_X,
+					-1.0f + 2.0f * ty / TILES_Y, -1.0f + 2.0f * (ty + 1) / TILES_Y
+				};
+				float* box = &m_Bounds[((slice * TILES_Y + ty) * TILES_X + tx) * 6];
+				box[0] = std::fmin(ndc[0] * dNear, ndc[0] * dFar) / m_ProjectionScale[0];
+				box[3] = std::fmax(ndc[1] * dNear, ndc[1] * dFar) / m_ProjectionScale[0];
+				box[1] = std::fmin(ndc[2] * dNear, ndc[2] * dFar) / m_ProjectionScale[1];
+				box[4] = std::fmax(ndc[3] * dNear, ndc[3] * dFar) / m_ProjectionScale[1];
+				box[2] = -dFar;
+				box[5] = -dNear;
+			}
+		}
+	}
+}
+
+void LightClusters::AssignSlices(void* data, uint32_t begin, uint32_t end)
+{
+	LightClusters& self = *(LightClusters*)data;
+	const uint32_t lightCount = (uint32_t)self.m_Lights.size();
+	for (uint32_t s = begin; s < end; ++s)
+	{
+		Slice& slice = self.m_Slices[s];
+		slice.counts.assign(TILE_COUNT, 0);
+		slice.pairs.clear();
+		float sliceNear = self.SliceDepth(s);
+		float sliceFar = self.SliceDepth(s + 1);
+		const float* sliceBounds = &self.m_Bounds[s * TILE_COUNT * 6];
+
+		for (uint32_t i = 0; i < lightCount; ++i)
+		{
+			const float* light = &self.m_ViewLights[i * 4];
+			float depth = -light[2];
+			float radius = light[3];
+			if (depth + radius < sliceNear || depth - radius > sliceFar)
+				continue;
+
+			// Rectangle de tuiles sur la partie de la tranche couverte par la sphère, puis test exact
+			// de la sphère contre la boîte de chaque cluster
+			float dMin = depth - radius > sliceNear ? depth - radius : sliceNear;
+			float dMax = depth + radius < sliceFar ? depth + radius : sliceFar;
+			int x0, x1, y0, y1;
+			TileRange(light[0] - radius, light[0] + radius, dMin, dMax, self.m_ProjectionScale[0], TILES_X, x0, x1);
+			TileRange(light[1] - radius, light[1] + radius, dMin, dMax, self.m_ProjectionScale[1], TILES_Y, y0, y1);
+			for (int ty = y0; ty <= y1; ++ty)
+			{
+				for (int tx = x0; tx <= x1; ++tx)
+				{
+					uint32_t tile = ty * TILES_X + tx;
+					if (!SphereIntersectsBox(light, &sliceBounds[tile * 6]))
+						continue;
+					slice.pairs.push_back(tile << 16 | i);
+					slice.counts[tile]++;
+				}
+			}
+		}
+
+		// Tri par comptage : les lumières de chaque tuile deviennent contiguës
+		uint32_t offsets[TILE_COUNT];
+		uint32_t offset = 0;
+		for (int t = 0; t < TILE_COUNT; ++t)
+		{
+			offsets[t] = offset;
+			offset += slice.counts[t];
+		}
+		slice.lights.resize(slice.pairs.size());
+		for (size_t p = 0; p < slice.pairs.size(); ++p)
+			slice.lights[offsets[slice.pairs[p] >> 16]++] = slice.pairs[p] & 0xFFFF;
+	}
+}
+
+void LightClusters::Build(JobSystem& jobs, const std::vector<PointLight>& lights, const mat4& view,
+	const mat4& projection, float nearZ, float farZ)
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	m_Lights.assign(lights.begin(), lights.size() > MAX_LIGHTS ? lights.begin() + MAX_LIGHTS : lights.end());
+	UpdateBounds(projection, nearZ, farZ);
+
+	const float* v = view.m;
+	m_ViewLights.resize(m_Lights.size() * 4);
+	for (size_t i = 0; i < m_Lights.size(); ++i)
+	{
+		const float* p = m_Lights[i].position;
+		m_ViewLights[i * 4 + 0] = v[0] * p[0] + v[4] * p[1] + v[8] * p[2] + v[12];
+		m_ViewLights[i * 4 + 1] = v[1] * p[0] + v[5] * p[1] + v[9] * p[2] + v[13];
+		m_ViewLights[i * 4 + 2] = v[2] * p[0] + v[6] * p[1] + v[10] * p[2] + v[14];
+		m_ViewLights[i * 4 + 3] = m_Lights[i].radius;
+	}
+
+	m_Slices.resize(SLICES);
+	jobs.ParallelFor(SLICES, 1, AssignSlices, this);
+
+	// Listes des tranches bout à bout ; au-delà de la taille maximale d'un texture buffer, les
+	// derniers clusters perdent des lumières
+	const uint32_t maxIndices = (uint32_t)GetGLCaps().maxTextureBufferSize;
+	m_Ranges.resize(CLUSTER_COUNT * 2);
+	m_Indices.clear();
+	m_Stats = Stats();
+	for (int s = 0; s < SLICES; ++s)
+	{
+		const Slice& slice = m_Slices[s];
+		uint32_t sliceOffset = 0;
+		for (int t = 0; t < TILE_COUNT; ++t)
+		{
+			uint32_t count = slice.counts[t];
+			uint32_t first = (uint32_t)m_Indices.size();
+			uint32_t kept = first + count > maxIndices ? maxIndices - first : count;
+			m_Indices.insert(m_Indices.end(), slice.lights.begin() + sliceOffset, slice.lights.begin() + sliceOffset + kept);
+			sliceOffset += count;
+
+			uint32_t cluster = s * TILE_COUNT + t;
+			m_Ranges[cluster * 2] = first;
+			m_Ranges[cluster * 2 + 1] = kept;
+			m_Stats.droppedIndices += count - kept;
+			if (count > 0)
+				m_Stats.occupiedClusters++;
+			if (count > m_Stats.maxPerCluster)
+				m_Stats.maxPerCluster = count;
+		}
+	}
+	m_Stats.lights = (uint32_t)m_Lights.size();
+	m_Stats.indices = (uint32_t)m_Indices.size();
+	m_Stats.buildMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void LightClusters::SwapData(LightClusters& other)
+{
+	m_Lights.swap(other.m_Lights);
+	m_Ranges.swap(other.m_Ranges);
+	m_Indices.swap(other.m_Indices);
+	std::swap(m_NearZ, other.m_NearZ);
+	std::swap(m_FarZ, other.m_FarZ);
+	std::swap(m_Stats, other.m_Stats);
+}
+
+void LightClusters::Upload()
+{
+	// Réallocation à chaque frame (orphaning), comme les commandes de MultiDrawBatch
+	const void* data[3] = { m_Lights.data(), m_Ranges.data(), m_Indices.data() };
+	const size_t sizes[3] = {
+		m_Lights.size() * sizeof(PointLight), m_Ranges.size() * sizeof(uint32_t), m_Indices.size() * sizeof(uint32_t)
+	};
+	for (int i = 0; i < 3; ++i)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, m_Buffers[i]);
+		glBufferData(GL_TEXTURE_BUFFER, sizes[i] > 0 ? sizes[i] : 16, sizes[i] > 0 ? data[i] : nullptr, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::BindTextures() const
+{
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		glActiveTexture(GL_TEXTURE0 + FIRST_TEXTURE_UNIT + i);
+		glBindTexture(GL_TEXTURE_BUFFER, m_Textures[i]);
+	}
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void LightClusters::SetUniforms(uint32_t program, int renderWidth, int renderHeight, bool clustered) const
+{
+	// Programme sans éclairage dynamique
+	GLint location = glGetUniformLocation(program, "u_lights");
+	if (location < 0)
+		return;
+	glUniform1i(location, FIRST_TEXTURE_UNIT);
+	glUniform1i(glGetUniformLocation(program, "u_clusters"), FIRST_TEXTURE_UNIT + 1);
+	glUniform1i(glGetUniformLocation(program, "u_lightIndices"), FIRST_TEXTURE_UNIT + 2);
+	glUniform1i(glGetUniformLocation(program, "u_lightCount"), (GLint)m_Lights.size());
+	glUniform1i(glGetUniformLocation(program, "u_clusteredLights"), clustered ? 1 : 0);
+	glUniform3i(glGetUniformLocation(program, "u_clusterGrid"), TILES_X, TILES_Y, SLICES);
+	glUniform2f(glGetUniformLocation(program, "u_clusterTileScale"), (float)TILES_X / renderWidth, (float)TILES_Y / renderHeight);
+	glUniform2f(glGetUniformLocation(program, "u_clusterDepth"), FIRST_SLICE_DEPTH,
+		(SLICES - 1) / std::log(m_FarZ / FIRST_SLICE_DEPTH));
+}
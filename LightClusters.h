@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "mat4.h"
+
+class JobSystem;
+
+// Lumière ponctuelle : position monde et rayon d'influence, couleur (intensité comprise).
+// Deux texels RGBA32F dans le texture buffer des lumières.
+struct PointLight
+{
+	float position[3];
+	float radius;
+	float color[3];
+	float padding;
+};
+
+// Éclairage "clustered forward" : le frustum de vue est découpé en TILES_X x TILES_Y tuiles
+// écran et SLICES tranches de profondeur (la première jusqu'à une unité de la caméra, les
+// suivantes en progression géométrique jusqu'au plan lointain). Chaque frame, sur le thread
+// principal, une tâche du JobSystem par tranche range les lumières dont la sphère touche la boîte
+// englobante (espace vue) de chaque cluster. Les shaders éclairés retrouvent le cluster du fragment
+// (gl_FragCoord et profondeur en vue) et ne parcourent que ses lumières : le coût suit le nombre
+// de lumières par pixel et non le nombre total.
+// Données GPU en texture buffers, lisibles en GLSL 3.30 :
+// - lumières : RGBA32F, deux texels par lumière ;
+// - clusters : RG32UI, (premier indice, nombre de lumières) par cluster ;
+// - indices : R32UI, listes des clusters mises bout à bout.
+// Comme MultiDrawBatch, une instance sans objets GL est remplie par le thread principal (Build),
+// puis ses données sont échangées avec celle du thread de rendu, qui les envoie (Upload).
+class LightClusters
+{
+public:
+	static const int TILES_X = 16;
+	static const int TILES_Y = 9;
+	static const int SLICES = 24;
+	static const int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+	// Unités des trois texture buffers, après les matériaux (1) et la cubemap (3)
+	static const uint32_t FIRST_TEXTURE_UNIT = 5;
+
+	struct Stats
+	{
+		uint32_t lights = 0;
+		uint32_t indices = 0;          // paires cluster -> lumière
+		uint32_t maxPerCluster = 0;
+		uint32_t occupiedClusters = 0; // clusters touchés par au moins une lumière
+		uint32_t droppedIndices = 0;   // au-delà de GL_MAX_TEXTURE_BUFFER_SIZE
+		float buildMs = 0.0f;
+	};
+
+	LightClusters();
+
+	// Thread du contexte GL : buffers et textures (vides jusqu'au premier Upload)
+	bool Create();
+	void Destroy();
+
+	// Projection perspective symétrique de plans nearZ et farZ ; hors d'un thread du JobSystem,
+	// les tranches sont traitées sur place
+	void Build(JobSystem& jobs, const std::vector<PointLight>& lights, const mat4& view, const mat4& projection,
+		float nearZ, float farZ);
+	// Échange les données construites (sans copie) avec un autre jeu de clusters
+	void SwapData(LightClusters& other);
+
+	// Thread du contexte GL : envoi des trois buffers, puis liaison aux unités FIRST_TEXTURE_UNIT..+2
+	void Upload();
+	void BindTextures() const;
+	// Uniforms u_lights, u_cluster* et u_lightCount du programme lié ; "clustered" = false fait
+	// parcourir toutes les lumières à chaque fragment (comparaison)
+	void SetUniforms(uint32_t program, int renderWidth, int renderHeight, bool clustered) const;
+
+	const Stats& GetStats() const { return m_Stats; }
+
+private:
+	// Listes d'une tranche, triées par tuile
+	struct Slice
+	{
+		std::vector<uint32_t> counts;  // TILES_X * TILES_Y
+		std::vector<uint32_t> pairs;   // tuile << 16 | lumière, avant tri
+		std::vector<uint32_t> lights;  // indices de lumières, par tuile
+	};
+
+	static void AssignSlices(void* data, uint32_t begin, uint32_t end);
+	float SliceDepth(int slice) const;
+	void UpdateBounds(const mat4& projection, float nearZ, float farZ);
+
+	// Données de frame (échangées par SwapData)
+	std::vector<PointLight> m_Lights;
+	std::vector<uint32_t> m_Ranges;        // 2 par cluster
+	std::vector<uint32_t> m_Indices;
+	float m_NearZ, m_FarZ;
+	Stats m_Stats;
+
+	// Construction : lumières en espace vue et boîtes des clusters (recalculées si la projection change)
+	std::vector<float> m_ViewLights;       // x, y, z, rayon
+	std::vector<float> m_Bounds;           // min xyz, max xyz par cluster
+	float m_BoundsKey[4];
+	float m_ProjectionScale[2];            // projection.m[0], projection.m[5]
+	std::vector<Slice> m_Slices;
+
+	uint32_t m_Buffers[3];
+	uint32_t m_Textures[3];
+};
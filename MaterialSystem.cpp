@@ -0,0 +1,290 @@
+#include "MaterialSystem.h"
+#include "GLPlatform.h"
+
+#include <cstring>
+#include "tiny_obj_loader.h"
+
+MaterialParams MaterialSystem::MakeParams(float r, float g, float b, float shininess)
+{
+	MaterialParams params;
+	params.diffuse[0] = r; params.diffuse[1] = g; params.diffuse[2] = b; params.diffuse[3] = 1.0f;
+	params.specular[0] = params.specular[1] = params.specular[2] = 1.0f;
+	params.specular[3] = shininess;
+	params.ambient[0] = params.ambient[1] = params.ambient[2] = 1.0f;
+	params.ambient[3] = 0.0f;
+	for (int i = 0; i < 4; ++i)
+		params.maps[i] = -1;
+	return params;
+}
+
+bool MaterialSystem::Create(uint32_t binding, uint32_t handleBinding, TextureLoader loader)
+{
+	m_Loader = loader;
+	glGenBuffers(1, &m_Buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+	glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * sizeof(MaterialParams), nullptr, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_Buffer);
+
+	// uvec4 par matériau : handle de la carte diffuse en xy
+	glGenBuffers(1, &m_HandleBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_HandleBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * 4 * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, handleBinding, m_HandleBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	return m_Buffer != 0;
+}
+
+void MaterialSystem::Destroy()
+{
+#ifdef GL_ARB_bindless_texture
+	// Un handle résident doit être libéré avant la suppression de sa texture
+	for (size_t i = 0; i < m_Handles.size(); ++i)
+	{
+		if (m_Handles[i])
+			glMakeTextureHandleNonResidentARB(m_Handles[i]);
+	}
+#endif
+	m_Handles.clear();
+	m_Layers.clear();
+	m_Bindless = false;
+	glDeleteTextures(1, &m_TextureArray);
+	m_TextureArray = 0;
+	if (!m_Textures.empty())
+		glDeleteTextures((GLsizei)m_Textures.size(), m_Textures.data());
+	m_Textures.clear();
+	m_TextureIndices.clear();
+	m_Materials.clear();
+	glDeleteBuffers(1, &m_Buffer);
+	glDeleteBuffers(1, &m_HandleBuffer);
+	m_Buffer = m_HandleBuffer = 0;
+	m_DirtyBegin = m_DirtyEnd = 0;
+}
+
+void MaterialSystem::MarkDirty(uint16_t id)
+{
+	if (m_DirtyBegin == m_DirtyEnd)
+	{
+		m_DirtyBegin = id;
+		m_DirtyEnd = id + 1;
+		return;
+	}
+	if (id < m_DirtyBegin)
+		m_DirtyBegin = id;
+	if (id + 1u > m_DirtyEnd)
+		m_DirtyEnd = id + 1;
+}
+
+uint16_t MaterialSystem::Add(const std::string& name, const MaterialParams& params)
+{
+	// Table pleine : on retombe sur le premier matériau plutôt que de déborder du bloc
+	if (m_Materials.size() >= MAX_MATERIALS)
+		return 0;
+
+	Material material;
+	material.name = name;
+	material.params = params;
+	m_Materials.push_back(material);
+	uint16_t id = (uint16_t)(m_Materials.size() - 1);
+	MarkDirty(id);
+	return id;
+}
+
+uint32_t MaterialSystem::GetTexture(const std::string& path)
+{
+	m_Stats.textureRequests++;
+	std::unordered_map<std::string, int32_t>::iterator it = m_TextureIndices.find(path);
+	if (it != m_TextureIndices.end())
+		return it->second >= 0 ? m_Textures[it->second] : 0;
+
+	uint32_t texture = m_Loader ? m_Loader(path.c_str()) : 0;
+	if (texture == 0)
+	{
+		// Échec mémorisé aussi : on ne retente pas le chargement à chaque matériau
+		m_TextureIndices[path] = -1;
+		return 0;
+	}
+	m_Textures.push_back(texture);
+	m_TextureIndices[path] = (int32_t)m_Textures.size() - 1;
+	m_Stats.texturesLoaded++;
+	return texture;
+}
+
+int32_t MaterialSystem::RequestMap(const std::string& path, uint32_t& texture)
+{
+	texture = GetTexture(path);
+	return texture ? m_TextureIndices[path] : -1;
+}
+
+uint16_t MaterialSystem::AddFromObj(const tinyobj::material_t& source, const std::string& baseDir)
+{
+	MaterialParams params;
+	for (int i = 0; i < 3; ++i)
+	{
+		params.diffuse[i] = (float)source.diffuse[i];
+		params.specular[i] = (float)source.specular[i];
+		params.ambient[i] = (float)source.ambient[i];
+	}
+	params.diffuse[3] = (float)source.dissolve;
+	params.specular[3] = source.shininess > 0.0f ? (float)source.shininess : 1.0f;
+	params.ambient[3] = 0.0f;
+
+	for (int i = 0; i < 4; ++i)
+		params.maps[i] = -1;
+
+	uint16_t id = Add(source.name, params);
+	if (id != m_Materials.size() - 1)
+		return id;
+
+	const std::string& normalMap = source.bump_texname.empty() ? source.normal_texname : source.bump_texname;
+	const std::string& roughnessMap = source.specular_highlight_texname.empty() ? source.roughness_texname : source.specular_highlight_texname;
+	Material& material = m_Materials[id];
+	if (!source.diffuse_texname.empty())
+		material.mapIndices[0] = RequestMap(baseDir + source.diffuse_texname, material.diffuseTexture);
+	if (!normalMap.empty())
+		material.mapIndices[1] = RequestMap(baseDir + normalMap, material.normalTexture);
+	if (!source.ambient_texname.empty())
+		material.mapIndices[2] = RequestMap(baseDir + source.ambient_texname, material.occlusionTexture);
+	if (!roughnessMap.empty())
+		material.mapIndices[3] = RequestMap(baseDir + roughnessMap, material.roughnessTexture);
+	UpdateLayers(material);
+	return id;
+}
+
+void MaterialSystem::SetDiffuseMap(uint16_t id, const std::string& path)
+{
+	if (id >= m_Materials.size())
+		return;
+	Material& material = m_Materials[id];
+	material.mapIndices[0] = RequestMap(path, material.diffuseTexture);
+	UpdateLayers(material);
+	MarkDirty(id);
+}
+
+// Recopie dans les paramètres GPU la couche de chaque carte (une fois le tableau construit)
+void MaterialSystem::UpdateLayers(Material& material)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		int32_t index = material.mapIndices[i];
+		material.params.maps[i] = (index >= 0 && index < (int32_t)m_Layers.size()) ? m_Layers[index] : -1;
+	}
+}
+
+void MaterialSystem::BuildTextureArray(bool bindless)
+{
+	if (m_Textures.empty())
+		return;
+
+	// Taille de référence : première carte chargée
+	GLint width = 0, height = 0;
+	glBindTexture(GL_TEXTURE_2D, m_Textures[0]);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+
+	m_Layers.assign(m_Textures.size(), -1);
+	int32_t layerCount = 0;
+	for (size_t i = 0; i < m_Textures.size(); ++i)
+	{
+		GLint w = 0, h = 0;
+		glBindTexture(GL_TEXTURE_2D, m_Textures[i]);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+		if (w == width && h == height)
+			m_Layers[i] = layerCount++;
+		else
+			m_Stats.arrayRejected++;
+	}
+	m_Stats.arrayLayers = layerCount;
+
+	// Copie par relecture CPU du niveau 0 : disponible dès GL 3.3, exécutée une seule fois
+	int levels = 1;
+	for (GLint size = width > height ? width : height; size > 1; size /= 2)
+		++levels;
+	glGenTextures(1, &m_TextureArray);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_TextureArray);
+	for (int level = 0; level < levels; ++level)
+	{
+		GLint w = width >> level, h = height >> level;
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_SRGB8_ALPHA8, w > 0 ? w : 1, h > 0 ? h : 1, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+	}
+	std::vector<uint8_t> pixels((size_t)width * height * 4);
+	for (size_t i = 0; i < m_Textures.size(); ++i)
+	{
+		if (m_Layers[i] < 0)
+			continue;
+		glBindTexture(GL_TEXTURE_2D, m_Textures[i]);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, m_Layers[i], width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	}
+	glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	for (size_t i = 0; i < m_Materials.size(); ++i)
+	{
+		UpdateLayers(m_Materials[i]);
+		MarkDirty((uint16_t)i);
+	}
+
+#ifdef GL_ARB_bindless_texture
+	if (bindless)
+	{
+		// Un handle par texture du cache, quelle que soit sa taille
+		m_Handles.assign(m_Textures.size(), 0);
+		for (size_t i = 0; i < m_Textures.size(); ++i)
+		{
+			m_Handles[i] = glGetTextureHandleARB(m_Textures[i]);
+			glMakeTextureHandleResidentARB(m_Handles[i]);
+		}
+		std::vector<uint32_t> handles(MAX_MATERIALS * 4, 0);
+		for (size_t i = 0; i < m_Materials.size(); ++i)
+		{
+			int32_t index = m_Materials[i].mapIndices[0];
+			if (index < 0)
+				continue;
+			handles[i * 4 + 0] = (uint32_t)(m_Handles[index] & 0xFFFFFFFFu);
+			handles[i * 4 + 1] = (uint32_t)(m_Handles[index] >> 32);
+			handles[i * 4 + 2] = 1; // z : carte diffuse présente
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, m_HandleBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, handles.size() * sizeof(uint32_t), handles.data());
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_Bindless = true;
+	}
+#else
+	(void)bindless;
+#endif
+}
+
+void MaterialSystem::SetParams(uint16_t id, const MaterialParams& params)
+{
+	if (id >= m_Materials.size())
+		return;
+	if (memcmp(&m_Materials[id].params, &params, sizeof(MaterialParams)) == 0)
+		return;
+	m_Materials[id].params = params;
+	MarkDirty(id);
+}
+
+void MaterialSystem::Upload()
+{
+	if (m_DirtyBegin == m_DirtyEnd)
+		return;
+
+	std::vector<MaterialParams> block(m_DirtyEnd - m_DirtyBegin);
+	for (uint32_t i = m_DirtyBegin; i < m_DirtyEnd; ++i)
+		block[i - m_DirtyBegin] = m_Materials[i].params;
+
+	uint32_t bytes = (uint32_t)(block.size() * sizeof(MaterialParams));
+	glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, m_DirtyBegin * sizeof(MaterialParams), bytes, block.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	m_Stats.uploads++;
+	m_Stats.lastUploadBytes = bytes;
+	m_DirtyBegin = m_DirtyEnd = 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace tinyobj { struct material_t; }
+
+// Disposition std140 d'un matériau dans le bloc "Materials" (64 octets)
+struct MaterialParams
+{
+	float diffuse[4];   // rgb : Kd, a : opacité (d)
+	float specular[4];  // rgb : Ks, a : brillance (Ns)
+	float ambient[4];   // rgb : Ka
+	int32_t maps[4];    // cartes diffuse, normale, occlusion, rugosité : couche du tableau de textures, -1 si absente
+};
+
+struct Material
+{
+	std::string name;
+	MaterialParams params;
+	uint32_t diffuseTexture = 0;   // textures GL, partagées entre matériaux via le cache
+	uint32_t normalTexture = 0;
+	uint32_t occlusionTexture = 0;
+	uint32_t roughnessTexture = 0;
+	int32_t mapIndices[4] = { -1, -1, -1, -1 }; // mêmes cartes, indices dans le cache (-1 : absente)
+};
+
+struct MaterialSystemStats
+{
+	int uploads = 0;            // nombre de glBufferSubData depuis le début
+	uint32_t lastUploadBytes = 0;
+	int textureRequests = 0;    // textures demandées par les matériaux
+	int texturesLoaded = 0;     // textures réellement chargées (après déduplication)
+	int arrayLayers = 0;        // cartes regroupées dans le GL_TEXTURE_2D_ARRAY
+	int arrayRejected = 0;      // cartes d'une autre taille, non accessibles aux shaders
+};
+
+// Table des matériaux de la scène, stockée dans un UBO std140 indexé par dessin
+// (champ material du bloc Object). Les textures sont dédupliquées par chemin et
+// seule la plage de matériaux modifiée est ré-uploadée.
+// Les cartes de même taille sont regroupées en couches d'un GL_TEXTURE_2D_ARRAY lié une
+// seule fois : des objets aux textures différentes peuvent partager un même appel de dessin.
+// Avec ARB_bindless_texture, un handle résident par carte diffuse est aussi publié dans le
+// bloc MaterialHandles (lu par la variante MDI bindless, sans contrainte de taille).
+class MaterialSystem
+{
+public:
+	// 256 x 64 octets = 16 Ko : taille minimale garantie d'un bloc uniforme
+	static const uint32_t MAX_MATERIALS = 256;
+	// Unité de texture du tableau de cartes (sampler u_materialTextures)
+	static const uint32_t TEXTURE_ARRAY_UNIT = 1;
+
+	// Charge une texture 2D et renvoie son identifiant GL (0 en cas d'échec)
+	typedef uint32_t (*TextureLoader)(const char* path);
+
+	static MaterialParams MakeParams(float r, float g, float b, float shininess);
+
+	MaterialSystem() : m_Buffer(0), m_HandleBuffer(0), m_TextureArray(0), m_Bindless(false),
+		m_Loader(nullptr), m_DirtyBegin(0), m_DirtyEnd(0) {}
+
+	// handleBinding : point de liaison du bloc MaterialHandles (utilisé seulement en bindless)
+	bool Create(uint32_t binding, uint32_t handleBinding, TextureLoader loader);
+	void Destroy();
+
+	uint16_t Add(const std::string& name, const MaterialParams& params);
+	// Kd, Ks, Ka, Ns, d et les cartes map_Kd, map_bump, map_Ka, map_Ns d'un .mtl
+	uint16_t AddFromObj(const tinyobj::material_t& material, const std::string& baseDir);
+	void SetDiffuseMap(uint16_t id, const std::string& path);
+
+	// À appeler une fois tous les matériaux créés : construit le tableau de textures
+	// (taille de référence : celle de la première carte) et, si demandé, les handles bindless
+	void BuildTextureArray(bool bindless);
+
+	// Texture du cache pour ce chemin, chargée au premier appel
+	uint32_t GetTexture(const std::string& path);
+
+	const Material& Get(uint16_t id) const { return m_Materials[id]; }
+	// Ne marque le matériau à ré-uploader que si ses paramètres changent réellement
+	void SetParams(uint16_t id, const MaterialParams& params);
+	// Envoie la plage modifiée depuis le dernier appel ; aucun appel GL sinon
+	void Upload();
+
+	size_t GetCount() const { return m_Materials.size(); }
+	uint32_t GetBuffer() const { return m_Buffer; }
+	uint32_t GetTextureArray() const { return m_TextureArray; }
+	bool IsBindless() const { return m_Bindless; }
+	const MaterialSystemStats& GetStats() const { return m_Stats; }
+
+private:
+	int32_t RequestMap(const std::string& path, uint32_t& texture);
+	void MarkDirty(uint16_t id);
+	void UpdateLayers(Material& material);
+
+	std::vector<Material> m_Materials;
+	std::unordered_map<std::string, int32_t> m_TextureIndices; // chemin -> indice dans m_Textures
+	std::vector<uint32_t> m_Textures;
+	std::vector<int32_t> m_Layers;        // couche du tableau par texture du cache (-1 : hors tableau)
+	std::vector<uint64_t> m_Handles;      // handles bindless résidents (par texture du cache)
+	uint32_t m_Buffer;
+	uint32_t m_HandleBuffer;
+	uint32_t m_TextureArray;
+	bool m_Bindless;
+	TextureLoader m_Loader;
+	uint32_t m_DirtyBegin;   // plage [begin, end) de matériaux à ré-uploader
+	uint32_t m_DirtyEnd;
+	MaterialSystemStats m_Stats;
+};
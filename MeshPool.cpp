@@ -0,0 +1,124 @@
+#include "MeshPool.h"
+#include "GLPlatform.h"
+
+bool MeshPool::Create(uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity, LayoutFunction layout)
+{
+	m_VertexStride = vertexStride;
+	m_Layout = layout;
+	m_VertexAllocator.Reset(vertexCapacity);
+	m_IndexAllocator.Reset(indexCapacity);
+
+	glGenBuffers(1, &m_Vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, m_Vbo);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexCapacity * vertexStride, nullptr, GL_STATIC_DRAW);
+	glGenBuffers(1, &m_Ibo);
+	glBindBuffer(GL_ARRAY_BUFFER, m_Ibo);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)indexCapacity * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glGenVertexArrays(1, &m_Vao);
+	SetupVao();
+	return m_Vao != 0 && m_Vbo != 0 && m_Ibo != 0;
+}
+
+void MeshPool::SetupVao()
+{
+	glBindVertexArray(m_Vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_Vbo);
+	m_Layout();
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_Ibo);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void MeshPool::Destroy()
+{
+	glDeleteVertexArrays(1, &m_Vao);
+	glDeleteBuffers(1, &m_Vbo);
+	glDeleteBuffers(1, &m_Ibo);
+	m_Vao = m_Vbo = m_Ibo = 0;
+	m_VertexAllocator.Reset(0);
+	m_IndexAllocator.Reset(0);
+}
+
+// Réalloue un buffer plus grand et y recopie le contenu actuel côté GPU
+static uint32_t GrowBuffer(uint32_t buffer, GLsizeiptr oldBytes, GLsizeiptr newBytes)
+{
+	uint32_t grown = 0;
+	glGenBuffers(1, &grown);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+	glBufferData(GL_COPY_WRITE_BUFFER, newBytes, nullptr, GL_STATIC_DRAW);
+	glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldBytes);
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	glDeleteBuffers(1, &buffer);
+	return grown;
+}
+
+void MeshPool::GrowVertices(uint32_t minCapacity)
+{
+	uint32_t oldCapacity = m_VertexAllocator.GetSize();
+	uint32_t newCapacity = oldCapacity * 2 > minCapacity ? oldCapacity * 2 : minCapacity;
+	m_Vbo = GrowBuffer(m_Vbo, (GLsizeiptr)oldCapacity * m_VertexStride, (GLsizeiptr)newCapacity * m_VertexStride);
+	m_VertexAllocator.Grow(newCapacity);
+	SetupVao();
+}
+
+void MeshPool::GrowIndices(uint32_t minCapacity)
+{
+	uint32_t oldCapacity = m_IndexAllocator.GetSize();
+	uint32_t newCapacity = oldCapacity * 2 > minCapacity ? oldCapacity * 2 : minCapacity;
+	m_Ibo = GrowBuffer(m_Ibo, (GLsizeiptr)oldCapacity * sizeof(uint32_t), (GLsizeiptr)newCapacity * sizeof(uint32_t));
+	m_IndexAllocator.Grow(newCapacity);
+	SetupVao();
+}
+
+bool MeshPool::Upload(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, MeshRange& range)
+{
+	if (vertexCount == 0 || indexCount == 0)
+		return false;
+
+	range.vertices = m_VertexAllocator.Allocate(vertexCount);
+	while (range.vertices.offset == OffsetAllocation::NO_SPACE)
+	{
+		GrowVertices(m_VertexAllocator.GetSize() + vertexCount);
+		range.vertices = m_VertexAllocator.Allocate(vertexCount);
+	}
+	range.indices = m_IndexAllocator.Allocate(indexCount);
+	while (range.indices.offset == OffsetAllocation::NO_SPACE)
+	{
+		GrowIndices(m_IndexAllocator.GetSize() + indexCount);
+		range.indices = m_IndexAllocator.Allocate(indexCount);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_Vbo);
+	glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)range.vertices.offset * m_VertexStride, (GLsizeiptr)vertexCount * m_VertexStride, vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, m_Ibo);
+	glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)range.indices.offset * sizeof(uint32_t), (GLsizeiptr)indexCount * sizeof(uint32_t), indices);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	range.baseVertex = (int32_t)range.vertices.offset;
+	range.firstIndex = range.indices.offset;
+	range.indexCount = (int32_t)indexCount;
+	return true;
+}
+
+void MeshPool::Release(MeshRange& range)
+{
+	m_VertexAllocator.Free(range.vertices);
+	m_IndexAllocator.Free(range.indices);
+	range = MeshRange();
+}
+
+MeshPoolStats MeshPool::GetStats() const
+{
+	MeshPoolStats stats;
+	stats.vertexCapacity = m_VertexAllocator.GetSize();
+	stats.verticesUsed = m_VertexAllocator.GetUsed();
+	stats.indexCapacity = m_IndexAllocator.GetSize();
+	stats.indicesUsed = m_IndexAllocator.GetUsed();
+	stats.freeVertexRegions = m_VertexAllocator.GetReport().freeRegions;
+	stats.freeIndexRegions = m_IndexAllocator.GetReport().freeRegions;
+	return stats;
+}
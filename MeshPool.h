@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include "OffsetAllocator.h"
+
+// Plages occupées par un maillage dans les buffers partagés du pool
+struct MeshRange
+{
+	OffsetAllocation vertices;
+	OffsetAllocation indices;
+	int32_t baseVertex = 0;   // ajouté aux indices par glDrawElementsBaseVertex
+	uint32_t firstIndex = 0;  // premier indice dans l'IBO partagé
+	int32_t indexCount = 0;
+};
+
+struct MeshPoolStats
+{
+	uint32_t vertexCapacity = 0;
+	uint32_t verticesUsed = 0;
+	uint32_t indexCapacity = 0;
+	uint32_t indicesUsed = 0;
+	uint32_t freeVertexRegions = 0;
+	uint32_t freeIndexRegions = 0;
+};
+
+// Un VBO et un IBO de grande taille pour un format de sommet donné, découpés en plages
+// par un OffsetAllocator. Tous les maillages partagent le même VAO et sont dessinés
+// avec glDrawElementsBaseVertex ; les buffers sont agrandis (x2) si une allocation échoue.
+class MeshPool
+{
+public:
+	// Déclare les attributs de sommet sur le VAO (VBO du pool lié sur GL_ARRAY_BUFFER)
+	typedef void (*LayoutFunction)();
+
+	MeshPool() : m_Vao(0), m_Vbo(0), m_Ibo(0), m_VertexStride(0), m_Layout(nullptr) {}
+
+	bool Create(uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity, LayoutFunction layout);
+	void Destroy();
+
+	bool Upload(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount, MeshRange& range);
+	void Release(MeshRange& range);
+
+	uint32_t GetVao() const { return m_Vao; }
+	MeshPoolStats GetStats() const;
+
+private:
+	void GrowVertices(uint32_t minCapacity);
+	void GrowIndices(uint32_t minCapacity);
+	void SetupVao();
+
+	uint32_t m_Vao;
+	uint32_t m_Vbo;
+	uint32_t m_Ibo;
+	uint32_t m_VertexStride;
+	LayoutFunction m_Layout;
+	OffsetAllocator m_VertexAllocator;
+	OffsetAllocator m_IndexAllocator;
+};
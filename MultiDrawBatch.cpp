@@ -0,0 +1,157 @@
+#include "MultiDrawBatch.h"
+#include "GLPlatform.h"
+
+bool MultiDrawBatch::Create(bool indirect)
+{
+#ifdef GL_VERSION_4_3
+	if (indirect)
+	{
+		glGenBuffers(1, &m_CommandBuffer);
+		glGenBuffers(1, &m_RecordBuffer);
+		glGenBuffers(1, &m_DrawIdBuffer);
+	}
+#else
+	(void)indirect;
+#endif
+	return true;
+}
+
+void MultiDrawBatch::Destroy()
+{
+	glDeleteBuffers(1, &m_CommandBuffer);
+	glDeleteBuffers(1, &m_RecordBuffer);
+	glDeleteBuffers(1, &m_DrawIdBuffer);
+	m_CommandBuffer = m_RecordBuffer = m_DrawIdBuffer = 0;
+	m_DrawIdCapacity = 0;
+}
+
+void MultiDrawBatch::Clear()
+{
+	m_Commands.clear();
+	m_Records.clear();
+	m_ObjectOffsets.clear();
+}
+
+void MultiDrawBatch::SwapDraws(MultiDrawBatch& other)
+{
+	m_Commands.swap(other.m_Commands);
+	m_Records.swap(other.m_Records);
+	m_ObjectOffsets.clear();
+}
+
+void MultiDrawBatch::Add(uint32_t firstIndex, int32_t baseVertex, int32_t indexCount, const mat4& model, uint16_t material)
+{
+	size_t index = m_Commands.size();
+	Resize(index + 1);
+	Set(index, firstIndex, baseVertex, indexCount, model, material);
+}
+
+void MultiDrawBatch::Resize(size_t count)
+{
+	m_Commands.resize(count);
+	m_Records.resize(count);
+}
+
+void MultiDrawBatch::Set(size_t index, uint32_t firstIndex, int32_t baseVertex, int32_t indexCount, const mat4& model, uint16_t material)
+{
+	DrawElementsIndirectCommand& command = m_Commands[index];
+	command.count = (uint32_t)indexCount;
+	command.instanceCount = 1;
+	command.firstIndex = firstIndex;
+	command.baseVertex = baseVertex;
+	command.baseInstance = (uint32_t)index;
+
+	DrawRecord& record = m_Records[index];
+	record.model = model;
+	record.material = material;
+	record.padding[0] = record.padding[1] = record.padding[2] = 0;
+}
+
+void MultiDrawBatch::EnsureDrawIds(uint32_t count)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, m_DrawIdBuffer);
+	if (count > m_DrawIdCapacity)
+	{
+		uint32_t capacity = m_DrawIdCapacity ? m_DrawIdCapacity : 1024;
+		while (capacity < count)
+			capacity *= 2;
+		std::vector<uint32_t> ids(capacity);
+		for (uint32_t i = 0; i < capacity; ++i)
+			ids[i] = i;
+		glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(uint32_t), ids.data(), GL_STATIC_DRAW);
+		m_DrawIdCapacity = capacity;
+	}
+	// Pointé à chaque appel : le VAO est partagé avec les autres lots (ombres, benchmark), qui y
+	// accrochent leur propre tampon
+	glEnableVertexAttribArray(DRAW_ID_ATTRIB_LOCATION);
+	glVertexAttribIPointer(DRAW_ID_ATTRIB_LOCATION, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (const void*)0);
+	glVertexAttribDivisor(DRAW_ID_ATTRIB_LOCATION, 1);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void MultiDrawBatch::SubmitIndirect(uint32_t vao, bool upload)
+{
+#ifdef GL_VERSION_4_3
+	if (m_Commands.empty() || !IsIndirectAvailable())
+		return;
+
+	glBindVertexArray(vao);
+	EnsureDrawIds((uint32_t)m_Commands.size());
+
+	// Réallocation à chaque frame (orphaning) : le pilote n'attend pas la frame précédente
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_CommandBuffer);
+	if (upload)
+	{
+		GLsizeiptr commandBytes = m_Commands.size() * sizeof(DrawElementsIndirectCommand);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, commandBytes, m_Commands.data(), GL_STREAM_DRAW);
+
+		GLsizeiptr recordBytes = m_Records.size() * sizeof(DrawRecord);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_RecordBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, recordBytes, m_Records.data(), GL_STREAM_DRAW);
+	}
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_RECORD_BINDING, m_RecordBuffer);
+
+	glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const void*)0, (GLsizei)m_Commands.size(), 0);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	glBindVertexArray(0);
+#else
+	(void)vao;
+#endif
+}
+
+bool MultiDrawBatch::WriteObjectData(UniformRing& ring)
+{
+	bool complete = true;
+	m_ObjectBuffer = ring.GetBuffer();
+	m_ObjectOffsets.resize(m_Records.size());
+	for (size_t i = 0; i < m_Records.size(); ++i)
+	{
+		ObjectBlock block;
+		block.model = m_Records[i].model;
+		block.material = m_Records[i].material;
+		block.padding[0] = block.padding[1] = block.padding[2] = 0;
+		m_ObjectOffsets[i] = ~0u;
+		if (!ring.Write(&block, sizeof(ObjectBlock), m_ObjectOffsets[i]))
+			complete = false;
+	}
+	return complete;
+}
+
+void MultiDrawBatch::SubmitLoop(uint32_t vao)
+{
+	if (m_Commands.empty() || m_ObjectOffsets.size() != m_Commands.size())
+		return;
+
+	glBindVertexArray(vao);
+	for (size_t i = 0; i < m_Commands.size(); ++i)
+	{
+		const DrawElementsIndirectCommand& command = m_Commands[i];
+		if (m_ObjectOffsets[i] == ~0u)
+			continue;
+		glBindBufferRange(GL_UNIFORM_BUFFER, UNIFORM_BINDING_OBJECT, m_ObjectBuffer, m_ObjectOffsets[i], sizeof(ObjectBlock));
+		glDrawElementsBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+			(const void*)((uintptr_t)command.firstIndex * sizeof(uint32_t)), command.baseVertex);
+	}
+	glBindVertexArray(0);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "mat4.h"
+#include "RenderQueue.h"
+
+// Lot de dessins opaques d'un même programme sur le VAO partagé du MeshPool.
+// Sur GL 4.3+ tout le lot part en un seul glMultiDrawElementsIndirect : les commandes vont
+// dans un GL_DRAW_INDIRECT_BUFFER et les données par dessin (matrice, matériau) dans un SSBO
+// lu via l'indice de dessin. Sinon, le lot est émis en boucle de glDrawElementsBaseVertex.
+// Dans les deux cas, les paramètres de matériau sont lus dans le bloc Materials (MaterialSystem).
+class MultiDrawBatch
+{
+public:
+	// Disposition imposée par glMultiDrawElementsIndirect
+	struct DrawElementsIndirectCommand
+	{
+		uint32_t count;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t baseVertex;
+		uint32_t baseInstance; // = indice du dessin, relu par l'attribut a_drawId
+	};
+
+	// std430 : mat4 + uvec4
+	struct DrawRecord
+	{
+		mat4 model;
+		uint32_t material;
+		uint32_t padding[3];
+	};
+
+	// Location de l'attribut a_drawId (divisor 1)
+	static const uint32_t DRAW_ID_ATTRIB_LOCATION = 7;
+	// Binding SSBO utilisé par phong_mdi.vs
+	static const uint32_t DRAW_RECORD_BINDING = 0;
+
+	MultiDrawBatch() : m_ObjectBuffer(0), m_CommandBuffer(0), m_RecordBuffer(0), m_DrawIdBuffer(0), m_DrawIdCapacity(0) {}
+
+	// indirect = false : aucun buffer GPU n'est créé, seul le chemin en boucle est disponible
+	bool Create(bool indirect);
+	void Destroy();
+
+	void Clear();
+	void Add(uint32_t firstIndex, int32_t baseVertex, int32_t indexCount, const mat4& model, uint16_t material);
+	// Remplissage en parallèle : Resize une fois, puis Set sur des indices distincts depuis n'importe quel thread
+	void Resize(size_t count);
+	void Set(size_t index, uint32_t firstIndex, int32_t baseVertex, int32_t indexCount, const mat4& model, uint16_t material);
+	// Échange la liste de dessins avec celle d'un autre lot (sans copie) : un lot sans buffers GPU
+	// peut être rempli sur un autre thread puis confié à celui qui possède le contexte GL
+	void SwapDraws(MultiDrawBatch& other);
+
+	// Programme MDI déjà lié par l'appelant ; upload = false réutilise les commandes et les données
+	// envoyées par l'appel précédent de la frame (pré-passe de profondeur puis passe couleur)
+	void SubmitIndirect(uint32_t vao, bool upload = true);
+	// Chemin GL 3.3 : un bloc Object par dessin, écrit dans l'anneau avant UniformRing::Commit ;
+	// renvoie false si l'anneau était plein (dessins sautés par SubmitLoop cette frame)
+	bool WriteObjectData(UniformRing& ring);
+	// Lie la plage du bloc Object (matrice et matériau) à chaque dessin
+	void SubmitLoop(uint32_t vao);
+
+	bool IsIndirectAvailable() const { return m_CommandBuffer != 0; }
+	size_t GetCount() const { return m_Commands.size(); }
+
+private:
+	// Tampon d'indices 0..count-1 attaché à a_drawId du VAO lié
+	void EnsureDrawIds(uint32_t count);
+
+	std::vector<DrawElementsIndirectCommand> m_Commands;
+	std::vector<DrawRecord> m_Records;
+	std::vector<uint32_t> m_ObjectOffsets;
+	uint32_t m_ObjectBuffer;
+	uint32_t m_CommandBuffer;
+	uint32_t m_RecordBuffer;
+	uint32_t m_DrawIdBuffer;
+	uint32_t m_DrawIdCapacity;
+};
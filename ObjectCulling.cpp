@@ -0,0 +1,166 @@
+#include "ObjectCulling.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+Frustum Frustum::FromMatrix(const mat4& viewProjection)
+{
+	// Lignes de la matrice (stockage colonne) : plan = ligne 3 +/- ligne i (Gribb-Hartmann)
+	const float* m = viewProjection.m;
+	Frustum frustum;
+	for (int i = 0; i < 3; ++i)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			frustum.planes[2 * i][k] = m[k * 4 + 3] + m[k * 4 + i];
+			frustum.planes[2 * i + 1][k] = m[k * 4 + 3] - m[k * 4 + i];
+		}
+	}
+	for (int p = 0; p < 6; ++p)
+	{
+		float* plane = frustum.planes[p];
+		float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+		if (length > 0.0f)
+		{
+			for (int k = 0; k < 4; ++k)
+				plane[k] /= length;
+		}
+	}
+	return frustum;
+}
+
+bool Frustum::IntersectsSphere(const float center[3], float radius) const
+{
+	for (int p = 0; p < 6; ++p)
+	{
+		const float* plane = planes[p];
+		if (plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3] < -radius)
+			return false;
+	}
+	return true;
+}
+
+uint32_t ObjectCuller::Run(JobSystem& jobs, const CullObject* objects, uint32_t count, const Frustum& frustum)
+{
+	m_Objects = objects;
+	m_Count = count;
+	m_Frustum = frustum;
+	m_Visibility.resize(count);
+	uint32_t chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	m_ChunkOffsets.resize(chunkCount);
+	if (chunkCount == 0)
+	{
+		m_Visible.clear();
+		m_Transforms.clear();
+		return 0;
+	}
+
+	if (!JobSystem::IsWorkerThread())
+	{
+		CullChunks(this, 0, chunkCount);
+		ComputeOffsets(this, 0, 0);
+		BuildTransforms(this, 0, chunkCount);
+		return (uint32_t)m_Visible.size();
+	}
+
+	JobSystem::Job* cull = jobs.CreateParallelFor(chunkCount, 1, CullChunks, this);
+	JobSystem::Job* offsets = cull ? jobs.CreateJob(ComputeOffsets, this) : nullptr;
+	JobSystem::Job* transforms = offsets ? jobs.CreateParallelFor(chunkCount, 1, BuildTransforms, this) : nullptr;
+	if (!transforms)
+	{
+		// Pool de tâches plein : étapes attendues l'une après l'autre
+		if (cull)
+		{
+			jobs.Submit(cull);
+			jobs.Wait(cull);
+		}
+		else
+		{
+			CullChunks(this, 0, chunkCount);
+		}
+		if (offsets)
+		{
+			jobs.Submit(offsets);
+			jobs.Wait(offsets);
+		}
+		else
+		{
+			ComputeOffsets(this, 0, 0);
+		}
+		jobs.ParallelFor(chunkCount, 1, BuildTransforms, this);
+		return (uint32_t)m_Visible.size();
+	}
+	jobs.AddDependency(offsets, cull);
+	jobs.AddDependency(transforms, offsets);
+	jobs.Submit(transforms);
+	jobs.Submit(offsets);
+	jobs.Submit(cull);
+	jobs.Wait(transforms);
+	return (uint32_t)m_Visible.size();
+}
+
+void ObjectCuller::CullChunks(void* data, uint32_t begin, uint32_t end)
+{
+	ObjectCuller* culler = (ObjectCuller*)data;
+	for (uint32_t chunk = begin; chunk < end; ++chunk)
+	{
+		uint32_t first = chunk * CHUNK_SIZE;
+		uint32_t last = std::min(first + CHUNK_SIZE, culler->m_Count);
+		uint32_t visible = 0;
+		for (uint32_t i = first; i < last; ++i)
+		{
+			const CullObject& object = culler->m_Objects[i];
+			bool inside = culler->m_Frustum.IntersectsSphere(object.position, object.radius * object.scale);
+			culler->m_Visibility[i] = inside ? 1 : 0;
+			visible += inside ? 1 : 0;
+		}
+		culler->m_ChunkOffsets[chunk] = visible;
+	}
+}
+
+void ObjectCuller::ComputeOffsets(void* data, uint32_t, uint32_t)
+{
+	ObjectCuller* culler = (ObjectCuller*)data;
+	uint32_t total = 0;
+	for (size_t chunk = 0; chunk < culler->m_ChunkOffsets.size(); ++chunk)
+	{
+		uint32_t visible = culler->m_ChunkOffsets[chunk];
+		culler->m_ChunkOffsets[chunk] = total;
+		total += visible;
+	}
+	culler->m_Visible.resize(total);
+	culler->m_Transforms.resize(total);
+}
+
+void ObjectCuller::BuildTransforms(void* data, uint32_t begin, uint32_t end)
+{
+	ObjectCuller* culler = (ObjectCuller*)data;
+	for (uint32_t chunk = begin; chunk < end; ++chunk)
+	{
+		uint32_t first = chunk * CHUNK_SIZE;
+		uint32_t last = std::min(first + CHUNK_SIZE, culler->m_Count);
+		uint32_t output = culler->m_ChunkOffsets[chunk];
+		for (uint32_t i = first; i < last; ++i)
+		{
+			if (!culler->m_Visibility[i])
+				continue;
+			// translate * rotateY * scale, sans les produits de matrices
+			const CullObject& object = culler->m_Objects[i];
+			float c = std::cos(object.angle) * object.scale;
+			float s = std::sin(object.angle) * object.scale;
+			mat4& model = culler->m_Transforms[output];
+			model.identity();
+			model.m[0] = c;
+			model.m[2] = -s;
+			model.m[5] = object.scale;
+			model.m[8] = s;
+			model.m[10] = c;
+			model.m[12] = object.position[0];
+			model.m[13] = object.position[1];
+			model.m[14] = object.position[2];
+			culler->m_Visible[output] = i;
+			++output;
+		}
+	}
+}
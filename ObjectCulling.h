@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "mat4.h"
+
+class JobSystem;
+
+// Objet à tester : position, rotation autour de Y, échelle uniforme et rayon de la sphère
+// englobante du maillage (avant échelle)
+struct CullObject
+{
+	float position[3];
+	float angle;
+	float scale;
+	float radius;
+};
+
+// Six plans (a, b, c, d) extraits d'une matrice projection * vue, normales vers l'intérieur
+struct Frustum
+{
+	float planes[6][4];
+
+	static Frustum FromMatrix(const mat4& viewProjection);
+	bool IntersectsSphere(const float center[3], float radius) const;
+};
+
+// Culling par frustum et construction des matrices des objets visibles, répartis sur le
+// JobSystem en trois étapes enchaînées par dépendances :
+// test des sphères par blocs -> somme préfixe des visibles par bloc -> matrices des visibles,
+// écrites directement à leur place dans le résultat compacté (ordre d'entrée conservé).
+class ObjectCuller
+{
+public:
+	// Objets par bloc : une tâche traite un bloc entier
+	static const uint32_t CHUNK_SIZE = 1024;
+
+	ObjectCuller() : m_Objects(nullptr), m_Count(0) {}
+
+	// Renvoie le nombre d'objets visibles ; hors d'un thread du JobSystem, tout est fait sur place
+	uint32_t Run(JobSystem& jobs, const CullObject* objects, uint32_t count, const Frustum& frustum);
+
+	// Indices (dans "objects") et matrices modèle des objets visibles
+	const std::vector<uint32_t>& GetVisible() const { return m_Visible; }
+	const std::vector<mat4>& GetTransforms() const { return m_Transforms; }
+
+private:
+	static void CullChunks(void* data, uint32_t begin, uint32_t end);
+	static void ComputeOffsets(void* data, uint32_t begin, uint32_t end);
+	static void BuildTransforms(void* data, uint32_t begin, uint32_t end);
+
+	const CullObject* m_Objects;
+	uint32_t m_Count;
+	Frustum m_Frustum;
+	std::vector<uint8_t> m_Visibility;
+	std::vector<uint32_t> m_ChunkOffsets;  // nombre de visibles par bloc, puis position du premier
+	std::vector<uint32_t> m_Visible;
+	std::vector<mat4> m_Transforms;
+};
@@ -0,0 +1,305 @@
+#include "OffsetAllocator.h"
+
+namespace
+{
+	const uint32_t MANTISSA_BITS = 3;
+	const uint32_t MANTISSA_VALUE = 1 << MANTISSA_BITS;
+	const uint32_t MANTISSA_MASK = MANTISSA_VALUE - 1;
+
+	uint32_t HighestSetBit(uint32_t v)
+	{
+		uint32_t bit = 0;
+		while (v >>= 1)
+			++bit;
+		return bit;
+	}
+
+	uint32_t LowestSetBit(uint32_t v)
+	{
+		uint32_t bit = 0;
+		while (!(v & 1))
+		{
+			v >>= 1;
+			++bit;
+		}
+		return bit;
+	}
+
+	// Indice du premier bit à 1 à partir de startBit, NO_SPACE si aucun
+	uint32_t FindLowestSetBitAfter(uint32_t mask, uint32_t startBit)
+	{
+		if (startBit >= 32)
+			return OffsetAllocation::NO_SPACE;
+		uint32_t masked = mask & ~((1u << startBit) - 1);
+		return masked ? LowestSetBit(masked) : OffsetAllocation::NO_SPACE;
+	}
+
+	// Taille -> classe de taille "flottante" (exposant 5 bits, mantisse 3 bits)
+	uint32_t SizeToBinRoundUp(uint32_t size)
+	{
+		if (size < MANTISSA_VALUE)
+			return size;
+		uint32_t mantissaStartBit = HighestSetBit(size) - MANTISSA_BITS;
+		uint32_t exponent = mantissaStartBit + 1;
+		uint32_t mantissa = (size >> mantissaStartBit) & MANTISSA_MASK;
+		if (size & ((1u << mantissaStartBit) - 1))
+			mantissa++; // le débordement de la mantisse se propage correctement dans l'exposant
+		return (exponent << MANTISSA_BITS) + mantissa;
+	}
+
+	uint32_t SizeToBinRoundDown(uint32_t size)
+	{
+		if (size < MANTISSA_VALUE)
+			return size;
+		uint32_t mantissaStartBit = HighestSetBit(size) - MANTISSA_BITS;
+		uint32_t exponent = mantissaStartBit + 1;
+		uint32_t mantissa = (size >> mantissaStartBit) & MANTISSA_MASK;
+		return (exponent << MANTISSA_BITS) | mantissa;
+	}
+}
+
+OffsetAllocator::OffsetAllocator(uint32_t size)
+{
+	Reset(size);
+}
+
+void OffsetAllocator::Reset(uint32_t size)
+{
+	m_Size = size;
+	m_FreeStorage = 0;
+	m_LastNode = UNUSED;
+	m_UsedBinsTop = 0;
+	for (uint32_t i = 0; i < NUM_TOP_BINS; ++i)
+		m_UsedBins[i] = 0;
+	for (uint32_t i = 0; i < NUM_LEAF_BINS; ++i)
+		m_BinIndices[i] = UNUSED;
+	m_Nodes.clear();
+	m_FreeNodes.clear();
+
+	if (size > 0)
+		m_LastNode = InsertNodeIntoBin(size, 0);
+}
+
+uint32_t OffsetAllocator::NewNode()
+{
+	if (!m_FreeNodes.empty())
+	{
+		uint32_t index = m_FreeNodes.back();
+		m_FreeNodes.pop_back();
+		m_Nodes[index] = Node();
+		return index;
+	}
+	m_Nodes.push_back(Node());
+	return (uint32_t)m_Nodes.size() - 1;
+}
+
+uint32_t OffsetAllocator::InsertNodeIntoBin(uint32_t size, uint32_t offset)
+{
+	// Arrondi inférieur : une région de cette classe peut toujours servir la taille de la classe
+	uint32_t binIndex = SizeToBinRoundDown(size);
+	uint32_t topBinIndex = binIndex >> MANTISSA_BITS;
+	uint32_t leafBinIndex = binIndex & MANTISSA_MASK;
+
+	if (m_BinIndices[binIndex] == UNUSED)
+	{
+		m_UsedBins[topBinIndex] |= 1 << leafBinIndex;
+		m_UsedBinsTop |= 1u << topBinIndex;
+	}
+
+	uint32_t topNodeIndex = m_BinIndices[binIndex];
+	uint32_t nodeIndex = NewNode();
+	Node& node = m_Nodes[nodeIndex];
+	node.offset = offset;
+	node.size = size;
+	node.binListNext = topNodeIndex;
+	if (topNodeIndex != UNUSED)
+		m_Nodes[topNodeIndex].binListPrev = nodeIndex;
+	m_BinIndices[binIndex] = nodeIndex;
+
+	m_FreeStorage += size;
+	return nodeIndex;
+}
+
+void OffsetAllocator::RemoveNodeFromBin(uint32_t nodeIndex)
+{
+	Node& node = m_Nodes[nodeIndex];
+	if (node.binListPrev != UNUSED)
+	{
+		m_Nodes[node.binListPrev].binListNext = node.binListNext;
+		if (node.binListNext != UNUSED)
+			m_Nodes[node.binListNext].binListPrev = node.binListPrev;
+	}
+	else
+	{
+		// Tête de liste : mettre à jour la classe et éventuellement les bitmasks
+		uint32_t binIndex = SizeToBinRoundDown(node.size);
+		uint32_t topBinIndex = binIndex >> MANTISSA_BITS;
+		uint32_t leafBinIndex = binIndex & MANTISSA_MASK;
+		m_BinIndices[binIndex] = node.binListNext;
+		if (node.binListNext != UNUSED)
+			m_Nodes[node.binListNext].binListPrev = UNUSED;
+		if (m_BinIndices[binIndex] == UNUSED)
+		{
+			m_UsedBins[topBinIndex] &= ~(1 << leafBinIndex);
+			if (m_UsedBins[topBinIndex] == 0)
+				m_UsedBinsTop &= ~(1u << topBinIndex);
+		}
+	}
+	m_FreeNodes.push_back(nodeIndex);
+	m_FreeStorage -= node.size;
+}
+
+OffsetAllocation OffsetAllocator::Allocate(uint32_t size)
+{
+	OffsetAllocation allocation;
+	if (size == 0)
+		return allocation;
+
+	// Arrondi supérieur : toute région de la classe trouvée est assez grande
+	uint32_t minBinIndex = SizeToBinRoundUp(size);
+	uint32_t minTopBinIndex = minBinIndex >> MANTISSA_BITS;
+	uint32_t minLeafBinIndex = minBinIndex & MANTISSA_MASK;
+
+	uint32_t topBinIndex = minTopBinIndex;
+	uint32_t leafBinIndex = OffsetAllocation::NO_SPACE;
+	if (topBinIndex < NUM_TOP_BINS && (m_UsedBinsTop & (1u << topBinIndex)))
+		leafBinIndex = FindLowestSetBitAfter(m_UsedBins[topBinIndex], minLeafBinIndex);
+
+	if (leafBinIndex == OffsetAllocation::NO_SPACE)
+	{
+		topBinIndex = FindLowestSetBitAfter(m_UsedBinsTop, minTopBinIndex + 1);
+		if (topBinIndex == OffsetAllocation::NO_SPACE)
+			return allocation;
+		leafBinIndex = LowestSetBit(m_UsedBins[topBinIndex]);
+	}
+
+	uint32_t binIndex = (topBinIndex << MANTISSA_BITS) | leafBinIndex;
+	uint32_t nodeIndex = m_BinIndices[binIndex];
+	uint32_t nodeTotalSize = m_Nodes[nodeIndex].size;
+	uint32_t nodeOffset = m_Nodes[nodeIndex].offset;
+
+	// Retire le noeud de sa classe ; il redevient un noeud "utilisé" (on annule le recyclage)
+	RemoveNodeFromBin(nodeIndex);
+	m_FreeNodes.pop_back();
+	Node& node = m_Nodes[nodeIndex];
+	node.binListPrev = UNUSED;
+	node.binListNext = UNUSED;
+	node.size = size;
+	node.used = true;
+
+	// Le reste de la région retourne dans les classes libres, en voisin direct
+	uint32_t remainder = nodeTotalSize - size;
+	if (remainder > 0)
+	{
+		uint32_t newNodeIndex = InsertNodeIntoBin(remainder, nodeOffset + size);
+		Node& current = m_Nodes[nodeIndex];
+		Node& rest = m_Nodes[newNodeIndex];
+		if (current.neighborNext != UNUSED)
+			m_Nodes[current.neighborNext].neighborPrev = newNodeIndex;
+		rest.neighborPrev = nodeIndex;
+		rest.neighborNext = current.neighborNext;
+		current.neighborNext = newNodeIndex;
+		if (m_LastNode == nodeIndex)
+			m_LastNode = newNodeIndex;
+	}
+
+	allocation.offset = nodeOffset;
+	allocation.size = size;
+	allocation.metadata = nodeIndex;
+	return allocation;
+}
+
+void OffsetAllocator::Free(const OffsetAllocation& allocation)
+{
+	if (allocation.metadata == OffsetAllocation::NO_SPACE)
+		return;
+
+	uint32_t nodeIndex = allocation.metadata;
+	uint32_t offset = m_Nodes[nodeIndex].offset;
+	uint32_t size = m_Nodes[nodeIndex].size;
+	uint32_t neighborPrev = m_Nodes[nodeIndex].neighborPrev;
+	uint32_t neighborNext = m_Nodes[nodeIndex].neighborNext;
+	bool wasLast = (m_LastNode == nodeIndex);
+
+	// Fusion avec le voisin précédent s'il est libre
+	if (neighborPrev != UNUSED && !m_Nodes[neighborPrev].used)
+	{
+		offset = m_Nodes[neighborPrev].offset;
+		size += m_Nodes[neighborPrev].size;
+		uint32_t prevPrev = m_Nodes[neighborPrev].neighborPrev;
+		RemoveNodeFromBin(neighborPrev);
+		neighborPrev = prevPrev;
+	}
+
+	// Fusion avec le voisin suivant s'il est libre
+	if (neighborNext != UNUSED && !m_Nodes[neighborNext].used)
+	{
+		size += m_Nodes[neighborNext].size;
+		uint32_t nextNext = m_Nodes[neighborNext].neighborNext;
+		if (m_LastNode == neighborNext)
+			wasLast = true;
+		RemoveNodeFromBin(neighborNext);
+		neighborNext = nextNext;
+	}
+
+	m_FreeNodes.push_back(nodeIndex);
+
+	uint32_t combinedIndex = InsertNodeIntoBin(size, offset);
+	m_Nodes[combinedIndex].neighborPrev = neighborPrev;
+	m_Nodes[combinedIndex].neighborNext = neighborNext;
+	if (neighborPrev != UNUSED)
+		m_Nodes[neighborPrev].neighborNext = combinedIndex;
+	if (neighborNext != UNUSED)
+		m_Nodes[neighborNext].neighborPrev = combinedIndex;
+	if (wasLast)
+		m_LastNode = combinedIndex;
+}
+
+void OffsetAllocator::Grow(uint32_t newSize)
+{
+	if (newSize <= m_Size)
+		return;
+
+	uint32_t extra = newSize - m_Size;
+	uint32_t oldSize = m_Size;
+	m_Size = newSize;
+
+	if (m_LastNode == UNUSED)
+	{
+		m_LastNode = InsertNodeIntoBin(extra, oldSize);
+		return;
+	}
+
+	// La nouvelle région est insérée comme un noeud utilisé en fin d'espace puis libérée,
+	// ce qui la fusionne avec la dernière région si celle-ci est libre
+	uint32_t nodeIndex = NewNode();
+	Node& node = m_Nodes[nodeIndex];
+	node.offset = oldSize;
+	node.size = extra;
+	node.used = true;
+	node.neighborPrev = m_LastNode;
+	m_Nodes[m_LastNode].neighborNext = nodeIndex;
+	m_LastNode = nodeIndex;
+
+	OffsetAllocation allocation;
+	allocation.offset = oldSize;
+	allocation.size = extra;
+	allocation.metadata = nodeIndex;
+	Free(allocation);
+}
+
+OffsetAllocatorReport OffsetAllocator::GetReport() const
+{
+	OffsetAllocatorReport report;
+	report.totalFree = m_FreeStorage;
+	for (uint32_t binIndex = 0; binIndex < NUM_LEAF_BINS; ++binIndex)
+	{
+		for (uint32_t nodeIndex = m_BinIndices[binIndex]; nodeIndex != UNUSED; nodeIndex = m_Nodes[nodeIndex].binListNext)
+		{
+			report.freeRegions++;
+			if (m_Nodes[nodeIndex].size > report.largestFree)
+				report.largestFree = m_Nodes[nodeIndex].size;
+		}
+	}
+	return report;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Plage allouée : offset et taille en unités de l'appelant (sommets, indices...)
+struct OffsetAllocation
+{
+	static const uint32_t NO_SPACE = 0xFFFFFFFF;
+
+	uint32_t offset = NO_SPACE;
+	uint32_t size = 0;
+	uint32_t metadata = NO_SPACE; // noeud interne, nécessaire pour Free()
+};
+
+struct OffsetAllocatorReport
+{
+	uint32_t totalFree = 0;
+	uint32_t largestFree = 0;
+	uint32_t freeRegions = 0;
+};
+
+// Allocateur d'offsets de type TLSF (two-level segregated fit) : les régions libres sont
+// rangées dans 256 classes de taille (5 bits d'exposant, 3 bits de mantisse) repérées par
+// deux niveaux de bitmasks, ce qui donne une allocation et une libération en O(1).
+// Les voisins libres sont fusionnés à la libération.
+class OffsetAllocator
+{
+public:
+	explicit OffsetAllocator(uint32_t size = 0);
+
+	void Reset(uint32_t size);
+	// Étend l'espace géré ; la nouvelle région est fusionnée avec la dernière si elle est libre
+	void Grow(uint32_t newSize);
+
+	OffsetAllocation Allocate(uint32_t size);
+	void Free(const OffsetAllocation& allocation);
+
+	uint32_t GetSize() const { return m_Size; }
+	uint32_t GetUsed() const { return m_Size - m_FreeStorage; }
+	OffsetAllocatorReport GetReport() const;
+
+private:
+	static const uint32_t NUM_TOP_BINS = 32;
+	static const uint32_t BINS_PER_LEAF = 8;
+	static const uint32_t NUM_LEAF_BINS = NUM_TOP_BINS * BINS_PER_LEAF;
+	static const uint32_t UNUSED = 0xFFFFFFFF;
+
+	struct Node
+	{
+		uint32_t offset = 0;
+		uint32_t size = 0;
+		uint32_t binListPrev = UNUSED;
+		uint32_t binListNext = UNUSED;
+		uint32_t neighborPrev = UNUSED;
+		uint32_t neighborNext = UNUSED;
+		bool used = false;
+	};
+
+	uint32_t InsertNodeIntoBin(uint32_t size, uint32_t offset);
+	void RemoveNodeFromBin(uint32_t nodeIndex);
+	uint32_t NewNode();
+
+	uint32_t m_Size;
+	uint32_t m_FreeStorage;
+	uint32_t m_LastNode; // noeud de plus haute adresse, pour Grow()
+	uint32_t m_UsedBinsTop;
+	uint8_t m_UsedBins[NUM_TOP_BINS];
+	uint32_t m_BinIndices[NUM_LEAF_BINS];
+	std::vector<Node> m_Nodes;
+	std::vector<uint32_t> m_FreeNodes;
+};
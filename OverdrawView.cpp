@@ -0,0 +1,113 @@
+#include "OverdrawView.h"
+#include "GLPlatform.h"
+
+namespace
+{
+	// Palette du nombre de fragments par pixel, de 0 à LEVEL_COUNT - 1 et plus
+	const float LEVEL_COLORS[OverdrawView::LEVEL_COUNT][3] = {
+		{ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.8f }, { 0.0f, 0.6f, 1.0f },
+		{ 0.0f, 0.8f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { 1.0f, 0.5f, 0.0f },
+		{ 1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f }
+	};
+}
+
+OverdrawView::OverdrawView()
+	: m_Vao(0), m_Next(0), m_Counting(false), m_FragmentsPerPixel(0.0f)
+{
+	for (int i = 0; i < QUERY_COUNT; ++i)
+	{
+		m_Queries[i] = 0;
+		m_QuerySamples[i] = 0;
+	}
+}
+
+bool OverdrawView::Create()
+{
+	m_Shader.LoadVertexShader("shaders/fullscreen.vs");
+	m_Shader.LoadFragmentShader("shaders/overdraw.fs");
+	if (!m_Shader.Create())
+		return false;
+	glGenVertexArrays(1, &m_Vao);
+	glGenQueries(QUERY_COUNT, m_Queries);
+	return true;
+}
+
+void OverdrawView::Destroy()
+{
+	m_Shader.Destroy();
+	glDeleteVertexArrays(1, &m_Vao);
+	glDeleteQueries(QUERY_COUNT, m_Queries);
+	m_Vao = 0;
+	for (int i = 0; i < QUERY_COUNT; ++i)
+	{
+		m_Queries[i] = 0;
+		m_QuerySamples[i] = 0;
+	}
+}
+
+void OverdrawView::CollectResults()
+{
+	// Des plus anciennes aux plus récentes : la dernière disponible l'emporte
+	for (int k = 0; k < QUERY_COUNT; ++k)
+	{
+		int i = (m_Next + k) % QUERY_COUNT;
+		if (m_QuerySamples[i] == 0)
+			continue;
+		GLint available = 0;
+		glGetQueryObjectiv(m_Queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+		GLuint64 fragments = 0;
+		glGetQueryObjectui64v(m_Queries[i], GL_QUERY_RESULT, &fragments);
+		m_FragmentsPerPixel = (float)((double)fragments / (double)m_QuerySamples[i]);
+		m_QuerySamples[i] = 0;
+	}
+}
+
+void OverdrawView::Begin(int width, int height, int samples)
+{
+	CollectResults();
+	glEnable(GL_STENCIL_TEST);
+	glStencilFunc(GL_ALWAYS, 0, 0xFF);
+	glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+
+	// Toutes les requêtes attendent encore le GPU : pas de mesure cette frame
+	m_Counting = m_QuerySamples[m_Next] == 0;
+	if (m_Counting)
+	{
+		glBeginQuery(GL_SAMPLES_PASSED, m_Queries[m_Next]);
+		m_QuerySamples[m_Next] = (uint64_t)width * height * (samples > 1 ? samples : 1);
+	}
+}
+
+void OverdrawView::End()
+{
+	if (m_Counting)
+	{
+		glEndQuery(GL_SAMPLES_PASSED);
+		m_Next = (m_Next + 1) % QUERY_COUNT;
+		m_Counting = false;
+	}
+	glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+	glDisable(GL_STENCIL_TEST);
+}
+
+void OverdrawView::Draw()
+{
+	uint32_t program = m_Shader.GetProgram();
+	GLint colorLocation = glGetUniformLocation(program, "u_color");
+	glUseProgram(program);
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_STENCIL_TEST);
+	glBindVertexArray(m_Vao);
+	for (int level = 0; level < LEVEL_COUNT; ++level)
+	{
+		// Dernier niveau : tous les pixels dont le compteur l'atteint ou le dépasse
+		glStencilFunc(level == LEVEL_COUNT - 1 ? GL_LEQUAL : GL_EQUAL, level, 0xFF);
+		glUniform3fv(colorLocation, 1, LEVEL_COLORS[level]);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+	glDisable(GL_STENCIL_TEST);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "GLShader.h"
+
+#include <cstdint>
+
+// Vue de surdessin : nombre de fragments ombrés par pixel dans la passe de scène.
+// - Begin/End encadrent les dessins en couleur : chaque fragment qui passe le test de profondeur
+//   incrémente le stencil (GL_INCR, saturé à 255) et une requête GL_SAMPLES_PASSED les compte ;
+// - Draw remplace la couleur par une palette (noir : aucun, bleu : 1, ... blanc : LEVEL_COUNT - 1
+//   et plus), un triangle plein écran par niveau sélectionné par le test de stencil.
+// Les requêtes sont relues sans attente, quelques frames plus tard.
+class OverdrawView
+{
+public:
+	static const int LEVEL_COUNT = 9;
+	static const int QUERY_COUNT = 4;
+
+	OverdrawView();
+
+	bool Create();
+	void Destroy();
+
+	// Sur le framebuffer de scène lié (profondeur et stencil effacés) ; samples : échantillons MSAA
+	void Begin(int width, int height, int samples);
+	void End();
+	// Vers le framebuffer lié, zone [0, width] x [0, height] du viewport courant
+	void Draw();
+
+	// Dernière mesure disponible : fragments ombrés par pixel (0 avant le premier résultat)
+	float GetFragmentsPerPixel() const { return m_FragmentsPerPixel; }
+
+private:
+	void CollectResults();
+
+	GLShader m_Shader;
+	uint32_t m_Vao;                       // vide : triangle plein écran (shaders/fullscreen.vs)
+	uint32_t m_Queries[QUERY_COUNT];
+	uint64_t m_QuerySamples[QUERY_COUNT]; // pixels x échantillons couverts, 0 : requête libre
+	int m_Next;
+	bool m_Counting;
+	float m_FragmentsPerPixel;
+};
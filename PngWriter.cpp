@@ -0,0 +1,108 @@
+#include "PngWriter.h"
+
+#include <stdio.h>
+#include <vector>
+
+static uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc)
+{
+	static uint32_t table[256];
+	static bool tableReady = false;
+	if (!tableReady)
+	{
+		for (uint32_t n = 0; n < 256; ++n)
+		{
+			uint32_t c = n;
+			for (int k = 0; k < 8; ++k)
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			table[n] = c;
+		}
+		tableReady = true;
+	}
+	crc = ~crc;
+	for (size_t i = 0; i < size; ++i)
+		crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+	return ~crc;
+}
+
+static void PutU32(std::vector<uint8_t>& out, uint32_t value)
+{
+	out.push_back((uint8_t)(value >> 24));
+	out.push_back((uint8_t)(value >> 16));
+	out.push_back((uint8_t)(value >> 8));
+	out.push_back((uint8_t)value);
+}
+
+static void WriteChunk(FILE* file, const char* type, const std::vector<uint8_t>& data)
+{
+	std::vector<uint8_t> chunk;
+	PutU32(chunk, (uint32_t)data.size());
+	chunk.insert(chunk.end(), type, type + 4);
+	chunk.insert(chunk.end(), data.begin(), data.end());
+	// Le CRC couvre le type et les données, pas la longueur
+	PutU32(chunk, Crc32(chunk.data() + 4, chunk.size() - 4, 0));
+	fwrite(chunk.data(), 1, chunk.size(), file);
+}
+
+bool WritePng(const char* path, int width, int height, const uint8_t* rgba, bool flipY)
+{
+	FILE* file = fopen(path, "wb");
+	if (!file)
+		return false;
+
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	fwrite(signature, 1, sizeof(signature), file);
+
+	std::vector<uint8_t> header;
+	PutU32(header, (uint32_t)width);
+	PutU32(header, (uint32_t)height);
+	header.push_back(8);  // bits par composante
+	header.push_back(6);  // RGBA
+	header.push_back(0);  // deflate
+	header.push_back(0);  // filtrage adaptatif
+	header.push_back(0);  // non entrelacé
+	WriteChunk(file, "IHDR", header);
+
+	// Lignes brutes précédées de leur octet de filtre (0 : aucun)
+	size_t rowSize = (size_t)width * 4;
+	std::vector<uint8_t> raw;
+	raw.reserve((rowSize + 1) * height);
+	for (int y = 0; y < height; ++y)
+	{
+		const uint8_t* row = rgba + rowSize * (flipY ? height - 1 - y : y);
+		raw.push_back(0);
+		raw.insert(raw.end(), row, row + rowSize);
+	}
+
+	// Flux zlib en blocs stored de 65535 octets au plus, suivi de l'Adler-32
+	std::vector<uint8_t> zlib;
+	zlib.reserve(raw.size() + raw.size() / 65535 * 5 + 16);
+	zlib.push_back(0x78);
+	zlib.push_back(0x01);
+	size_t offset = 0;
+	do
+	{
+		size_t blockSize = raw.size() - offset < 65535 ? raw.size() - offset : 65535;
+		bool last = offset + blockSize == raw.size();
+		zlib.push_back(last ? 1 : 0);
+		zlib.push_back((uint8_t)blockSize);
+		zlib.push_back((uint8_t)(blockSize >> 8));
+		zlib.push_back((uint8_t)~blockSize);
+		zlib.push_back((uint8_t)(~blockSize >> 8));
+		zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+		offset += blockSize;
+	} while (offset < raw.size());
+
+	uint32_t a = 1, b = 0;
+	for (size_t i = 0; i < raw.size(); ++i)
+	{
+		a = (a + raw[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	PutU32(zlib, (b << 16) | a);
+	WriteChunk(file, "IDAT", zlib);
+	WriteChunk(file, "IEND", std::vector<uint8_t>());
+
+	bool ok = ferror(file) == 0;
+	fclose(file);
+	return ok;
+}
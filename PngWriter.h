@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Écrit une image RGBA 8 bits en PNG. Les données zlib ne sont pas compressées (blocs
+// "stored") : fichiers plus gros, mais aucune dépendance. flipY : lignes dans l'ordre
+// OpenGL (la première ligne est en bas de l'image).
+bool WritePng(const char* path, int width, int height, const uint8_t* rgba, bool flipY);
@@ -0,0 +1,539 @@
+#include "RenderGraph.h"
+#include "GLPlatform.h"
+#include "Trace.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	bool IsDepthFormat(uint32_t format)
+	{
+		return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8 ||
+			format == GL_DEPTH_COMPONENT16 || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F;
+	}
+
+	bool HasStencil(uint32_t format)
+	{
+		return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+	}
+
+	bool IsFloatFormat(uint32_t format)
+	{
+		return format == GL_RGBA16F || format == GL_RGB16F || format == GL_RG16F || format == GL_R16F ||
+			format == GL_RGBA32F || format == GL_RG32F || format == GL_R32F || format == GL_R11F_G11F_B10F;
+	}
+
+	int SampleCount(const RenderGraph::TextureDesc& desc)
+	{
+		return desc.samples > 1 ? desc.samples : 1;
+	}
+
+	// Taille d'un texel une fois alloué (RGB8 est complété à 4 octets par les pilotes)
+	uint32_t BytesPerTexel(uint32_t format)
+	{
+		switch (format)
+		{
+		case GL_R8: return 1;
+		case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16: return 2;
+		case GL_RGBA16F: case GL_RGB16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8: return 8;
+		case GL_RGBA32F: return 16;
+		default: return 4;
+		}
+	}
+
+	uint64_t TextureBytes(const RenderGraph::TextureDesc& desc)
+	{
+		return (uint64_t)desc.width * desc.height * BytesPerTexel(desc.format) * SampleCount(desc);
+	}
+
+	bool SameDesc(const RenderGraph::TextureDesc& a, const RenderGraph::TextureDesc& b)
+	{
+		return a.width == b.width && a.height == b.height && a.format == b.format && SampleCount(a) == SampleCount(b);
+	}
+
+	const uint32_t RENDERBUFFER_BIT = 0x80000000u;
+
+	// FNV-1a
+	void HashBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= 1099511628211ull;
+		}
+	}
+
+	template <typename T>
+	void HashValue(uint64_t& hash, const T& value)
+	{
+		HashBytes(hash, &value, sizeof(value));
+	}
+}
+
+void RenderGraph::Destroy()
+{
+	for (size_t i = 0; i < m_Framebuffers.size(); ++i)
+		glDeleteFramebuffers(1, &m_Framebuffers[i].framebuffer);
+	for (size_t i = 0; i < m_Textures.size(); ++i)
+	{
+		if (m_Textures[i].desc.samples > 1)
+			glDeleteRenderbuffers(1, &m_Textures[i].texture);
+		else
+			glDeleteTextures(1, &m_Textures[i].texture);
+	}
+	m_Framebuffers.clear();
+	m_Textures.clear();
+	m_Resources.clear();
+	m_Passes.clear();
+	m_PassCount = 0;
+	m_Compiled = false;
+	m_Stats = Stats();
+}
+
+void RenderGraph::Reset()
+{
+	m_Resources.clear();
+	m_PassCount = 0;
+}
+
+RenderGraph::Resource RenderGraph::CreateTexture(const char* name, const TextureDesc& desc)
+{
+	ResourceNode node = { name, desc, false, 0, 0 };
+	m_Resources.push_back(node);
+	return (Resource)(m_Resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::ImportFramebuffer(const char* name, uint32_t framebuffer, int width, int height)
+{
+	TextureDesc desc = { width, height, 0, 1 };
+	ResourceNode node = { name, desc, true, framebuffer, 0 };
+	m_Resources.push_back(node);
+	return (Resource)(m_Resources.size() - 1);
+}
+
+RenderGraph::Resource RenderGraph::ImportTexture(const char* name, uint32_t texture, const TextureDesc& desc, uint32_t framebuffer)
+{
+	ResourceNode node = { name, desc, true, framebuffer, texture };
+	m_Resources.push_back(node);
+	return (Resource)(m_Resources.size() - 1);
+}
+
+RenderGraph::Pass RenderGraph::AddPass(const char* name, PassFunction function, void* user)
+{
+	if (m_PassCount == m_Passes.size())
+		m_Passes.push_back(PassNode());
+	PassNode& pass = m_Passes[m_PassCount];
+	pass.name = name;
+	pass.function = function;
+	pass.user = user;
+	pass.reads.clear();
+	pass.writes.clear();
+	pass.storageWrites.clear();
+	pass.framebufferReads.clear();
+	return (Pass)(m_PassCount++);
+}
+
+void RenderGraph::Read(Pass pass, Resource resource)
+{
+	m_Passes[pass].reads.push_back(resource);
+}
+
+void RenderGraph::Write(Pass pass, Resource resource)
+{
+	m_Passes[pass].writes.push_back(resource);
+}
+
+void RenderGraph::WriteStorage(Pass pass, Resource resource)
+{
+	m_Passes[pass].storageWrites.push_back(resource);
+}
+
+void RenderGraph::ReadFramebuffer(Pass pass, Resource resource)
+{
+	m_Passes[pass].reads.push_back(resource);
+	m_Passes[pass].framebufferReads.push_back(resource);
+}
+
+uint64_t RenderGraph::ComputeKey() const
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < m_Resources.size(); ++i)
+	{
+		const ResourceNode& resource = m_Resources[i];
+		HashValue(hash, resource.desc.width);
+		HashValue(hash, resource.desc.height);
+		HashValue(hash, resource.desc.format);
+		HashValue(hash, SampleCount(resource.desc));
+		HashValue(hash, resource.imported);
+		// Identifiants des ressources importées relus par Execute et GetTexture
+		HashValue(hash, resource.framebuffer != 0);
+	}
+	for (size_t i = 0; i < m_PassCount; ++i)
+	{
+		const PassNode& pass = m_Passes[i];
+		HashBytes(hash, pass.name, strlen(pass.name));
+		HashValue(hash, pass.reads.size());
+		if (!pass.reads.empty())
+			HashBytes(hash, pass.reads.data(), pass.reads.size() * sizeof(Resource));
+		HashValue(hash, pass.writes.size());
+		if (!pass.writes.empty())
+			HashBytes(hash, pass.writes.data(), pass.writes.size() * sizeof(Resource));
+		HashValue(hash, pass.storageWrites.size());
+		if (!pass.storageWrites.empty())
+			HashBytes(hash, pass.storageWrites.data(), pass.storageWrites.size() * sizeof(Resource));
+		HashValue(hash, pass.framebufferReads.size());
+		if (!pass.framebufferReads.empty())
+			HashBytes(hash, pass.framebufferReads.data(), pass.framebufferReads.size() * sizeof(Resource));
+	}
+	return hash;
+}
+
+int RenderGraph::AcquireTexture(const TextureDesc& desc, std::vector<int>& available)
+{
+	for (size_t i = 0; i < available.size(); ++i)
+	{
+		int index = available[i];
+		if (SameDesc(m_Textures[index].desc, desc))
+		{
+			available[i] = available.back();
+			available.pop_back();
+			m_Textures[index].used = true;
+			return index;
+		}
+	}
+
+	PhysicalTexture physical;
+	physical.desc = desc;
+	physical.used = true;
+	if (desc.samples > 1)
+	{
+		glGenRenderbuffers(1, &physical.texture);
+		glBindRenderbuffer(GL_RENDERBUFFER, physical.texture);
+		glRenderbufferStorageMultisample(GL_RENDERBUFFER, desc.samples, desc.format, desc.width, desc.height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+		m_Textures.push_back(physical);
+		return (int)(m_Textures.size() - 1);
+	}
+	glGenTextures(1, &physical.texture);
+	glBindTexture(GL_TEXTURE_2D, physical.texture);
+	if (IsDepthFormat(desc.format))
+	{
+		GLenum format = HasStencil(desc.format) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT;
+		GLenum type = desc.format == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8 :
+			desc.format == GL_DEPTH32F_STENCIL8 ? GL_FLOAT_32_UNSIGNED_INT_24_8_REV : GL_FLOAT;
+		glTexImage2D(GL_TEXTURE_2D, 0, desc.format, desc.width, desc.height, 0, format, type, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	}
+	else
+	{
+		GLenum type = IsFloatFormat(desc.format) ? GL_FLOAT : GL_UNSIGNED_BYTE;
+		glTexImage2D(GL_TEXTURE_2D, 0, desc.format, desc.width, desc.height, 0, GL_RGBA, type, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	m_Textures.push_back(physical);
+	return (int)(m_Textures.size() - 1);
+}
+
+uint32_t RenderGraph::AcquireFramebuffer(const std::vector<Resource>& targets, const char* passName)
+{
+	std::vector<uint32_t> attachments;
+	uint32_t depth = 0;
+	uint32_t depthFormat = 0;
+	for (size_t i = 0; i < targets.size(); ++i)
+	{
+		const ResourceNode& resource = m_Resources[targets[i]];
+		if (resource.imported)
+			return resource.framebuffer;
+		const PhysicalTexture& physical = m_Textures[m_ResourceTexture[targets[i]]];
+		uint32_t texture = physical.texture | (physical.desc.samples > 1 ? RENDERBUFFER_BIT : 0);
+		if (IsDepthFormat(resource.desc.format))
+		{
+			depth = texture;
+			depthFormat = resource.desc.format;
+		}
+		else
+			attachments.push_back(texture);
+	}
+	attachments.push_back(depth);
+
+	for (size_t i = 0; i < m_Framebuffers.size(); ++i)
+	{
+		if (m_Framebuffers[i].attachments == attachments)
+		{
+			m_Framebuffers[i].used = true;
+			return m_Framebuffers[i].framebuffer;
+		}
+	}
+
+	Framebuffer entry;
+	entry.attachments = attachments;
+	entry.used = true;
+	glGenFramebuffers(1, &entry.framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, entry.framebuffer);
+	GLenum drawBuffers[8];
+	GLsizei colorCount = 0;
+	for (size_t i = 0; i + 1 < attachments.size() && colorCount < 8; ++i)
+	{
+		GLenum attachment = GL_COLOR_ATTACHMENT0 + colorCount;
+		if (attachments[i] & RENDERBUFFER_BIT)
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, attachments[i] & ~RENDERBUFFER_BIT);
+		else
+			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, attachments[i], 0);
+		drawBuffers[colorCount] = attachment;
+		colorCount++;
+	}
+	if (depth != 0)
+	{
+		GLenum attachment = HasStencil(depthFormat) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+		if (depth & RENDERBUFFER_BIT)
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, depth & ~RENDERBUFFER_BIT);
+		else
+			glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, depth, 0);
+	}
+	if (colorCount > 0)
+	{
+		glDrawBuffers(colorCount, drawBuffers);
+		glReadBuffer(GL_COLOR_ATTACHMENT0);
+	}
+	else
+	{
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+	}
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		fprintf(stderr, "RenderGraph: framebuffer incomplet pour la passe %s\n", passName);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	m_Framebuffers.push_back(entry);
+	return entry.framebuffer;
+}
+
+void RenderGraph::Compile()
+{
+	uint64_t key = ComputeKey();
+	if (m_Compiled && key == m_CompiledKey)
+		return;
+	TRACE_SCOPE("RenderGraph::Compile");
+
+	const size_t passCount = m_PassCount;
+	const size_t resourceCount = m_Resources.size();
+
+	// Compteurs de références : lectures par ressource, écritures par passe
+	std::vector<int> resourceRefs(resourceCount, 0);
+	std::vector<int> passRefs(passCount, 0);
+	std::vector<uint8_t> sideEffect(passCount, 0);
+	for (size_t p = 0; p < passCount; ++p)
+	{
+		const PassNode& pass = m_Passes[p];
+		for (size_t i = 0; i < pass.reads.size(); ++i)
+			resourceRefs[pass.reads[i]]++;
+		passRefs[p] = (int)(pass.writes.size() + pass.storageWrites.size());
+		for (size_t i = 0; i < pass.writes.size(); ++i)
+		{
+			if (m_Resources[pass.writes[i]].imported)
+				sideEffect[p] = 1;
+		}
+		for (size_t i = 0; i < pass.storageWrites.size(); ++i)
+		{
+			if (m_Resources[pass.storageWrites[i]].imported)
+				sideEffect[p] = 1;
+		}
+	}
+
+	// Élimination : une ressource jamais lue ne justifie pas ses écritures ; une passe dont
+	// toutes les écritures sont inutiles disparaît et libère à son tour ce qu'elle lisait
+	std::vector<Resource> unreferenced;
+	for (size_t r = 0; r < resourceCount; ++r)
+	{
+		if (resourceRefs[r] == 0 && !m_Resources[r].imported)
+			unreferenced.push_back((Resource)r);
+	}
+	m_PassCulled.assign(passCount, 0);
+	while (!unreferenced.empty())
+	{
+		Resource resource = unreferenced.back();
+		unreferenced.pop_back();
+		for (size_t p = 0; p < passCount; ++p)
+		{
+			const PassNode& pass = m_Passes[p];
+			if (m_PassCulled[p] || sideEffect[p])
+				continue;
+			size_t writeCount = pass.writes.size() + pass.storageWrites.size();
+			for (size_t i = 0; i < writeCount; ++i)
+			{
+				Resource written = i < pass.writes.size() ? pass.writes[i] : pass.storageWrites[i - pass.writes.size()];
+				if (written == resource && --passRefs[p] == 0)
+				{
+					m_PassCulled[p] = 1;
+					for (size_t j = 0; j < pass.reads.size(); ++j)
+					{
+						Resource read = pass.reads[j];
+						if (--resourceRefs[read] == 0 && !m_Resources[read].imported)
+							unreferenced.push_back(read);
+					}
+				}
+			}
+		}
+	}
+
+	// Durées de vie dans l'ordre d'exécution (celui de la déclaration), et barrières après les
+	// écritures par image, qui ne sont pas ordonnées avec les accès suivants sans glMemoryBarrier
+	std::vector<int> firstUse(resourceCount, -1);
+	std::vector<int> lastUse(resourceCount, -1);
+	std::vector<uint8_t> storageWritten(resourceCount, 0);
+	m_PassBarrier.assign(passCount, 0);
+	for (size_t p = 0; p < passCount; ++p)
+	{
+		if (m_PassCulled[p])
+			continue;
+		const PassNode& pass = m_Passes[p];
+		for (int access = 0; access < 3; ++access)
+		{
+			const std::vector<Resource>& list = access == 0 ? pass.reads : (access == 1 ? pass.writes : pass.storageWrites);
+			for (size_t i = 0; i < list.size(); ++i)
+			{
+				if (firstUse[list[i]] < 0)
+					firstUse[list[i]] = (int)p;
+				lastUse[list[i]] = (int)p;
+				if (storageWritten[list[i]])
+					m_PassBarrier[p] = 1;
+			}
+		}
+		for (size_t i = 0; i < pass.writes.size(); ++i)
+			storageWritten[pass.writes[i]] = 0;
+		for (size_t i = 0; i < pass.storageWrites.size(); ++i)
+			storageWritten[pass.storageWrites[i]] = 1;
+	}
+
+	// Aliasing : une texture physique revient dans le pool après la dernière passe qui l'utilise.
+	// Toutes les textures de la compilation précédente sont candidates.
+	std::vector<int> available;
+	for (size_t i = 0; i < m_Textures.size(); ++i)
+	{
+		m_Textures[i].used = false;
+		available.push_back((int)i);
+	}
+	m_ResourceTexture.assign(resourceCount, -1);
+	for (size_t p = 0; p < passCount; ++p)
+	{
+		if (m_PassCulled[p])
+			continue;
+		for (size_t r = 0; r < resourceCount; ++r)
+		{
+			if (firstUse[r] == (int)p && !m_Resources[r].imported)
+				m_ResourceTexture[r] = AcquireTexture(m_Resources[r].desc, available);
+		}
+		for (size_t r = 0; r < resourceCount; ++r)
+		{
+			if (lastUse[r] == (int)p && m_ResourceTexture[r] >= 0)
+				available.push_back(m_ResourceTexture[r]);
+		}
+	}
+
+	// Framebuffers des passes
+	for (size_t i = 0; i < m_Framebuffers.size(); ++i)
+		m_Framebuffers[i].used = false;
+	m_PassFramebuffer.assign(passCount, 0);
+	m_PassReadFramebuffer.assign(passCount, 0);
+	for (size_t p = 0; p < passCount; ++p)
+	{
+		if (m_PassCulled[p])
+			continue;
+		const PassNode& pass = m_Passes[p];
+		if (!pass.writes.empty())
+			m_PassFramebuffer[p] = AcquireFramebuffer(pass.writes, pass.name);
+		if (!pass.framebufferReads.empty())
+			m_PassReadFramebuffer[p] = AcquireFramebuffer(pass.framebufferReads, pass.name);
+	}
+
+	// Libération de ce que cette compilation n'utilise plus (taille précédente, passe retirée...)
+	for (size_t i = 0; i < m_Framebuffers.size();)
+	{
+		if (!m_Framebuffers[i].used)
+		{
+			glDeleteFramebuffers(1, &m_Framebuffers[i].framebuffer);
+			m_Framebuffers[i] = m_Framebuffers.back();
+			m_Framebuffers.pop_back();
+		}
+		else
+			++i;
+	}
+	std::vector<int> remap(m_Textures.size(), -1);
+	size_t kept = 0;
+	for (size_t i = 0; i < m_Textures.size(); ++i)
+	{
+		if (m_Textures[i].used)
+		{
+			remap[i] = (int)kept;
+			m_Textures[kept++] = m_Textures[i];
+		}
+		else if (m_Textures[i].desc.samples > 1)
+			glDeleteRenderbuffers(1, &m_Textures[i].texture);
+		else
+			glDeleteTextures(1, &m_Textures[i].texture);
+	}
+	m_Textures.resize(kept);
+	for (size_t r = 0; r < resourceCount; ++r)
+	{
+		if (m_ResourceTexture[r] >= 0)
+			m_ResourceTexture[r] = remap[m_ResourceTexture[r]];
+	}
+
+	m_Compiles++;
+	m_Stats = Stats();
+	m_Stats.passes = (int)passCount;
+	for (size_t p = 0; p < passCount; ++p)
+		m_Stats.culledPasses += m_PassCulled[p];
+	for (size_t r = 0; r < resourceCount; ++r)
+	{
+		if (m_Resources[r].imported)
+			continue;
+		m_Stats.transientTextures++;
+		m_Stats.transientBytes += TextureBytes(m_Resources[r].desc);
+	}
+	m_Stats.physicalTextures = (int)m_Textures.size();
+	for (size_t i = 0; i < m_Textures.size(); ++i)
+		m_Stats.physicalBytes += TextureBytes(m_Textures[i].desc);
+	m_Stats.framebuffers = (int)m_Framebuffers.size();
+	m_Stats.compiles = m_Compiles;
+
+	m_CompiledKey = key;
+	m_Compiled = true;
+}
+
+void RenderGraph::Execute()
+{
+	for (size_t p = 0; p < m_PassCount; ++p)
+	{
+		if (m_PassCulled[p])
+			continue;
+		const PassNode& pass = m_Passes[p];
+		TRACE_SCOPE(pass.name);
+#ifdef GL_VERSION_4_2
+		if (m_PassBarrier[p])
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT);
+#endif
+		if (!pass.writes.empty())
+		{
+			const ResourceNode& target = m_Resources[pass.writes[0]];
+			glBindFramebuffer(GL_FRAMEBUFFER, target.imported ? target.framebuffer : m_PassFramebuffer[p]);
+		}
+		if (!pass.framebufferReads.empty())
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, m_PassReadFramebuffer[p]);
+		pass.function(*this, pass.user);
+	}
+}
+
+uint32_t RenderGraph::GetTexture(Resource resource) const
+{
+	if (m_Resources[resource].imported)
+		return m_Resources[resource].texture;
+	int index = m_ResourceTexture[resource];
+	return index >= 0 && m_Textures[index].desc.samples <= 1 ? m_Textures[index].texture : 0;
+}
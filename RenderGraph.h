@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Graphe de rendu d'une frame. Chaque frame, les passes sont déclarées dans l'ordre de
+// soumission avec les textures qu'elles lisent et écrivent, puis le graphe est compilé :
+// - élimination des passes dont aucune sortie n'est lue (compteurs de références, en remontant
+//   depuis les framebuffers importés, qui sont les sorties de la frame) ;
+// - durée de vie de chaque texture transitoire (première et dernière passe qui l'utilisent) ;
+// - aliasing : deux textures de même description dont les durées de vie ne se chevauchent pas
+//   partagent la même texture GL, prise dans un pool conservé d'une frame à l'autre ;
+// - un FBO par combinaison d'attachements, gardé en cache.
+// Une cible multiéchantillonnée (samples > 1) est un renderbuffer : elle n'est pas lue comme
+// texture, mais résolue par une passe qui la lit à travers un framebuffer (glBlitFramebuffer).
+// Le résultat est réutilisé tel quel tant que la déclaration (passes, accès, descriptions) ne
+// change pas ; un redimensionnement recompile et libère les textures devenues inutiles.
+class RenderGraph
+{
+public:
+	typedef uint32_t Resource;
+	typedef uint32_t Pass;
+	static const uint32_t INVALID = 0xFFFFFFFFu;
+
+	struct TextureDesc
+	{
+		int width;
+		int height;
+		uint32_t format;   // format interne GL (GL_RGB8, GL_RGBA16F, GL_DEPTH24_STENCIL8...)
+		int samples;       // 1 : texture ; au-delà, renderbuffer MSAA (toujours donné : agrégat C++11)
+	};
+
+	// Corps d'une passe : le framebuffer de ses écritures est déjà lié (et celui de ses lectures
+	// par framebuffer, sur GL_READ_FRAMEBUFFER)
+	typedef void (*PassFunction)(RenderGraph& graph, void* user);
+
+	struct Stats
+	{
+		int passes = 0;
+		int culledPasses = 0;
+		int transientTextures = 0;
+		int physicalTextures = 0;
+		uint64_t transientBytes = 0;   // somme des textures déclarées, sans aliasing
+		uint64_t physicalBytes = 0;    // mémoire réellement allouée
+		int framebuffers = 0;
+		uint32_t compiles = 0;         // compilations complètes (hors cache)
+	};
+
+	RenderGraph() : m_PassCount(0), m_CompiledKey(0), m_Compiled(false), m_Compiles(0) {}
+
+	void Destroy();
+
+	// Déclaration de la frame, à refaire à chaque frame avant Compile et Execute
+	void Reset();
+	Resource CreateTexture(const char* name, const TextureDesc& desc);
+	// Framebuffer existant (0 : celui de la fenêtre) ; les passes qui y écrivent ne sont jamais éliminées
+	Resource ImportFramebuffer(const char* name, uint32_t framebuffer, int width, int height);
+	// Texture persistante (conservée d'une frame à l'autre) : lue, écrite par image, ou écrite en
+	// attachement par le framebuffer donné (dont elle est la seule cible) ; comme un framebuffer
+	// importé, c'est une sortie de la frame. Les identifiants GL des ressources importées ne font pas
+	// partie de la déclaration compilée : échanger deux historiques chaque frame ne recompile rien.
+	Resource ImportTexture(const char* name, uint32_t texture, const TextureDesc& desc, uint32_t framebuffer = 0);
+	Pass AddPass(const char* name, PassFunction function, void* user);
+	void Read(Pass pass, Resource resource);
+	// Attachement couleur (dans l'ordre des appels) ou profondeur, selon le format. Une passe écrit
+	// soit dans des textures transitoires, soit dans un framebuffer importé.
+	void Write(Pass pass, Resource resource);
+	// Écriture par image (imageStore d'un compute shader) : pas d'attachement ni de FBO. Le graphe
+	// place une barrière mémoire avant la passe suivante qui utilise la texture.
+	void WriteStorage(Pass pass, Resource resource);
+	// Lecture à travers un framebuffer (glBlitFramebuffer, glReadPixels) : toutes les ressources lues
+	// ainsi par une passe sont attachées à un même FBO, lié sur GL_READ_FRAMEBUFFER avant la passe
+	void ReadFramebuffer(Pass pass, Resource resource);
+
+	void Compile();
+	void Execute();
+
+	// Pendant Execute : texture GL d'une ressource transitoire ou importée (0 pour un renderbuffer)
+	uint32_t GetTexture(Resource resource) const;
+	const TextureDesc& GetDesc(Resource resource) const { return m_Resources[resource].desc; }
+	bool IsCulled(Pass pass) const { return m_PassCulled[pass] != 0; }
+
+	const Stats& GetStats() const { return m_Stats; }
+
+private:
+	struct ResourceNode
+	{
+		const char* name;
+		TextureDesc desc;
+		bool imported;
+		uint32_t framebuffer;    // framebuffer importé, ou celui de la texture importée
+		uint32_t texture;        // texture importée
+	};
+
+	struct PassNode
+	{
+		const char* name;
+		PassFunction function;
+		void* user;
+		std::vector<Resource> reads;
+		std::vector<Resource> writes;
+		std::vector<Resource> storageWrites;
+		std::vector<Resource> framebufferReads;
+	};
+
+	struct PhysicalTexture
+	{
+		TextureDesc desc;
+		uint32_t texture;        // ou renderbuffer, si desc.samples > 1
+		bool used;               // attribuée par la dernière compilation
+	};
+
+	struct Framebuffer
+	{
+		// Couleurs puis profondeur (0 si absente) ; bit de poids fort pour un renderbuffer
+		std::vector<uint32_t> attachments;
+		uint32_t framebuffer;
+		bool used;
+	};
+
+	uint64_t ComputeKey() const;
+	int AcquireTexture(const TextureDesc& desc, std::vector<int>& available);
+	uint32_t AcquireFramebuffer(const std::vector<Resource>& targets, const char* passName);
+
+	std::vector<ResourceNode> m_Resources;
+	std::vector<PassNode> m_Passes;
+	size_t m_PassCount;          // passes déclarées cette frame (m_Passes garde ses tableaux)
+
+	// Résultat de la dernière compilation
+	uint64_t m_CompiledKey;
+	bool m_Compiled;
+	std::vector<uint8_t> m_PassCulled;
+	std::vector<uint32_t> m_PassFramebuffer;
+	std::vector<uint32_t> m_PassReadFramebuffer;
+	std::vector<uint8_t> m_PassBarrier;    // lit ou réécrit une texture écrite par image
+	std::vector<int> m_ResourceTexture;    // indice dans m_Textures, -1 si importée ou inutilisée
+
+	std::vector<PhysicalTexture> m_Textures;
+	std::vector<Framebuffer> m_Framebuffers;
+	uint32_t m_Compiles;
+	Stats m_Stats;
+};
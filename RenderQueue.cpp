@@ -0,0 +1,255 @@
+#include "RenderQueue.h"
+#include "GLPlatform.h"
+
+uint64_t RenderQueue::MakeKey(uint32_t pass, uint32_t shader, uint32_t material,
+	uint32_t texture, uint32_t vao, uint32_t depth, bool depthFirst)
+{
+	if (depthFirst)
+	{
+		return ((uint64_t)(pass & 0xF) << 60) |
+			((uint64_t)(depth & 0xFFFF) << 44) |
+			((uint64_t)(shader & 0xFF) << 36) |
+			((uint64_t)(material & 0xFFF) << 24) |
+			((uint64_t)(texture & 0xFFF) << 12) |
+			(uint64_t)(vao & 0xFFF);
+	}
+	return ((uint64_t)(pass & 0xF) << 60) |
+		((uint64_t)(shader & 0xFF) << 52) |
+		((uint64_t)(material & 0xFFF) << 40) |
+		((uint64_t)(texture & 0xFFF) << 28) |
+		((uint64_t)(vao & 0xFFF) << 16) |
+		(uint64_t)(depth & 0xFFFF);
+}
+
+uint32_t RenderQueue::QuantizeDepth(float viewDepth, float nearZ, float farZ, bool backToFront)
+{
+	float t = (viewDepth - nearZ) / (farZ - nearZ);
+	if (t < 0.0f) t = 0.0f;
+	if (t > 1.0f) t = 1.0f;
+	uint32_t q = (uint32_t)(t * 65535.0f);
+	return backToFront ? 65535 - q : q;
+}
+
+void RenderQueue::Clear()
+{
+	m_Items.clear();
+	m_Entries.clear();
+}
+
+void RenderQueue::Submit(const DrawItem& item)
+{
+	SortEntry entry;
+	entry.key = item.key;
+	entry.index = (uint32_t)m_Items.size();
+	m_Entries.push_back(entry);
+	m_Items.push_back(item);
+}
+
+void RenderQueue::Sort()
+{
+	const size_t count = m_Entries.size();
+	if (count < 2)
+		return;
+	m_Scratch.resize(count);
+
+	// 8 passes de 8 bits, de l'octet de poids faible vers l'octet de poids fort
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		uint32_t histogram[256] = {};
+		for (size_t i = 0; i < count; ++i)
+			histogram[(m_Entries[i].key >> shift) & 0xFF]++;
+
+		// Tous les éléments partagent cet octet : la passe ne changerait rien
+		if (histogram[(m_Entries[0].key >> shift) & 0xFF] == count)
+			continue;
+
+		uint32_t offset = 0;
+		for (int b = 0; b < 256; ++b)
+		{
+			uint32_t c = histogram[b];
+			histogram[b] = offset;
+			offset += c;
+		}
+		for (size_t i = 0; i < count; ++i)
+			m_Scratch[histogram[(m_Entries[i].key >> shift) & 0xFF]++] = m_Entries[i];
+		m_Entries.swap(m_Scratch);
+	}
+}
+
+bool RenderQueue::WriteObjectData(UniformRing& ring)
+{
+	bool complete = true;
+	m_ObjectBuffer = ring.GetBuffer();
+	for (size_t i = 0; i < m_Items.size(); ++i)
+	{
+		DrawItem& item = m_Items[i];
+		item.objectOffset = ~0u;
+		ObjectBlock block;
+		block.model = item.model;
+		block.material = item.material;
+		block.padding[0] = block.padding[1] = block.padding[2] = 0;
+		if (!ring.Write(&block, sizeof(ObjectBlock), item.objectOffset))
+			complete = false;
+	}
+	return complete;
+}
+
+void RenderQueue::Flush(ProgramCallback onProgram, void* user)
+{
+	m_Stats = RenderQueueStats();
+
+	// L'état GL hors de la file est inconnu : on part d'un cache vide
+	uint32_t currentProgram = 0;
+	uint32_t currentVao = 0;
+	uint32_t activeUnit = ~0u;
+	uint32_t currentInstanceBuffer = 0;
+	struct TextureBinding { uint32_t unit, target, texture; };
+	std::vector<TextureBinding> bindings;
+
+	for (size_t i = 0; i < m_Entries.size(); ++i)
+	{
+		const DrawItem& item = m_Items[m_Entries[i].index];
+
+		if (item.program != currentProgram)
+		{
+			glUseProgram(item.program);
+			currentProgram = item.program;
+			m_Stats.programBinds++;
+			if (onProgram)
+				onProgram(item.program, user);
+		}
+		else
+		{
+			m_Stats.programBindsSaved++;
+		}
+
+		if (item.textureTarget != 0)
+		{
+			TextureBinding* binding = nullptr;
+			for (size_t b = 0; b < bindings.size(); ++b)
+			{
+				if (bindings[b].unit == item.textureUnit && bindings[b].target == item.textureTarget)
+					binding = &bindings[b];
+			}
+			if (!binding || binding->texture != item.texture)
+			{
+				if (activeUnit != item.textureUnit)
+				{
+					glActiveTexture(GL_TEXTURE0 + item.textureUnit);
+					activeUnit = item.textureUnit;
+				}
+				glBindTexture(item.textureTarget, item.texture);
+				if (binding)
+				{
+					binding->texture = item.texture;
+				}
+				else
+				{
+					TextureBinding added = { item.textureUnit, item.textureTarget, item.texture };
+					bindings.push_back(added);
+				}
+				m_Stats.textureBinds++;
+			}
+			else
+			{
+				m_Stats.textureBindsSaved++;
+			}
+		}
+
+		if (item.vao != currentVao)
+		{
+			if (currentInstanceBuffer != 0)
+				DisableInstanceAttributes();
+			glBindVertexArray(item.vao);
+			currentVao = item.vao;
+			currentInstanceBuffer = 0;
+			m_Stats.vaoBinds++;
+		}
+		else
+		{
+			m_Stats.vaoBindsSaved++;
+		}
+
+		if (Draw(item, currentInstanceBuffer))
+			m_Stats.draws++;
+	}
+	if (currentInstanceBuffer != 0)
+		DisableInstanceAttributes();
+	glBindVertexArray(0);
+}
+
+void RenderQueue::FlushDepth(uint32_t program, uint32_t instancedProgram)
+{
+	// Hors statistiques : Flush, qui suit, remet les compteurs à zéro
+	uint32_t currentProgram = 0;
+	uint32_t currentVao = 0;
+	uint32_t currentInstanceBuffer = 0;
+	for (size_t i = 0; i < m_Entries.size(); ++i)
+	{
+		const DrawItem& item = m_Items[m_Entries[i].index];
+		uint32_t depthProgram = item.instanceCount > 0 ? instancedProgram : program;
+		if (depthProgram != currentProgram)
+		{
+			glUseProgram(depthProgram);
+			currentProgram = depthProgram;
+		}
+		if (item.vao != currentVao)
+		{
+			if (currentInstanceBuffer != 0)
+				DisableInstanceAttributes();
+			glBindVertexArray(item.vao);
+			currentVao = item.vao;
+			currentInstanceBuffer = 0;
+		}
+		Draw(item, currentInstanceBuffer);
+	}
+	if (currentInstanceBuffer != 0)
+		DisableInstanceAttributes();
+	glBindVertexArray(0);
+}
+
+bool RenderQueue::Draw(const DrawItem& item, uint32_t& currentInstanceBuffer)
+{
+	// Anneau plein cette frame : il sera agrandi à la suivante
+	if (item.objectOffset == ~0u)
+		return false;
+	glBindBufferRange(GL_UNIFORM_BUFFER, UNIFORM_BINDING_OBJECT, m_ObjectBuffer, item.objectOffset, sizeof(ObjectBlock));
+
+	const void* indexOffset = (const void*)((uintptr_t)item.firstIndex * sizeof(uint32_t));
+	if (item.instanceCount > 0)
+	{
+		// Le VAO est partagé : les attributs d'instance sont redirigés vers le buffer de l'objet
+		if (item.instanceBuffer != currentInstanceBuffer)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, item.instanceBuffer);
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				glEnableVertexAttribArray(INSTANCE_ATTRIB_LOCATION + c);
+				glVertexAttribPointer(INSTANCE_ATTRIB_LOCATION + c, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (const void*)(sizeof(float) * 4 * c));
+				glVertexAttribDivisor(INSTANCE_ATTRIB_LOCATION + c, 1);
+			}
+			currentInstanceBuffer = item.instanceBuffer;
+			m_Stats.instanceBufferBinds++;
+		}
+		glDrawElementsInstancedBaseVertex(GL_TRIANGLES, item.indexCount, GL_UNSIGNED_INT, indexOffset, item.instanceCount, item.baseVertex);
+	}
+	else
+	{
+		if (currentInstanceBuffer != 0)
+		{
+			DisableInstanceAttributes();
+			currentInstanceBuffer = 0;
+		}
+		glDrawElementsBaseVertex(GL_TRIANGLES, item.indexCount, GL_UNSIGNED_INT, indexOffset, item.baseVertex);
+	}
+	return true;
+}
+
+void RenderQueue::DisableInstanceAttributes()
+{
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		glDisableVertexAttribArray(INSTANCE_ATTRIB_LOCATION + c);
+		glVertexAttribDivisor(INSTANCE_ATTRIB_LOCATION + c, 0);
+	}
+}
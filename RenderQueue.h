@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "mat4.h"
+#include "UniformRing.h"
+
+// Un élément de dessin : tout l'état nécessaire pour un glDrawElements
+struct DrawItem
+{
+	uint64_t key = 0;            // clé de tri (voir RenderQueue::MakeKey)
+	uint32_t program = 0;
+	uint32_t vao = 0;
+	uint32_t textureTarget = 0;  // 0 : aucune texture à lier
+	uint32_t texture = 0;
+	uint32_t textureUnit = 0;
+	int32_t indexCount = 0;
+	uint32_t firstIndex = 0;     // plage dans l'IBO partagé (MeshPool)
+	int32_t baseVertex = 0;
+	int32_t instanceCount = 0;   // 0 : dessin non instancié (matrice du bloc Object)
+	uint32_t instanceBuffer = 0; // VBO des matrices par instance, lu par les attributs 3 à 6
+	uint16_t material = 0;
+	mat4 model;
+	uint32_t objectOffset = ~0u; // position du bloc Object dans l'anneau (voir WriteObjectData)
+};
+
+// Bloc std140 "Object" : matrice modèle (ignorée par les variantes instanciées) et matériau
+struct ObjectBlock
+{
+	mat4 model;
+	uint32_t material;      // indice dans le bloc Materials (MaterialSystem)
+	uint32_t padding[3];
+};
+
+// Compteurs par frame : appels émis et appels redondants évités
+struct RenderQueueStats
+{
+	int draws = 0;
+	int programBinds = 0;
+	int programBindsSaved = 0;
+	int textureBinds = 0;
+	int textureBindsSaved = 0;
+	int vaoBinds = 0;
+	int vaoBindsSaved = 0;
+	int instanceBufferBinds = 0;
+};
+
+class RenderQueue
+{
+public:
+	// Appelée à chaque changement de programme (uniforms par frame : lumière, caméra...)
+	typedef void (*ProgramCallback)(uint32_t program, void* user);
+
+	// Première location de la matrice par instance (mat4 = 4 attributs vec4)
+	static const uint32_t INSTANCE_ATTRIB_LOCATION = 3;
+
+	// Passes, du premier au dernier dessiné
+	enum Pass { PASS_OPAQUE = 0, PASS_TRANSPARENT = 1 };
+
+	// Disposition de la clé sur 64 bits, des bits de poids fort aux bits de poids faible :
+	// pass (4) | shader (8) | material (12) | texture (12) | VAO (12) | depth (16)
+	// "depthFirst" remonte la profondeur juste après la passe (early-Z avant les changements d'état) :
+	// pass (4) | depth (16) | shader (8) | material (12) | texture (12) | VAO (12)
+	static uint64_t MakeKey(uint32_t pass, uint32_t shader, uint32_t material,
+		uint32_t texture, uint32_t vao, uint32_t depth, bool depthFirst = false);
+	// Profondeur en vue [nearZ, farZ] -> 16 bits ; "backToFront" inverse l'ordre (transparents)
+	static uint32_t QuantizeDepth(float viewDepth, float nearZ, float farZ, bool backToFront = false);
+
+	RenderQueue() : m_ObjectBuffer(0) {}
+
+	void Clear();
+	void Submit(const DrawItem& item);
+	// Tri radix (LSD, 8 bits par passe) sur les clés ; stable
+	void Sort();
+	// Écrit le bloc Object de chaque dessin dans l'anneau (avant UniformRing::Commit) ;
+	// renvoie false si l'anneau était plein (dessins sautés cette frame)
+	bool WriteObjectData(UniformRing& ring);
+	// Émet les dessins dans l'ordre trié en sautant les changements d'état redondants
+	void Flush(ProgramCallback onProgram, void* user);
+	// Pré-passe de profondeur : mêmes dessins dans le même ordre, positions seules, sans textures ;
+	// instancedProgram pour les dessins instanciés (matrice par instance aux attributs 3 à 6)
+	void FlushDepth(uint32_t program, uint32_t instancedProgram);
+
+	size_t GetSize() const { return m_Items.size(); }
+	const RenderQueueStats& GetStats() const { return m_Stats; }
+
+private:
+	// Paire clé/indice triée à la place des DrawItem (plus compacte à déplacer)
+	struct SortEntry
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	// Bloc Object, attributs d'instance et appel de dessin ; false si l'anneau était plein
+	bool Draw(const DrawItem& item, uint32_t& currentInstanceBuffer);
+	// Désactive les attributs d'instance du VAO lié : hors des dessins instanciés, le VAO partagé
+	// ne doit plus lire le buffer d'instances (vide quand la grille disparaît)
+	static void DisableInstanceAttributes();
+
+	std::vector<DrawItem> m_Items;
+	std::vector<SortEntry> m_Entries;
+	std::vector<SortEntry> m_Scratch;
+	uint32_t m_ObjectBuffer;
+	RenderQueueStats m_Stats;
+};
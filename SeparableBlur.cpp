@@ -0,0 +1,87 @@
+#include "SeparableBlur.h"
+#include "GLPlatform.h"
+
+#include <algorithm>
+#include <cmath>
+
+bool SeparableBlur::Create()
+{
+	m_FragmentShader.LoadVertexShader("shaders/fullscreen.vs");
+	m_FragmentShader.LoadFragmentShader("shaders/blur.fs");
+	if (!m_FragmentShader.Create())
+		return false;
+	glGenVertexArrays(1, &m_Vao);
+	if (GetGLCaps().computeShader && m_ComputeShader.LoadComputeShader("shaders/blur.comp"))
+		m_ComputeShader.Create();
+	m_Radius = -1;
+	SetRadius(0);
+	return true;
+}
+
+void SeparableBlur::Destroy()
+{
+	m_ComputeShader.Destroy();
+	m_FragmentShader.Destroy();
+	glDeleteVertexArrays(1, &m_Vao);
+	m_Vao = 0;
+}
+
+void SeparableBlur::SetRadius(int radius)
+{
+	radius = radius < 0 ? 0 : (radius > MAX_RADIUS ? MAX_RADIUS : radius);
+	if (radius == m_Radius)
+		return;
+	m_Radius = radius;
+	float sigma = std::max(radius * 0.5f, 0.5f);
+	float sum = 0.0f;
+	for (int i = 0; i <= MAX_RADIUS; ++i)
+	{
+		m_Weights[i] = i <= radius ? std::exp(-(float)(i * i) / (2.0f * sigma * sigma)) : 0.0f;
+		sum += i == 0 ? m_Weights[i] : 2.0f * m_Weights[i];
+	}
+	for (int i = 0; i <= MAX_RADIUS; ++i)
+		m_Weights[i] /= sum;
+}
+
+void SeparableBlur::ApplyUniforms(uint32_t program, int axis, int width, int height)
+{
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "u_source"), 0);
+	glUniform2i(glGetUniformLocation(program, "u_direction"), axis == 0 ? 1 : 0, axis == 0 ? 0 : 1);
+	glUniform2i(glGetUniformLocation(program, "u_size"), width, height);
+	glUniform1i(glGetUniformLocation(program, "u_radius"), m_Radius);
+	glUniform1fv(glGetUniformLocation(program, "u_weights"), MAX_RADIUS + 1, m_Weights);
+}
+
+void SeparableBlur::DispatchCompute(int axis, uint32_t source, uint32_t destination, int width, int height)
+{
+#ifdef GL_VERSION_4_3
+	uint32_t program = m_ComputeShader.GetProgram();
+	ApplyUniforms(program, axis, width, height);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, source);
+	glBindImageTexture(0, destination, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R11F_G11F_B10F);
+	glUniform1i(glGetUniformLocation(program, "u_destination"), 0);
+
+	// Un groupe par tuile de TILE_SIZE pixels le long de l'axe, une rangée de groupes par ligne
+	int extent = axis == 0 ? width : height;
+	int lines = axis == 0 ? height : width;
+	glDispatchCompute((extent + TILE_SIZE - 1) / TILE_SIZE, lines, 1);
+	glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R11F_G11F_B10F);
+#else
+	(void)axis; (void)source; (void)destination; (void)width; (void)height;
+#endif
+}
+
+void SeparableBlur::DrawFragment(int axis, uint32_t source, int width, int height)
+{
+	ApplyUniforms(m_FragmentShader.GetProgram(), axis, width, height);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, source);
+	glViewport(0, 0, width, height);
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(m_Vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "GLShader.h"
+
+#include <cstdint>
+
+// Flou gaussien séparable (une passe horizontale puis une verticale), base des effets de type
+// bloom, profondeur de champ ou flou d'occlusion ambiante. Deux chemins :
+// - compute (GL 4.3) : chaque groupe de travail produit TILE_SIZE pixels d'une ligne ou d'une
+//   colonne ; la tuile et ses MAX_RADIUS voisins de chaque côté sont lus une seule fois en
+//   mémoire partagée, puis chaque pixel est pondéré depuis cette mémoire (imageStore en sortie) ;
+// - fragment (GL 3.3) : triangle plein écran, 2 * rayon + 1 lectures de texture par pixel.
+class SeparableBlur
+{
+public:
+	static const int MAX_RADIUS = 16;   // mêmes valeurs que shaders/blur.comp et blur.fs
+	static const int TILE_SIZE = 128;
+
+	SeparableBlur() : m_Vao(0), m_Radius(0) {}
+
+	// Charge le chemin fragment, et le chemin compute si le contexte le permet
+	bool Create();
+	void Destroy();
+	bool HasCompute() const { return m_ComputeShader.GetProgram() != 0; }
+
+	// Rayon en texels (0 à MAX_RADIUS), sigma = rayon / 2 ; poids recalculés seulement s'il change
+	void SetRadius(int radius);
+	int GetRadius() const { return m_Radius; }
+
+	// axis : 0 horizontal, 1 vertical. Seule la zone [0, width] x [0, height] est lue et écrite.
+	// Compute : destination R11F_G11F_B10F (cible HDR) écrite par image ; barrière à la charge de l'appelant.
+	void DispatchCompute(int axis, uint32_t source, uint32_t destination, int width, int height);
+	// Fragment : la destination est le framebuffer lié
+	void DrawFragment(int axis, uint32_t source, int width, int height);
+
+private:
+	void ApplyUniforms(uint32_t program, int axis, int width, int height);
+
+	GLShader m_ComputeShader;
+	GLShader m_FragmentShader;
+	uint32_t m_Vao;      // vide : le triangle plein écran vient de gl_VertexID
+	int m_Radius;
+	float m_Weights[MAX_RADIUS + 1];
+};
@@ -0,0 +1,228 @@
+#include "ShadowCascades.h"
+#include "GLPlatform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	// Profondeur couverte en amont de la sphère (vers la lumière) pour les objets hors de la
+	// tranche qui y projettent une ombre ; au-delà, le depth clamp les plaque sur le plan proche
+	const float CASTER_MARGIN = 20.0f;
+	// Demi-côté de la projection / rayon de la sphère : place pour le décalage du centre sur la grille
+	const float SNAP_PADDING = 1.25f;
+	// Pas de la grille : un huitième du côté, soit RESOLUTION / 8 texels
+	const float SNAP_DIVISIONS = 4.0f;
+
+	float snap(float value, float step)
+	{
+		return std::floor(value / step + 0.5f) * step;
+	}
+
+	bool sameMatrix(const mat4& a, const mat4& b)
+	{
+		return std::memcmp(a.m, b.m, sizeof(a.m)) == 0;
+	}
+}
+
+ShadowCascades::ShadowCascades()
+	: m_FrameRenders(0), m_TotalRenders(0), m_Texture(0), m_Framebuffer(0)
+{
+	for (int i = 0; i < CASCADE_COUNT; ++i)
+	{
+		m_RenderedVersion[i] = 0;
+		m_Valid[i] = false;
+	}
+}
+
+void ShadowCascades::Compute(Frame& frame, const mat4& view, float fovY, float aspect, float nearZ, float distance,
+	float splitLambda, const vec3& lightDirection)
+{
+	// Base de l'espace lumière : z vers la lumière, la projection regarde vers -z
+	vec3 light = lightDirection.normalized();
+	vec3 up = std::fabs(light.y) > 0.99f ? vec3(0.0f, 0.0f, 1.0f) : vec3(0.0f, 1.0f, 0.0f);
+	vec3 right = vec3::cross(up, light).normalized();
+	vec3 lightUp = vec3::cross(light, right);
+	frame.lightDirection[0] = light.x;
+	frame.lightDirection[1] = light.y;
+	frame.lightDirection[2] = light.z;
+
+	// Caméra : position et axe de visée en monde
+	mat4 cameraToWorld = mat4::inverse(view);
+	vec3 eye(cameraToWorld.m[12], cameraToWorld.m[13], cameraToWorld.m[14]);
+	vec3 forward(-cameraToWorld.m[8], -cameraToWorld.m[9], -cameraToWorld.m[10]);
+	// Écart au carré d'un coin du frustum à l'axe, par unité de profondeur
+	float tanHalfY = std::tan(0.5f * fovY);
+	float cornerSlope2 = tanHalfY * tanHalfY * (1.0f + aspect * aspect);
+
+	float start = nearZ;
+	for (int i = 0; i < CASCADE_COUNT; ++i)
+	{
+		// Répartition pratique : logarithmique à partir d'une unité, mélangée à la linéaire
+		float t = (float)(i + 1) / CASCADE_COUNT;
+		float end = splitLambda * std::pow(distance, t) + (1.0f - splitLambda) * distance * t;
+		end = std::max(end, start + 0.01f);
+
+		// Plus petite sphère contenant les huit coins de la tranche, centrée sur l'axe de vue ;
+		// son rayon, arrondi, est le même à chaque frame
+		float center = std::min(end, 0.5f * (start + end) * (1.0f + cornerSlope2));
+		float radius = std::sqrt((end - center) * (end - center) + end * end * cornerSlope2);
+		radius = std::ceil(radius * 16.0f) / 16.0f;
+		float halfSize = radius * SNAP_PADDING;
+		float step = halfSize / SNAP_DIVISIONS;
+
+		// Centre accroché à la grille de l'espace lumière, profondeur comprise
+		vec3 sphere(eye.x + forward.x * center, eye.y + forward.y * center, eye.z + forward.z * center);
+		float cx = snap(vec3::dot(sphere, right), step);
+		float cy = snap(vec3::dot(sphere, lightUp), step);
+		float cz = snap(vec3::dot(sphere, light), step);
+
+		Cascade& cascade = frame.cascades[i];
+		float* v = cascade.view.m;
+		v[0] = right.x;  v[4] = right.y;  v[8] = right.z;   v[12] = -cx;
+		v[1] = lightUp.x; v[5] = lightUp.y; v[9] = lightUp.z; v[13] = -cy;
+		v[2] = light.x;  v[6] = light.y;  v[10] = light.z;  v[14] = -cz;
+		v[3] = 0.0f;     v[7] = 0.0f;     v[11] = 0.0f;     v[15] = 1.0f;
+
+		// Orthographique : x et y sur [-halfSize, halfSize], z de nearPlane (vers la lumière) à -halfSize
+		float nearPlane = halfSize + CASTER_MARGIN;
+		float* p = cascade.projection.m;
+		for (int k = 0; k < 16; ++k)
+			p[k] = 0.0f;
+		p[0] = 1.0f / halfSize;
+		p[5] = 1.0f / halfSize;
+		p[10] = -2.0f / (halfSize + nearPlane);
+		p[14] = (nearPlane - halfSize) / (halfSize + nearPlane);
+		p[15] = 1.0f;
+
+		cascade.splitDepth = end;
+		cascade.texelSize = 2.0f * halfSize / RESOLUTION;
+		start = end;
+	}
+}
+
+bool ShadowCascades::Create()
+{
+	glGenTextures(1, &m_Texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_Texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, RESOLUTION, RESOLUTION, CASCADE_COUNT, 0,
+		GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+	// Comparaison matérielle, filtrée sur 2x2 texels
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	glGenFramebuffers(1, &m_Framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_Texture, 0, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	for (int i = 0; i < CASCADE_COUNT; ++i)
+		m_Valid[i] = false;
+	return complete;
+}
+
+void ShadowCascades::Destroy()
+{
+	glDeleteFramebuffers(1, &m_Framebuffer);
+	glDeleteTextures(1, &m_Texture);
+	m_Framebuffer = 0;
+	m_Texture = 0;
+	for (int i = 0; i < CASCADE_COUNT; ++i)
+		m_Valid[i] = false;
+}
+
+uint32_t ShadowCascades::BeginFrame(const Frame& frame)
+{
+	m_Frame = frame;
+	m_FrameRenders = 0;
+	if (!frame.enabled || m_Texture == 0)
+		return 0;
+	uint32_t dirty = 0;
+	for (int i = 0; i < CASCADE_COUNT; ++i)
+	{
+		const Cascade& cascade = frame.cascades[i];
+		bool cached = frame.cached && m_Valid[i] && m_RenderedVersion[i] == frame.casterVersion &&
+			sameMatrix(m_Rendered[i].view, cascade.view) && sameMatrix(m_Rendered[i].projection, cascade.projection);
+		if (!cached)
+			dirty |= 1u << i;
+	}
+	return dirty;
+}
+
+void ShadowCascades::BeginCascade(int cascade)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_Texture, 0, cascade);
+	glViewport(0, 0, RESOLUTION, RESOLUTION);
+	glEnable(GL_DEPTH_TEST);
+	glDepthFunc(GL_LESS);
+	glDepthMask(GL_TRUE);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	// Décalage proportionnel à la pente (acné sur les faces rasantes) et objets devant le plan proche
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(2.0f, 2.0f);
+	glEnable(GL_DEPTH_CLAMP);
+}
+
+void ShadowCascades::EndCascade(int cascade, bool complete)
+{
+	m_FrameRenders++;
+	m_TotalRenders++;
+	m_Valid[cascade] = complete;
+	if (complete)
+	{
+		m_Rendered[cascade] = m_Frame.cascades[cascade];
+		m_RenderedVersion[cascade] = m_Frame.casterVersion;
+	}
+}
+
+void ShadowCascades::End()
+{
+	glDisable(GL_DEPTH_CLAMP);
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ShadowCascades::BindTexture() const
+{
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_Texture);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+void ShadowCascades::SetUniforms(uint32_t program) const
+{
+	GLint location = glGetUniformLocation(program, "u_shadowMap");
+	if (location < 0)
+		return;
+	glUniform1i(location, TEXTURE_UNIT);
+	glUniform1i(glGetUniformLocation(program, "u_cascadeCount"), m_Frame.enabled ? CASCADE_COUNT : 0);
+	glUniform1i(glGetUniformLocation(program, "u_shadowPcf"), m_Frame.pcfRadius);
+	glUniform1i(glGetUniformLocation(program, "u_showCascades"), m_Frame.showCascades ? 1 : 0);
+
+	// Monde -> coordonnées de texture et profondeur sur [0, 1]
+	mat4 bias = mat4::translate(0.5f, 0.5f, 0.5f) * mat4::scale(0.5f, 0.5f, 0.5f);
+	float matrices[16 * CASCADE_COUNT];
+	float splits[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float texels[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < CASCADE_COUNT; ++i)
+	{
+		const Cascade& cascade = m_Frame.cascades[i];
+		mat4 matrix = bias * cascade.projection * cascade.view;
+		std::memcpy(matrices + 16 * i, matrix.m, sizeof(matrix.m));
+		splits[i] = cascade.splitDepth;
+		texels[i] = cascade.texelSize;
+	}
+	glUniformMatrix4fv(glGetUniformLocation(program, "u_shadowMatrices"), CASCADE_COUNT, GL_FALSE, matrices);
+	glUniform4fv(glGetUniformLocation(program, "u_cascadeSplits"), 1, splits);
+	glUniform4fv(glGetUniformLocation(program, "u_cascadeTexels"), 1, texels);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include "mat4.h"
+
+// Ombres de la lumière principale (directionnelle) en cascades : le frustum de vue est découpé
+// en CASCADE_COUNT tranches de profondeur (répartition "pratique", mélange logarithmique et
+// linéaire) jusqu'à la distance d'ombre, chacune couverte par une couche d'une texture 2D array
+// de profondeur, lue en sampler2DArrayShadow (comparaison matérielle, filtre PCF configurable).
+// Projections stables : chaque tranche est englobée par une sphère dont le rayon ne dépend que
+// de la projection de la caméra, et le centre de la sphère est accroché à une grille de l'espace
+// lumière (un multiple entier de texels). Tant que la caméra reste dans une maille, la matrice
+// d'une cascade est identique au bit près : aucun scintillement des bords d'ombre en mouvement,
+// et la cascade n'a pas besoin d'être redessinée.
+// Cache : une cascade n'est redessinée que si sa matrice (lumière, maille) ou la version de
+// l'ensemble des objets projetant une ombre a changé depuis son dernier rendu complet.
+// Les projections sont calculées par le thread principal (Compute), le rendu et la comparaison
+// avec le cache se font sur le thread du contexte GL.
+class ShadowCascades
+{
+public:
+	static const int CASCADE_COUNT = 3;   // taille de u_shadowMatrices dans lighting.glsl, 4 au plus
+	static const int RESOLUTION = 2048;
+	// Unité de la texture d'ombre, après les texture buffers des lumières (5 à 7)
+	static const uint32_t TEXTURE_UNIT = 8;
+
+	struct Cascade
+	{
+		mat4 view;           // espace lumière, origine au centre accroché à la grille
+		mat4 projection;     // orthographique
+		float splitDepth;    // profondeur en vue de fin de la tranche
+		float texelSize;     // taille d'un texel en unités monde
+	};
+
+	// Ombres d'une frame : construites par le thread principal, transmises dans le paquet
+	struct Frame
+	{
+		Cascade cascades[CASCADE_COUNT];
+		float lightDirection[3] = { 0.0f, 1.0f, 0.0f }; // vers la lumière
+		uint32_t casterVersion = 0;   // change avec l'ensemble des objets projetant une ombre
+		bool enabled = false;
+		bool cached = true;           // false : toutes les cascades redessinées (comparaison)
+		int pcfRadius = 1;            // 0 : une lecture (bilinéaire), 1 : 3x3, 2 : 5x5
+		bool showCascades = false;    // teinte de la cascade lue par chaque fragment
+	};
+
+	ShadowCascades();
+
+	// Projection perspective symétrique de la caméra (champ vertical fovY, rapport aspect)
+	static void Compute(Frame& frame, const mat4& view, float fovY, float aspect, float nearZ, float distance,
+		float splitLambda, const vec3& lightDirection);
+
+	// Thread du contexte GL : texture (vide, cascades à redessiner) et framebuffer
+	bool Create();
+	void Destroy();
+
+	// Garde les réglages de la frame et renvoie les cascades à redessiner (bit i : cascade i)
+	uint32_t BeginFrame(const Frame& frame);
+	// Cible la couche de la cascade (profondeur effacée) ; décalage de profondeur et depth clamp
+	// actifs jusqu'à End
+	void BeginCascade(int cascade);
+	// Cascade rendue : complete = false (dessins manquants, anneau plein) la laisse à redessiner
+	void EndCascade(int cascade, bool complete);
+	void End();
+
+	void BindTexture() const;
+	// Uniforms u_shadow* et u_cascade* du programme lié
+	void SetUniforms(uint32_t program) const;
+
+	// Cascades redessinées par la dernière frame et depuis le début
+	uint32_t GetFrameRenders() const { return m_FrameRenders; }
+	uint32_t GetTotalRenders() const { return m_TotalRenders; }
+
+private:
+	Frame m_Frame;
+	// Clé de chaque cascade lors de son dernier rendu complet
+	Cascade m_Rendered[CASCADE_COUNT];
+	uint32_t m_RenderedVersion[CASCADE_COUNT];
+	bool m_Valid[CASCADE_COUNT];
+	uint32_t m_FrameRenders;
+	uint32_t m_TotalRenders;
+
+	uint32_t m_Texture;
+	uint32_t m_Framebuffer;
+};
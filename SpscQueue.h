@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// File à un seul producteur et un seul consommateur, sans verrou : tableau circulaire de taille
+// fixe (puissance de deux) et deux compteurs. Le producteur publie un élément par un store
+// "release" de m_Tail, le consommateur libère sa place par un store "release" de m_Head : chacun
+// voit les écritures de l'autre sur l'élément sans autre synchronisation.
+// Les versions bloquantes attendent activement quelques tours (yield) puis dorment par pas de
+// 100 µs, pour ne pas occuper un cœur pendant qu'un thread attend la vsync.
+template <typename T, uint32_t Capacity>
+class SpscQueue
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity doit être une puissance de deux");
+
+public:
+	SpscQueue() : m_Head(0), m_Tail(0) {}
+
+	// Producteur uniquement ; false si la file est pleine
+	bool TryPush(const T& value)
+	{
+		uint32_t tail = m_Tail.load(std::memory_order_relaxed);
+		if (tail - m_Head.load(std::memory_order_acquire) == Capacity)
+			return false;
+		m_Items[tail & (Capacity - 1)] = value;
+		m_Tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consommateur uniquement ; false si la file est vide
+	bool TryPop(T& value)
+	{
+		uint32_t head = m_Head.load(std::memory_order_relaxed);
+		if (head == m_Tail.load(std::memory_order_acquire))
+			return false;
+		value = m_Items[head & (Capacity - 1)];
+		m_Head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	void Push(const T& value)
+	{
+		for (uint32_t attempt = 0; !TryPush(value); ++attempt)
+			Backoff(attempt);
+	}
+
+	T Pop()
+	{
+		T value;
+		for (uint32_t attempt = 0; !TryPop(value); ++attempt)
+			Backoff(attempt);
+		return value;
+	}
+
+private:
+	static void Backoff(uint32_t attempt)
+	{
+		if (attempt < 64)
+			std::this_thread::yield();
+		else
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+	}
+
+	// Compteurs sur des lignes de cache distinctes : pas de faux partage entre les deux threads
+	alignas(64) std::atomic<uint32_t> m_Head;  // prochain élément à lire (écrit par le consommateur)
+	alignas(64) std::atomic<uint32_t> m_Tail;  // prochain emplacement libre (écrit par le producteur)
+	T m_Items[Capacity];
+};
@@ -0,0 +1,161 @@
+#include "TemporalAA.h"
+#include "GLPlatform.h"
+
+#include <cmath>
+
+TemporalAA::TemporalAA()
+	: m_Vao(0), m_Current(0), m_OutputWidth(0), m_OutputHeight(0), m_RenderWidth(0), m_RenderHeight(0),
+	m_HistoryValid(false), m_Phase(0), m_PhaseCount(MIN_PHASES), m_HasPrevious(false)
+{
+	m_Textures[0] = m_Textures[1] = 0;
+	m_Framebuffers[0] = m_Framebuffers[1] = 0;
+	m_Jitter[0] = m_Jitter[1] = 0.0f;
+}
+
+bool TemporalAA::Create()
+{
+	m_VelocityShader.LoadVertexShader("shaders/fullscreen.vs");
+	m_VelocityShader.LoadFragmentShader("shaders/taa_velocity.fs");
+	m_ResolveShader.LoadVertexShader("shaders/fullscreen.vs");
+	m_ResolveShader.LoadFragmentShader("shaders/taa_resolve.fs");
+	if (!m_VelocityShader.Create() || !m_ResolveShader.Create())
+		return false;
+	glGenVertexArrays(1, &m_Vao);
+	return true;
+}
+
+void TemporalAA::Destroy()
+{
+	m_VelocityShader.Destroy();
+	m_ResolveShader.Destroy();
+	glDeleteVertexArrays(1, &m_Vao);
+	glDeleteFramebuffers(2, m_Framebuffers);
+	glDeleteTextures(2, m_Textures);
+	m_Vao = 0;
+	m_Textures[0] = m_Textures[1] = 0;
+	m_Framebuffers[0] = m_Framebuffers[1] = 0;
+	m_OutputWidth = m_OutputHeight = 0;
+	m_HistoryValid = false;
+	m_HasPrevious = false;
+}
+
+float TemporalAA::Halton(int index, int base)
+{
+	float result = 0.0f;
+	float fraction = 1.0f;
+	while (index > 0)
+	{
+		fraction /= base;
+		result += fraction * (index % base);
+		index /= base;
+	}
+	return result;
+}
+
+mat4 TemporalAA::BeginFrame(int outputWidth, int outputHeight, int renderWidth, int renderHeight,
+	const mat4& view, const mat4& projection)
+{
+	if (outputWidth != m_OutputWidth || outputHeight != m_OutputHeight)
+	{
+		glDeleteFramebuffers(2, m_Framebuffers);
+		glDeleteTextures(2, m_Textures);
+		glGenTextures(2, m_Textures);
+		glGenFramebuffers(2, m_Framebuffers);
+		for (int i = 0; i < 2; ++i)
+		{
+			glBindTexture(GL_TEXTURE_2D, m_Textures[i]);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, outputWidth, outputHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glBindFramebuffer(GL_FRAMEBUFFER, m_Framebuffers[i]);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_Textures[i], 0);
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		m_OutputWidth = outputWidth;
+		m_OutputHeight = outputHeight;
+		m_HistoryValid = false;
+	}
+	m_RenderWidth = renderWidth;
+	m_RenderHeight = renderHeight;
+
+	// Environ MIN_PHASES échantillons par pixel de sortie : la suite s'allonge comme le rapport des surfaces
+	float areaRatio = (float)(outputWidth * outputHeight) / (float)(renderWidth * renderHeight);
+	m_PhaseCount = (int)std::ceil(MIN_PHASES * areaRatio);
+	if (m_PhaseCount < MIN_PHASES)
+		m_PhaseCount = MIN_PHASES;
+	if (m_PhaseCount > MAX_PHASES)
+		m_PhaseCount = MAX_PHASES;
+	m_Phase = (m_Phase + 1) % m_PhaseCount;
+	m_Jitter[0] = Halton(m_Phase + 1, 2) - 0.5f;
+	m_Jitter[1] = Halton(m_Phase + 1, 3) - 0.5f;
+
+	// Un texel interne i montre le point de l'image non décalée situé en i + 0.5 + jitter
+	mat4 jittered = projection;
+	jittered.m[8] += 2.0f * m_Jitter[0] / renderWidth;
+	jittered.m[9] += 2.0f * m_Jitter[1] / renderHeight;
+
+	m_ViewProjection = projection * view;
+	if (!m_HasPrevious)
+		m_PreviousViewProjection = m_ViewProjection;
+	m_InverseJittered = mat4::inverse(jittered * view);
+	return jittered;
+}
+
+void TemporalAA::EndFrame()
+{
+	m_PreviousViewProjection = m_ViewProjection;
+	m_HasPrevious = true;
+	m_HistoryValid = true;
+	m_Current = 1 - m_Current;
+}
+
+void TemporalAA::DrawVelocity(uint32_t depth)
+{
+	uint32_t program = m_VelocityShader.GetProgram();
+	glUseProgram(program);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, depth);
+	glUniform1i(glGetUniformLocation(program, "u_depth"), 0);
+	glUniform2f(glGetUniformLocation(program, "u_renderSize"), (float)m_RenderWidth, (float)m_RenderHeight);
+	mat4 toCurrent = m_ViewProjection * m_InverseJittered;
+	mat4 toPrevious = m_PreviousViewProjection * m_InverseJittered;
+	glUniformMatrix4fv(glGetUniformLocation(program, "u_toCurrent"), 1, GL_FALSE, toCurrent.getPtr());
+	glUniformMatrix4fv(glGetUniformLocation(program, "u_toPrevious"), 1, GL_FALSE, toPrevious.getPtr());
+
+	glViewport(0, 0, m_RenderWidth, m_RenderHeight);
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(m_Vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+}
+
+void TemporalAA::Resolve(uint32_t color, uint32_t depth, uint32_t velocity, float feedback)
+{
+	uint32_t program = m_ResolveShader.GetProgram();
+	glUseProgram(program);
+	const uint32_t textures[4] = { color, depth, velocity, GetHistoryTexture() };
+	const char* samplers[4] = { "u_current", "u_depth", "u_velocity", "u_history" };
+	for (int i = 0; i < 4; ++i)
+	{
+		glActiveTexture(GL_TEXTURE0 + i);
+		glBindTexture(GL_TEXTURE_2D, textures[i]);
+		glUniform1i(glGetUniformLocation(program, samplers[i]), i);
+	}
+	glActiveTexture(GL_TEXTURE0);
+	glUniform2i(glGetUniformLocation(program, "u_renderSize"), m_RenderWidth, m_RenderHeight);
+	glUniform2f(glGetUniformLocation(program, "u_outputSize"), (float)m_OutputWidth, (float)m_OutputHeight);
+	glUniform2f(glGetUniformLocation(program, "u_jitter"), m_Jitter[0], m_Jitter[1]);
+	glUniform1f(glGetUniformLocation(program, "u_feedback"), feedback);
+	glUniform1i(glGetUniformLocation(program, "u_historyValid"), m_HistoryValid ? 1 : 0);
+
+	glViewport(0, 0, m_OutputWidth, m_OutputHeight);
+	glDisable(GL_DEPTH_TEST);
+	glBindVertexArray(m_Vao);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	glEnable(GL_DEPTH_TEST);
+}
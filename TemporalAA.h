@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GLShader.h"
+#include "mat4.h"
+
+#include <cstdint>
+
+// Anti-aliasing temporel (TAA), et upscale temporel quand la scène est rendue à une résolution
+// interne réduite. Chaque frame :
+// - la projection est décalée d'une fraction de pixel interne (suite de Halton en base 2 et 3) ;
+// - passe "Vitesses" : déplacement écran de chaque pixel depuis la frame précédente, reconstruit à
+//   partir de la profondeur et des matrices des deux frames (les objets de la scène sont fixes,
+//   seule la caméra bouge) ;
+// - passe "TAA", à la résolution de sortie : l'historique reprojeté est borné par les statistiques
+//   du voisinage 3x3 courant (clipping de variance en YCoCg), puis mélangé à l'échantillon courant
+//   le plus proche, pondéré par sa distance au centre du pixel de sortie. Les échantillons décalés
+//   des frames successives reconstruisent ainsi des détails plus fins que la résolution interne.
+// L'historique est une paire de textures RGBA16F à la taille de sortie, échangées chaque frame.
+class TemporalAA
+{
+public:
+	static const int MIN_PHASES = 8;
+	static const int MAX_PHASES = 32;
+
+	TemporalAA();
+
+	bool Create();
+	void Destroy();
+
+	// Début de frame : (ré)alloue l'historique à la taille de sortie, avance dans la suite de
+	// décalages et renvoie la projection décalée pour une zone rendue de renderWidth x renderHeight
+	mat4 BeginFrame(int outputWidth, int outputHeight, int renderWidth, int renderHeight,
+		const mat4& view, const mat4& projection);
+	// Fin de frame : la sortie devient l'historique de la frame suivante
+	void EndFrame();
+	// L'historique n'est plus valable (TAA désactivé puis réactivé)
+	void Invalidate() { m_HistoryValid = false; }
+
+	uint32_t GetHistoryTexture() const { return m_Textures[1 - m_Current]; }
+	uint32_t GetOutputTexture() const { return m_Textures[m_Current]; }
+	uint32_t GetOutputFramebuffer() const { return m_Framebuffers[m_Current]; }
+	int GetPhaseCount() const { return m_PhaseCount; }
+	const float* GetJitter() const { return m_Jitter; }
+
+	// Vers le framebuffer lié, sur la zone rendue : vitesses (RG16F, en UV écran) depuis la profondeur
+	void DrawVelocity(uint32_t depth);
+	// Vers le framebuffer de sortie : color, depth et velocity couvrent la zone rendue
+	void Resolve(uint32_t color, uint32_t depth, uint32_t velocity, float feedback);
+
+private:
+	static float Halton(int index, int base);
+
+	GLShader m_VelocityShader;
+	GLShader m_ResolveShader;
+	uint32_t m_Vao;                  // vide : triangle plein écran (shaders/fullscreen.vs)
+	uint32_t m_Textures[2];
+	uint32_t m_Framebuffers[2];
+	int m_Current;                   // historique écrit cette frame
+	int m_OutputWidth, m_OutputHeight;
+	int m_RenderWidth, m_RenderHeight;
+	bool m_HistoryValid;
+
+	int m_Phase;
+	int m_PhaseCount;                // plus d'échantillons quand la résolution interne baisse
+	float m_Jitter[2];               // décalage de la frame, en pixels internes
+
+	mat4 m_ViewProjection;           // sans décalage
+	mat4 m_PreviousViewProjection;
+	mat4 m_InverseJittered;          // clip décalé -> monde
+	bool m_HasPrevious;
+};
@@ -0,0 +1,202 @@
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* name;
+		int64_t startUs;
+		int64_t durationUs;
+		char detail[48];
+	};
+
+	// Un seul écrivain (le thread propriétaire) ; head est publié après l'écriture de l'événement
+	struct TraceBuffer
+	{
+		uint32_t tid;
+		std::string threadName;
+		std::atomic<uint64_t> head;
+		std::vector<TraceEvent> events;
+
+		explicit TraceBuffer(uint32_t id) : tid(id), head(0), events(Trace::BUFFER_CAPACITY) {}
+	};
+
+	const uint32_t GPU_TID = 1000;
+
+	std::mutex s_RegistryMutex;
+	std::vector<TraceBuffer*> s_Buffers;
+	TraceBuffer* s_GpuBuffer = nullptr;
+	thread_local TraceBuffer* t_Buffer = nullptr;
+
+	std::atomic<bool> s_Recording(false);
+	// Push en cours : Stop les attend, WriteJson ne lit donc jamais un événement à moitié écrit
+	std::atomic<uint32_t> s_Writers(0);
+	std::atomic<int64_t> s_StartUs(0);
+	std::atomic<int64_t> s_StopUs(0);
+
+	const std::chrono::steady_clock::time_point s_Epoch = std::chrono::steady_clock::now();
+
+	TraceBuffer* RegisterBuffer(uint32_t tid)
+	{
+		TraceBuffer* buffer = new TraceBuffer(tid);
+		std::lock_guard<std::mutex> lock(s_RegistryMutex);
+		s_Buffers.push_back(buffer);
+		return buffer;
+	}
+
+	TraceBuffer* ThreadBuffer()
+	{
+		if (!t_Buffer)
+		{
+			static std::atomic<uint32_t> nextTid(1);
+			t_Buffer = RegisterBuffer(nextTid++);
+		}
+		return t_Buffer;
+	}
+
+	void Push(TraceBuffer* buffer, const char* name, int64_t startUs, int64_t durationUs, const char* detail)
+	{
+		// Rien n'est écrit après Stop : la trace peut être exportée pendant que les autres threads
+		// continuent (résultats GPU en retard, portées ouvertes avant Stop)
+		if (!s_Recording.load(std::memory_order_relaxed))
+			return;
+		s_Writers.fetch_add(1);
+		if (!s_Recording)
+		{
+			s_Writers.fetch_sub(1);
+			return;
+		}
+		uint64_t head = buffer->head.load(std::memory_order_relaxed);
+		TraceEvent& event = buffer->events[head % Trace::BUFFER_CAPACITY];
+		event.name = name;
+		event.startUs = startUs;
+		event.durationUs = durationUs;
+		event.detail[0] = '\0';
+		if (detail)
+		{
+			strncpy(event.detail, detail, sizeof(event.detail) - 1);
+			event.detail[sizeof(event.detail) - 1] = '\0';
+		}
+		buffer->head.store(head + 1, std::memory_order_release);
+		s_Writers.fetch_sub(1, std::memory_order_release);
+	}
+
+	void WriteEscaped(FILE* file, const char* text)
+	{
+		for (const char* c = text; *c; ++c)
+		{
+			if (*c == '"' || *c == '\\')
+				fputc('\\', file);
+			if ((unsigned char)*c >= 0x20)
+				fputc(*c, file);
+		}
+	}
+}
+
+namespace Trace
+{
+	int64_t NowUs()
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_Epoch).count();
+	}
+
+	void Start()
+	{
+		s_StartUs = NowUs();
+		s_StopUs = INT64_MAX;
+		s_Recording = true;
+	}
+
+	void Stop()
+	{
+		s_Recording = false;
+		s_StopUs = NowUs();
+		while (s_Writers != 0)
+			std::this_thread::yield();
+	}
+
+	bool IsRecording()
+	{
+		return s_Recording.load(std::memory_order_relaxed);
+	}
+
+	void SetThreadName(const char* name)
+	{
+		TraceBuffer* buffer = ThreadBuffer();
+		std::lock_guard<std::mutex> lock(s_RegistryMutex);
+		buffer->threadName = name;
+	}
+
+	void RecordCpu(const char* name, int64_t startUs, int64_t durationUs, const char* detail)
+	{
+		Push(ThreadBuffer(), name, startUs, durationUs, detail);
+	}
+
+	void RecordGpu(const char* name, int64_t startUs, int64_t durationUs)
+	{
+		if (!s_GpuBuffer)
+		{
+			s_GpuBuffer = RegisterBuffer(GPU_TID);
+			std::lock_guard<std::mutex> lock(s_RegistryMutex);
+			s_GpuBuffer->threadName = "GPU";
+		}
+		Push(s_GpuBuffer, name, startUs, durationUs, nullptr);
+	}
+
+	bool WriteJson(const char* path)
+	{
+		FILE* file = fopen(path, "w");
+		if (!file)
+			return false;
+
+		int64_t startUs = s_StartUs;
+		int64_t stopUs = s_StopUs;
+		std::lock_guard<std::mutex> lock(s_RegistryMutex);
+		fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"ESIEE_Computer_Graphics\"}}");
+		for (size_t b = 0; b < s_Buffers.size(); ++b)
+		{
+			const TraceBuffer* buffer = s_Buffers[b];
+			bool gpu = buffer->tid == GPU_TID;
+			if (!buffer->threadName.empty())
+			{
+				fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", buffer->tid);
+				WriteEscaped(file, buffer->threadName.c_str());
+				fprintf(file, "\"}}");
+			}
+			// Les événements antérieurs à head - BUFFER_CAPACITY ont été écrasés
+			uint64_t head = buffer->head.load(std::memory_order_acquire);
+			uint64_t first = head > BUFFER_CAPACITY ? head - BUFFER_CAPACITY : 0;
+			for (uint64_t i = first; i < head; ++i)
+			{
+				const TraceEvent& event = buffer->events[i % BUFFER_CAPACITY];
+				if (event.startUs < startUs || event.startUs > stopUs)
+					continue;
+				fprintf(file, ",\n{\"name\":\"");
+				WriteEscaped(file, event.name);
+				fprintf(file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%u",
+					gpu ? "gpu" : "cpu", (long long)event.startUs, (long long)event.durationUs, buffer->tid);
+				if (event.detail[0])
+				{
+					fprintf(file, ",\"args\":{\"detail\":\"");
+					WriteEscaped(file, event.detail);
+					fprintf(file, "\"}");
+				}
+				fprintf(file, "}");
+			}
+		}
+		fprintf(file, "\n]}\n");
+		bool ok = ferror(file) == 0;
+		fclose(file);
+		return ok;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+
+// Instrumentation au format Chrome Trace Event (ui.perfetto.dev, chrome://tracing).
+// Chaque thread écrit dans son propre tampon circulaire, sans verrou : seul l'enregistrement
+// du tampon, au premier événement du thread, prend un mutex. Les noms d'événements ne sont
+// pas copiés et doivent être des chaînes littérales ; le détail optionnel est copié (tronqué).
+// Les résultats GPU du GpuProfiler sont ajoutés sur une piste "GPU" séparée.
+namespace Trace
+{
+	// Événements conservés par thread ; au-delà, les plus anciens sont écrasés
+	const uint32_t BUFFER_CAPACITY = 32 * 1024;
+
+	// Horloge de tous les événements, en microsecondes
+	int64_t NowUs();
+
+	void Start();
+	void Stop();
+	bool IsRecording();
+
+	// Nom affiché pour la piste du thread appelant
+	void SetThreadName(const char* name);
+
+	void RecordCpu(const char* name, int64_t startUs, int64_t durationUs, const char* detail = nullptr);
+	// Dates déjà converties dans l'horloge NowUs ; à appeler depuis un seul thread (celui du contexte GL)
+	void RecordGpu(const char* name, int64_t startUs, int64_t durationUs);
+
+	// Écrit les événements compris entre Start et Stop ; après Stop, sans attendre les autres threads
+	bool WriteJson(const char* path);
+}
+
+// Section délimitée par la portée C++ ; ne coûte qu'un test atomique hors enregistrement
+class TraceScope
+{
+public:
+	TraceScope(const char* name, const char* detail = nullptr)
+		: m_Name(name), m_Detail(detail), m_Start(Trace::IsRecording() ? Trace::NowUs() : -1) {}
+	~TraceScope()
+	{
+		if (m_Start >= 0)
+			Trace::RecordCpu(m_Name, m_Start, Trace::NowUs() - m_Start, m_Detail);
+	}
+
+private:
+	const char* m_Name;
+	const char* m_Detail;
+	int64_t m_Start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_SCOPE_DETAIL(name, detail) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, detail)
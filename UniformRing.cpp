@@ -0,0 +1,154 @@
+#include "UniformRing.h"
+#include "GLPlatform.h"
+
+#include <cstring>
+
+bool UniformRing::Create(uint32_t frameSize, bool persistent)
+{
+	GLint alignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	m_Alignment = alignment > 0 ? (uint32_t)alignment : 256;
+
+#ifdef GL_VERSION_4_4
+	m_Persistent = persistent;
+#else
+	(void)persistent;
+	m_Persistent = false;
+#endif
+	Allocate(frameSize);
+	return m_Buffer != 0;
+}
+
+void UniformRing::Allocate(uint32_t frameSize)
+{
+	// Chaque segment commence sur une frontière valide pour glBindBufferRange
+	m_FrameSize = (frameSize + m_Alignment - 1) / m_Alignment * m_Alignment;
+	m_Frame = 0;
+	m_Used = 0;
+
+	glGenBuffers(1, &m_Buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+#ifdef GL_VERSION_4_4
+	if (m_Persistent)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLsizeiptr totalSize = (GLsizeiptr)m_FrameSize * FRAME_COUNT;
+		glBufferStorage(GL_UNIFORM_BUFFER, totalSize, nullptr, flags);
+		m_Mapped = (uint8_t*)glMapBufferRange(GL_UNIFORM_BUFFER, 0, totalSize, flags);
+		if (!m_Mapped)
+		{
+			// Mapping refusé : on repasse sur l'orphaning avec un buffer mutable
+			glDeleteBuffers(1, &m_Buffer);
+			glGenBuffers(1, &m_Buffer);
+			glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+			m_Persistent = false;
+		}
+	}
+#endif
+	if (!m_Persistent)
+	{
+		glBufferData(GL_UNIFORM_BUFFER, m_FrameSize, nullptr, GL_STREAM_DRAW);
+		m_Shadow.resize(m_FrameSize);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformRing::Destroy()
+{
+	for (uint32_t i = 0; i < FRAME_COUNT; ++i)
+	{
+		if (m_Fences[i])
+			glDeleteSync((GLsync)m_Fences[i]);
+		m_Fences[i] = nullptr;
+	}
+	if (m_Mapped)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_Mapped = nullptr;
+	}
+	glDeleteBuffers(1, &m_Buffer);
+	m_Buffer = 0;
+	m_Shadow.clear();
+}
+
+void UniformRing::BeginFrame()
+{
+	if (m_Overflow)
+	{
+		// La frame précédente n'a pas tenu dans son segment : on double la taille.
+		// Le buffer est immuable, il faut attendre le GPU avant de le remplacer.
+		uint32_t frameSize = m_FrameSize * 2;
+		glFinish();
+		Destroy();
+		Allocate(frameSize);
+		m_Overflow = false;
+	}
+
+	if (m_Fences[m_Frame])
+	{
+		GLsync fence = (GLsync)m_Fences[m_Frame];
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			// Le GPU a plus de FRAME_COUNT - 1 frames de retard : on bloque jusqu'au signal
+			m_WaitCount++;
+			while (result == GL_TIMEOUT_EXPIRED)
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+		}
+		glDeleteSync(fence);
+		m_Fences[m_Frame] = nullptr;
+	}
+	m_Used = 0;
+}
+
+bool UniformRing::Write(const void* data, uint32_t size, uint32_t& offset)
+{
+	uint32_t start = (m_Used + m_Alignment - 1) / m_Alignment * m_Alignment;
+	if (start + size > m_FrameSize)
+	{
+		if (m_Persistent)
+		{
+			m_Overflow = true;
+			return false;
+		}
+		// Copie CPU : on peut l'agrandir tout de suite, le buffer est réalloué au Commit
+		while (start + size > m_FrameSize)
+			m_FrameSize *= 2;
+		m_Shadow.resize(m_FrameSize);
+	}
+
+	uint8_t* destination = m_Persistent ? m_Mapped + SegmentBase() + start : m_Shadow.data() + start;
+	memcpy(destination, data, size);
+	m_Used = start + size;
+	offset = SegmentBase() + start;
+	return true;
+}
+
+void UniformRing::Commit()
+{
+	m_LastFrameBytes = m_Used;
+	// Mapping cohérent : les écritures sont déjà visibles
+	if (m_Persistent || m_Used == 0)
+		return;
+
+	// Orphaning : nouveau stockage pour cette frame, l'ancien reste lu par le GPU
+	glBindBuffer(GL_UNIFORM_BUFFER, m_Buffer);
+	glBufferData(GL_UNIFORM_BUFFER, m_FrameSize, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, m_Used, m_Shadow.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UniformRing::EndFrame()
+{
+	if (!m_Persistent)
+		return;
+	m_Fences[m_Frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	m_Frame = (m_Frame + 1) % FRAME_COUNT;
+}
+
+void UniformRing::BindRange(uint32_t binding, uint32_t offset, uint32_t size) const
+{
+	glBindBufferRange(GL_UNIFORM_BUFFER, binding, m_Buffer, offset, size);
+}
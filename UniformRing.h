@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Points de liaison des blocs uniformes partagés par tous les shaders
+enum UniformBinding
+{
+	UNIFORM_BINDING_MATRICES = 0,         // bloc "Matrices" : données par frame
+	UNIFORM_BINDING_OBJECT = 1,           // bloc "Object" : données par dessin
+	UNIFORM_BINDING_MATERIALS = 2,        // bloc "Materials" : table du MaterialSystem
+	UNIFORM_BINDING_MATERIAL_HANDLES = 3  // bloc "MaterialHandles" : handles bindless (optionnel)
+};
+
+// Anneau de buffers pour les données uniformes par frame et par dessin.
+// Les données d'une frame sont écrites linéairement puis liées avec glBindBufferRange.
+// - GL 4.4+ : un buffer immuable mappé en permanence (GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT),
+//   découpé en 3 segments ; une fence par segment évite d'écraser ce que le GPU lit encore.
+// - Sinon : écriture dans une copie CPU puis orphaning (glBufferData NULL + glBufferSubData) au Commit.
+class UniformRing
+{
+public:
+	static const uint32_t FRAME_COUNT = 3;
+
+	UniformRing() : m_Buffer(0), m_FrameSize(0), m_Alignment(256), m_Frame(0), m_Used(0),
+		m_Mapped(nullptr), m_Persistent(false), m_Overflow(false), m_LastFrameBytes(0), m_WaitCount(0)
+	{
+		for (uint32_t i = 0; i < FRAME_COUNT; ++i)
+			m_Fences[i] = nullptr;
+	}
+
+	bool Create(uint32_t frameSize, bool persistent);
+	void Destroy();
+
+	// Début de frame : attend si nécessaire que le GPU ait fini de lire le segment réutilisé
+	void BeginFrame();
+	// Copie "size" octets alignés ; renvoie false si le segment de la frame est plein
+	bool Write(const void* data, uint32_t size, uint32_t& offset);
+	// Rend les écritures de la frame visibles au GPU (à appeler avant les dessins)
+	void Commit();
+	// Fin de frame : pose la fence du segment
+	void EndFrame();
+
+	void BindRange(uint32_t binding, uint32_t offset, uint32_t size) const;
+
+	uint32_t GetBuffer() const { return m_Buffer; }
+	bool IsPersistent() const { return m_Persistent; }
+	uint32_t GetFrameSize() const { return m_FrameSize; }
+	uint32_t GetLastFrameBytes() const { return m_LastFrameBytes; }
+	uint32_t GetWaitCount() const { return m_WaitCount; }
+
+private:
+	uint32_t SegmentBase() const { return m_Persistent ? m_Frame * m_FrameSize : 0; }
+	void Allocate(uint32_t frameSize);
+
+	uint32_t m_Buffer;
+	uint32_t m_FrameSize;
+	uint32_t m_Alignment;
+	uint32_t m_Frame;
+	uint32_t m_Used;
+	uint8_t* m_Mapped;                  // mapping persistant (ou nullptr)
+	std::vector<uint8_t> m_Shadow;      // copie CPU du chemin par orphaning
+	void* m_Fences[FRAME_COUNT];        // GLsync par segment
+	bool m_Persistent;
+	bool m_Overflow;                    // la frame a débordé : le segment sera agrandi
+	uint32_t m_LastFrameBytes;
+	uint32_t m_WaitCount;               // nombre de fois où le CPU a dû attendre le GPU
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Deque de Chase-Lev à capacité fixe (puissance de deux), version de Lê et al. pour les modèles
+// mémoire faibles. Le thread propriétaire empile et dépile par le bas (ordre LIFO : les tâches
+// qu'il vient de créer sont encore en cache) ; les autres threads volent par le haut (FIFO : les
+// tâches les plus anciennes, en général les plus grosses). Seul le dernier élément est disputé
+// entre le propriétaire et un voleur, arbitré par un compare-exchange sur m_Top.
+template <typename T, uint32_t Capacity>
+class WorkStealingDeque
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity doit être une puissance de deux");
+
+public:
+	WorkStealingDeque() : m_Top(0), m_Bottom(0) {}
+
+	// Propriétaire uniquement ; false si la deque est pleine
+	bool Push(T value)
+	{
+		int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+		int64_t top = m_Top.load(std::memory_order_acquire);
+		if (bottom - top >= (int64_t)Capacity)
+			return false;
+		m_Items[bottom & (Capacity - 1)].store(value, std::memory_order_relaxed);
+		// Publie l'élément (et la tâche pointée) aux voleurs, qui lisent m_Bottom en acquire
+		m_Bottom.store(bottom + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Propriétaire uniquement ; false si la deque est vide ou si un voleur a pris le dernier élément
+	bool Pop(T& value)
+	{
+		int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+		m_Bottom.store(bottom, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t top = m_Top.load(std::memory_order_relaxed);
+		if (top > bottom)
+		{
+			m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+		value = m_Items[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+		if (top < bottom)
+			return true;
+		// Dernier élément : course avec les voleurs
+		bool won = m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+		return won;
+	}
+
+	// N'importe quel thread ; false si la deque est vide ou si le vol a perdu la course
+	bool Steal(T& value)
+	{
+		int64_t top = m_Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t bottom = m_Bottom.load(std::memory_order_acquire);
+		if (top >= bottom)
+			return false;
+		value = m_Items[top & (Capacity - 1)].load(std::memory_order_relaxed);
+		return m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	// Approximatif si d'autres threads volent en même temps
+	bool IsEmpty() const
+	{
+		return m_Bottom.load(std::memory_order_relaxed) <= m_Top.load(std::memory_order_relaxed);
+	}
+
+private:
+	// Lu par les voleurs, écrit par le propriétaire : lignes de cache distinctes
+	alignas(64) std::atomic<int64_t> m_Top;
+	alignas(64) std::atomic<int64_t> m_Bottom;
+	std::atomic<T> m_Items[Capacity];
+};
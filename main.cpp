@@ -1,12 +1,4 @@
-#ifdef _WIN32
-#include <GL/glew.h>
-#include <GL/wglew.h>
-#endif
-
-#ifdef __APPLE__
-#include <OpenGL/gl3.h>
-#include <OpenGL/OpenGL.h>
-#endif
+#include "GLPlatform.h"
 
 #include <GLFW/glfw3.h>
 
@@ -15,9 +7,41 @@
 #include <cmath>
 #include "mat4.h"
 #include "GLShader.h"
+#include "RenderQueue.h"
+#include "MeshPool.h"
+#include "MultiDrawBatch.h"
+#include "UniformRing.h"
+#include "MaterialSystem.h"
+#include "HeadlessContext.h"
+#include "PngWriter.h"
+#include "Benchmark.h"
+#include "GpuProfiler.h"
+#include "Trace.h"
+#include "FramePacer.h"
+#include "DynamicResolution.h"
+#include "SpscQueue.h"
+#include "ImGuiSnapshot.h"
+#include "JobSystem.h"
+#include "ObjectCulling.h"
+#include "ColorGrading.h"
+#include "RenderGraph.h"
+#include "SeparableBlur.h"
+#include "Bloom.h"
+#include "AutoExposure.h"
+#include "TemporalAA.h"
+#include "OverdrawView.h"
+#include "LightClusters.h"
+#include "DeferredLighting.h"
+#include "ShadowCascades.h"
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <limits>
 
 // --- ImGui includes ---
 #include "imgui.h"
@@ -38,25 +62,121 @@ GLShader g_EnvShader;
 GLShader g_SkyboxShader;
 GLShader g_PhongShader;
 GLShader g_ScreenQuadShader;
+// Variantes instanciées : la matrice modèle vient d'un attribut par instance
+GLShader g_PhongInstancedShader;
+GLShader g_TextureInstancedShader;
+GLShader g_EnvInstancedShader;
+// Variante MDI : matrice et matériau lus dans des SSBO via l'indice de dessin (GL 4.3)
+GLShader g_PhongMdiShader;
+// Pré-passe de profondeur : positions seules, pour les dessins simples, instanciés et MDI
+GLShader g_DepthShader;
+GLShader g_DepthInstancedShader;
+GLShader g_DepthMdiShader;
+// Rendu différé : variantes des shaders d'objets qui remplissent le G-buffer (gbuffer*.fs)
+GLShader g_GBufferShader;
+GLShader g_GBufferInstancedShader;
+GLShader g_GBufferTextureShader;
+GLShader g_GBufferTextureInstancedShader;
+GLShader g_GBufferEnvShader;
+GLShader g_GBufferEnvInstancedShader;
+GLShader g_GBufferMdiShader;
 GLFWwindow* g_window;
 
+// Mode sans fenêtre (--headless) : pas de GLFW, la frame finale va dans g_outputFbo
+bool g_headless = false;
+GLuint g_outputFbo = 0;
+GLuint g_outputColor = 0;
+
+// Mode benchmark (--benchmark, --headless) : trajectoire de caméra et mesures de temps de frame
+Benchmark g_benchmark;
+
+// Temps CPU et GPU de chaque passe du rendu, fenêtre "Profileur"
+GpuProfiler g_profiler;
+bool g_profilerEnabled = true;
+// Trace démarrée depuis la fenêtre "Profileur" (--trace enregistre toute la session)
+const char* g_tracePath = "trace.json";
+
+// Cadence de la boucle fenêtrée : 0 vsync désactivée, 1 activée, 2 adaptative
+// (swap immédiat quand la frame a raté la synchronisation, si le pilote le permet)
+FramePacer g_framePacer;
+int g_vsyncMode = 1;
+int g_vsyncModeApplied = -1;
+bool g_adaptiveVsyncSupported = false;
+int g_fpsCap = 0;                 // 0 : pas de limite
+bool g_finishAfterSwap = false;   // vide la file du pilote : moins de latence, moins de débit
+
 GLuint g_mainTex = 0;
-GLuint secondTex = 0;
 GLuint envCubemap = 0;
 GLuint sphereCubemap = 0;
 GLuint skyboxVAO = 0, skyboxVBO = 0;
-GLuint g_uboMatrices = 0;
-
-// FBO related variables
-GLuint g_fbo = 0;
-GLuint g_fboTexture = 0;
-GLuint g_rboDepthStencil = 0; // Renderbuffer for depth and stencil
+// Blocs Matrices (par frame) et Object (par dessin), écrits linéairement chaque frame
+UniformRing g_uniformRing;
+
+// Matériaux de la scène (UBO "Materials"), textures dédupliquées par chemin
+MaterialSystem g_materialSystem;
+int g_editedMaterial = 0;
+// Copie des paramètres éditée par l'interface ; les modifications sont envoyées au rendu
+std::vector<MaterialParams> g_materialEditorParams;
+
+// Cibles de la frame (couleur et profondeur de la scène) : textures transitoires du graphe de rendu,
+// allouées et réutilisées par g_renderGraph selon les passes déclarées à chaque frame
+RenderGraph g_renderGraph;
+// Taille des cibles de scène : celle de la sortie, qui suit la taille de la fenêtre.
+// La scène n'en utilise que le coin [0, g_renderWidth] x [0, g_renderHeight].
+int g_sceneTargetWidth = 0;
+int g_sceneTargetHeight = 0;
+int g_renderWidth = 0;
+int g_renderHeight = 0;
+
+// Échelle de la résolution interne, fixe ou pilotée par le temps GPU (fenêtre "Résolution")
+DynamicResolution g_dynamicResolution;
+
+// Réglages de la fenêtre "Résolution", appliqués au DynamicResolution par le thread de rendu
+struct ResolutionSettings {
+    bool dynamic = false;
+    float budgetMs = 16.0f;
+    float minScale = 0.5f;
+    float maxScale = 1.0f;
+    float scale = 1.0f;      // échelle fixe, sans résolution dynamique
+};
+ResolutionSettings g_resolutionSettings;
+
+// Réglages de la fenêtre "HDR" : bloom, exposition et tonemapping du quad plein écran
+struct HdrSettings {
+    int tonemap = 2;                 // 0 : écrêtage, 1 : Reinhard, 2 : ACES
+    float exposureEv = 0.0f;         // compensation, en diaphragmes
+    bool autoExposure = false;       // histogramme de luminance (compute, GL 4.3)
+    float targetLuminance = 0.35f;   // luminance moyenne visée par l'exposition automatique
+    float adaptationSpeed = 2.0f;    // 1/s
+    bool bloom = true;
+    float bloomStrength = 0.04f;
+    float skyIntensity = 1.0f;       // la cubemap LDR peut dépasser 1 dans la cible HDR
+};
+HdrSettings g_hdrSettings;
+Bloom g_bloom;
+AutoExposure g_autoExposure;
+
+// Anti-aliasing (fenêtre "Résolution") : TAA ou upscale temporel, et MSAA de la scène
+struct AntiAliasingSettings {
+    int mode = 0;            // 0 : aucun, 1 : TAA (résolution interne = sortie), 2 : upscale temporel
+    float feedback = 0.9f;   // poids de l'historique
+    int msaaSamples = 1;     // 1 : pas de MSAA, sinon 2, 4 ou 8 échantillons
+};
+AntiAliasingSettings g_antiAliasingSettings;
+TemporalAA g_temporalAA;
+// Sections du profileur par nombre d'échantillons (1x, 2x, 4x, 8x) : scène, puis résolution MSAA
+const int MSAA_MODE_COUNT = 4;
+const char* const MSAA_SCENE_SCOPES[MSAA_MODE_COUNT] = { "Scène 1x", "Scène MSAA 2x", "Scène MSAA 4x", "Scène MSAA 8x" };
+const char* const MSAA_RESOLVE_SCOPES[MSAA_MODE_COUNT] = { "", "Résolution MSAA 2x", "Résolution MSAA 4x", "Résolution MSAA 8x" };
+// Thread principal : temps GPU lissé de la scène et de sa résolution, par nombre d'échantillons
+float g_msaaGpuMs[MSAA_MODE_COUNT] = { 0.0f, 0.0f, 0.0f, 0.0f };
+uint32_t g_sceneTimingsFrame = 0;
 
 // Screen quad variables
 GLuint g_screenQuadVAO = 0;
 GLuint g_screenQuadVBO = 0;
 
-// FBO dimensions (can be different from window dimensions)
+// Taille initiale de la fenêtre, et taille de sortie du mode headless
 const int FBO_WIDTH = 1024;
 const int FBO_HEIGHT = 768;
 
@@ -73,8 +193,97 @@ double g_lastMouseY = 0.0;
 int g_selectedPostProcessEffect = 0; // 0: None, 1: Grayscale, 2: Invert, 3: Sepia
 float g_saturation = 1.0f; // New: Saturation control (1.0 for original)
 float g_contrast = 1.0f;   // New: Contrast control (1.0 for original)
+// Effet, saturation et contraste précalculés dans une LUT 3D (une seule lecture par pixel)
+ColorGrading g_colorGrading;
+std::vector<ColorOperation> g_colorOperations;
+GLuint g_colorLut = 0;
+// Flou séparable avant l'étalonnage : compute shader sur GL 4.3, sinon passes fragment
+SeparableBlur g_blur;
+int g_blurRadius = 0;           // 0 : pas de flou
+bool g_blurCompute = true;
 // -----------------------------------
 
+// --- Instanciation : N copies de g_mainModel en un seul appel ---
+int g_instanceCount = 0;        // 0 : pas de grille instanciée
+int g_instanceShader = 0;       // 0: Phong, 1: Texture, 2: Env map
+int g_instanceCountUploaded = -1; // nombre de matrices déjà envoyées au rendu
+// ----------------------------------------------------------------
+
+// --- File de rendu triée par clé (une par paquet de frame) ---
+bool g_sortRenderQueue = true;
+// Ordre des dessins opaques et pré-passe de profondeur (fenêtre "Rendu")
+struct DepthSettings {
+    bool frontToBack = true;   // clé de tri : profondeur avant l'état (early-Z)
+    bool prepass = false;      // profondeur des objets opaques d'abord, puis couleur en GL_LEQUAL sans écriture
+    bool overdraw = false;     // vue de surdessin : fragments ombrés par pixel (OverdrawView)
+};
+DepthSettings g_depthSettings;
+OverdrawView g_overdrawView;
+
+// Lumières ponctuelles dynamiques, en orbite autour des deux scènes (fenêtre "Lumières")
+struct LightSettings {
+    int count = 0;
+    float radius = 2.5f;       // rayon d'influence
+    float intensity = 2.0f;
+    bool animate = true;
+    bool clustered = true;     // false : chaque fragment parcourt toutes les lumières (comparaison)
+};
+LightSettings g_lightSettings;
+float g_lightAnimationTime = 0.0f; // avance d'un pas fixe par frame construite (captures reproductibles)
+std::vector<PointLight> g_lights;
+LightClusters g_lightClusters;     // thread de rendu : buffers GPU
+LightClusters::Stats g_lightStats; // thread principal : dernière construction
+
+// Chemin d'éclairage (fenêtre "Rendu") : forward, un shader éclairé par objet, ou différé,
+// G-buffer rempli par tous les objets opaques puis une passe d'éclairage par pixel
+bool g_deferredShading = false;
+DeferredLighting g_deferredLighting;
+// Sections du profileur de chaque chemin, et temps GPU lissé (thread principal) : le forward
+// compte la scène et sa résolution MSAA, le différé le G-buffer, l'éclairage et le ciel
+const int SHADING_PATH_COUNT = 2;
+const char* const DEFERRED_SCOPES[] = { "G-buffer", "Éclairage différé", "Skybox (différé)" };
+float g_shadingGpuMs[SHADING_PATH_COUNT] = { 0.0f, 0.0f };
+// -----------------------------------
+
+// Tâches par vol de travail : culling et matrices de la scène de benchmark, chargement des cubemaps
+JobSystem g_jobSystem;
+ObjectCuller g_benchCuller;
+
+// --- Scène de benchmark : N objets soumis en boucle ou en un seul MultiDraw indirect ---
+bool g_benchScene = false;
+// Variante MDI lisant les textures par handles bindless (ARB_bindless_texture)
+bool g_bindlessMaterials = false;
+int g_benchObjectCount = 10000;
+int g_benchObjectCountBuilt = -1;
+int g_submitMode = 1;                   // 0: boucle glDrawElements, 1: glMultiDrawElementsIndirect
+double g_submitTimeMs[2] = { 0.0, 0.0 }; // temps CPU de soumission lissé, par chemin (thread de rendu)
+MultiDrawBatch g_benchBatch;
+bool g_benchCulling = true;             // culling par frustum avant de remplir le lot
+uint32_t g_benchVisibleCount = 0;
+// --------------------------------------------------------------------------------------
+
+// --- Ombres de la lumière principale, directionnelle, en cascades (fenêtre "Ombres") ---
+struct ShadowSettings {
+    bool enabled = true;
+    float lightYaw = 0.0f;          // degrés autour de Y, 0 : vers +z
+    float lightElevation = 68.2f;   // degrés au-dessus de l'horizon (vers l'ancienne lumière en (0, 5, 2))
+    float distance = 30.0f;         // profondeur en vue couverte par les cascades
+    float splitLambda = 0.7f;       // 0 : tranches égales, 1 : logarithmiques
+    int pcfRadius = 1;              // 0 : une lecture, 1 : PCF 3x3, 2 : PCF 5x5
+    bool cache = true;              // false : toutes les cascades redessinées à chaque frame (comparaison)
+    bool showCascades = false;
+};
+ShadowSettings g_shadowSettings;
+ShadowCascades g_shadowCascades;        // thread de rendu : texture et cache des cascades
+// Objets projetant une ombre : la version change avec la grille instanciée et la scène de benchmark.
+// Les objets de benchmark y sont tous (pas de culling par la caméra) et leur lot n'est reconstruit
+// qu'à ce moment : le cube, la pomme et le bloc immobiles ne redessinent pas les cascades
+uint32_t g_shadowCasterVersion = 0;
+int g_shadowBenchCasters = -1;          // objets de benchmark du lot g_shadowCasterBatch
+ObjectCuller g_shadowCasterCuller;
+MultiDrawBatch g_shadowCasterBatch;     // thread de rendu
+// ----------------------------------------------------------------------------------
+
 // Callback functions for GLFW
 void cursor_position_callback(GLFWwindow* window, double xpos, double ypos);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
@@ -83,12 +292,16 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 void char_callback(GLFWwindow* window, unsigned int c);
 
 
-// Structure to hold 3D model data (VAO, VBO, etc.)
+// Structure to hold 3D model data: its ranges in the shared MeshPool buffers
 struct Model {
-    GLuint vao = 0;
-    GLuint vbo = 0;
-    GLuint ibo = 0;
+    GLuint vao = 0;      // VAO partagé du MeshPool
+    MeshRange mesh;
     int indexCount = 0;
+    float boundingRadius = 0.0f; // sphère englobante centrée sur l'origine du modèle
+    // Buffer des matrices par instance (attributs 3 à 6, divisor 1)
+    GLuint instanceVbo = 0;
+    int instanceCount = 0;
+    uint16_t material = 0; // indice dans le MaterialSystem
 };
 
 struct UniformBlockMatrices {
@@ -100,6 +313,9 @@ Model g_mainModel;
 Model g_secondModel;
 Model g_envModel;
 
+// VBO/IBO partagés par tous les maillages au format Vertex
+MeshPool g_meshPool;
+
 struct Vertex {
     float position[3];
     float normal[3];
@@ -127,11 +343,8 @@ namespace std {
     };
 }
 
-void window_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
-}
-
 GLuint loadTexture(const char* path) {
+    TRACE_SCOPE_DETAIL("loadTexture", path);
     int w, h, n;
     unsigned char* data = stbi_load(path, &w, &h, &n, STBI_rgb_alpha);
     if (!data) {
@@ -159,13 +372,26 @@ void layout() {
     glEnableVertexAttribArray(2);
 }
 
-Model loadObjModel(const std::string& filepath) {
+// Le .mtl et ses textures sont cherchés à côté du .obj ; "fallbackMaterial" sert si le modèle n'en déclare pas
+Model loadObjModel(const std::string& filepath, uint16_t fallbackMaterial) {
+    TRACE_SCOPE_DETAIL("loadObjModel", filepath.c_str());
     Model model;
     tinyobj::attrib_t attrib;
     std::vector<tinyobj::shape_t> shapes;
     std::vector<tinyobj::material_t> materials;
     std::string warn, err;
-    tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str());
+    size_t slash = filepath.find_last_of("/\\");
+    std::string baseDir = (slash == std::string::npos) ? std::string() : filepath.substr(0, slash + 1);
+    tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filepath.c_str(), baseDir.c_str());
+
+    // Un seul matériau par modèle : celui de la première face
+    model.material = fallbackMaterial;
+    if (!shapes.empty() && !shapes[0].mesh.material_ids.empty()) {
+        int materialId = shapes[0].mesh.material_ids[0];
+        if (materialId >= 0 && materialId < (int)materials.size()) {
+            model.material = g_materialSystem.AddFromObj(materials[materialId], baseDir);
+        }
+    }
     
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
@@ -184,37 +410,325 @@ Model loadObjModel(const std::string& filepath) {
             if (index.texcoord_index >= 0) {
                 vertex.uv[0] = attrib.texcoords[2 * index.texcoord_index + 0];
                 vertex.uv[1] = attrib.texcoords[2 * index.texcoord_index + 1];
+            } else {
+                // Pas de coordonnées dans le .obj : projection sphérique autour de l'origine
+                float length = sqrtf(vertex.position[0] * vertex.position[0] + vertex.position[1] * vertex.position[1] + vertex.position[2] * vertex.position[2]);
+                if (length > 0.0f) {
+                    vertex.uv[0] = 0.5f + atan2f(vertex.position[2], vertex.position[0]) / (2.0f * 3.14159265f);
+                    vertex.uv[1] = 0.5f + asinf(vertex.position[1] / length) / 3.14159265f;
+                }
             }
             if (uniqueVertices.count(vertex) == 0) {
                 uniqueVertices[vertex] = static_cast<unsigned int>(vertices.size());
                 vertices.push_back(vertex);
+                float radius = sqrtf(vertex.position[0] * vertex.position[0] + vertex.position[1] * vertex.position[1] + vertex.position[2] * vertex.position[2]);
+                model.boundingRadius = std::max(model.boundingRadius, radius);
             }
             indices.push_back(uniqueVertices[vertex]);
         }
     }
-    model.indexCount = indices.size();
-    glGenVertexArrays(1, &model.vao);
-    glBindVertexArray(model.vao);
-    glGenBuffers(1, &model.vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, model.vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STATIC_DRAW);
-    glGenBuffers(1, &model.ibo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, model.ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-    layout();
-    glBindVertexArray(0);
+    if (g_meshPool.Upload(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size(), model.mesh)) {
+        model.vao = g_meshPool.GetVao();
+        model.indexCount = model.mesh.indexCount;
+    }
     return model;
 }
 
+// Uploads one model matrix per instance. The render queue points attribute locations 3..6
+// of the shared VAO at this buffer when the model is drawn instanced.
+void setInstanceTransforms(Model& model, const std::vector<mat4>& transforms) {
+    if (model.instanceVbo == 0) {
+        glGenBuffers(1, &model.instanceVbo);
+    }
+    // Grille vide : rien à envoyer, le buffer n'est plus lu (attributs d'instance désactivés)
+    if (!transforms.empty()) {
+        glBindBuffer(GL_ARRAY_BUFFER, model.instanceVbo);
+        glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(mat4), transforms[0].getPtr(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    model.instanceCount = (int)transforms.size();
+}
+
+// Square grid of small props laid out under the scene
+std::vector<mat4> buildInstanceGrid(int count) {
+    std::vector<mat4> transforms;
+    transforms.reserve(count);
+    int side = (int)std::ceil(std::sqrt((float)count));
+    float spacing = 0.6f;
+    float origin = -0.5f * spacing * (side - 1);
+    for (int i = 0; i < count; ++i) {
+        float x = origin + spacing * (i % side);
+        float z = origin + spacing * (i / side);
+        transforms.push_back(mat4::translate(x, -2.0f, z) * mat4::rotateY(0.37f * i) * mat4::scale(0.3f, 0.3f, 0.3f));
+    }
+    return transforms;
+}
+
+// Matériaux de la scène de benchmark, attribués en alternance
+const int BENCH_MATERIAL_COUNT = 4;
+uint16_t g_benchMaterials[BENCH_MATERIAL_COUNT];
+
+// Uniforms constants sur la frame, appliqués une fois par changement de programme
+struct FrameUniforms {
+    float cameraPos[3];
+    float lightDirection[3];  // vers la lumière principale
+    bool clusteredLights;  // lumières dynamiques par cluster (sinon toutes, par fragment)
+    bool profileScopeOpen; // section du profileur ouverte pour le programme courant de la file
+};
+
+void applyFrameUniforms(uint32_t program, void* user) {
+    const FrameUniforms* frame = (const FrameUniforms*)user;
+    GLint location;
+    if ((location = glGetUniformLocation(program, "u_lightColor")) >= 0) glUniform3f(location, 1.0f, 1.0f, 1.0f);
+    if ((location = glGetUniformLocation(program, "u_lightDir")) >= 0) glUniform3fv(location, 1, frame->lightDirection);
+    if ((location = glGetUniformLocation(program, "u_viewPos")) >= 0) glUniform3fv(location, 1, frame->cameraPos);
+    if ((location = glGetUniformLocation(program, "u_cameraPos")) >= 0) glUniform3fv(location, 1, frame->cameraPos);
+    if ((location = glGetUniformLocation(program, "u_materialTextures")) >= 0) glUniform1i(location, MaterialSystem::TEXTURE_ARRAY_UNIT);
+    if ((location = glGetUniformLocation(program, "u_envMap")) >= 0) glUniform1i(location, 3);
+    g_lightClusters.SetUniforms(program, g_renderWidth, g_renderHeight, frame->clusteredLights);
+    g_shadowCascades.SetUniforms(program);
+}
+
+// Nom de la section du profileur pour un programme de la file opaque (un type d'objet par programme,
+// dans la passe de scène ou dans le G-buffer)
+const char* queuePassName(uint32_t program) {
+    if (program == g_PhongShader.GetProgram() || program == g_GBufferShader.GetProgram()) return "Phong (cube)";
+    if (program == g_TextureShader.GetProgram() || program == g_GBufferTextureShader.GetProgram()) return "Texture (pomme)";
+    if (program == g_EnvShader.GetProgram() || program == g_GBufferEnvShader.GetProgram()) return "Env map (sphère)";
+    return "Grille instanciée";
+}
+
+// Rappel de la file opaque : la file est triée par programme, une section par changement suffit
+void applyQueueProgram(uint32_t program, void* user) {
+    FrameUniforms* frame = (FrameUniforms*)user;
+    if (frame->profileScopeOpen) {
+        g_profiler.EndScope();
+    }
+    g_profiler.BeginScope(queuePassName(program));
+    frame->profileScopeOpen = true;
+    applyFrameUniforms(program, user);
+}
+
+// Objets de la scène de benchmark : placement fixe, matrices reconstruites à chaque frame
+// pour les seuls objets visibles (ObjectCuller)
+struct BenchObject {
+    const Model* model;
+    uint16_t material;
+};
+std::vector<BenchObject> g_benchObjects;
+std::vector<CullObject> g_benchCullObjects;
+
+// Bloc de cubes et de sphères derrière la scène principale
+void buildBenchScene(int count) {
+    g_benchObjects.clear();
+    g_benchObjects.reserve(count);
+    g_benchCullObjects.clear();
+    g_benchCullObjects.reserve(count);
+    int side = (int)std::ceil(std::cbrt((float)count));
+    float spacing = 0.8f;
+    float origin = -0.5f * spacing * (side - 1);
+    for (int i = 0; i < count; ++i) {
+        BenchObject object;
+        object.model = (i % 2) ? &g_envModel : &g_mainModel;
+        object.material = g_benchMaterials[i % BENCH_MATERIAL_COUNT];
+        g_benchObjects.push_back(object);
+
+        CullObject cull;
+        cull.position[0] = origin + spacing * (i % side);
+        cull.position[1] = origin + spacing * ((i / side) % side);
+        cull.position[2] = origin + spacing * (i / (side * side)) - 15.0f;
+        cull.angle = 0.37f * i;
+        cull.scale = 0.25f;
+        cull.radius = object.model->boundingRadius;
+        g_benchCullObjects.push_back(cull);
+    }
+}
+
+// Lumières dynamiques : paramètres tirés de suites à faible discrépance (même jeu pour un même
+// nombre), orbites autour de l'axe qui traverse la scène principale et le bloc de benchmark
+void updateLights(const LightSettings& settings, float time) {
+    g_lights.resize(settings.count);
+    for (int i = 0; i < settings.count; ++i) {
+        float hue = std::fmod(i * 0.618034f, 1.0f);
+        float orbit = 1.0f + 11.0f * std::fmod(i * 0.7548777f, 1.0f);
+        float height = -6.0f + 12.0f * std::fmod(i * 0.5698403f, 1.0f);
+        float speed = (0.2f + 0.3f * std::fmod(i * 0.381966f, 1.0f)) * ((i % 2) ? -1.0f : 1.0f);
+        float angle = i * 2.399963f + speed * time;
+
+        PointLight& light = g_lights[i];
+        light.position[0] = orbit * std::cos(angle);
+        light.position[1] = height;
+        light.position[2] = orbit * std::sin(angle) - 7.5f;
+        light.radius = settings.radius;
+        // Teinte pure (HSV, saturation et valeur à 1)
+        for (int c = 0; c < 3; ++c) {
+            float k = std::fmod(5.0f - 2.0f * c + hue * 6.0f, 6.0f);
+            float channel = 1.0f - std::max(0.0f, std::min(std::min(k, 4.0f - k), 1.0f));
+            light.color[c] = channel * settings.intensity;
+        }
+        light.padding = 0.0f;
+    }
+}
+
+// Remplissage du lot de benchmark à partir du résultat du culling, une plage d'objets visibles par tâche
+struct BenchBatchFill {
+    MultiDrawBatch* batch;
+    const ObjectCuller* culler;
+};
+
+void fillBenchBatch(void* data, uint32_t begin, uint32_t end) {
+    BenchBatchFill* fill = (BenchBatchFill*)data;
+    const std::vector<uint32_t>& visible = fill->culler->GetVisible();
+    const std::vector<mat4>& transforms = fill->culler->GetTransforms();
+    for (uint32_t i = begin; i < end; ++i) {
+        const BenchObject& object = g_benchObjects[visible[i]];
+        fill->batch->Set(i, object.model->mesh.firstIndex, object.model->mesh.baseVertex, object.model->indexCount,
+                         transforms[i], object.material);
+    }
+}
+
+// Statistiques du rendu, renvoyées au thread principal avec le paquet et affichées par l'interface
+struct RenderFeedback {
+    RenderQueueStats queueStats;
+    MaterialSystemStats materialStats;
+    uint32_t ringFrameBytes = 0;
+    uint32_t ringFrameSize = 0;
+    uint32_t ringWaits = 0;
+    double submitTimeMs[2] = { 0.0, 0.0 };
+    std::vector<ProfileScope> profilerScopes;
+    std::vector<GpuProfiler::ScopeHistory> profilerHistory;
+    uint32_t profilerHistoryOffset = 0;
+    uint32_t profilerDroppedFrames = 0;
+    uint32_t profilerResultFrame = 0;
+    float renderScale = 1.0f;
+    float resolutionGpuMs = 0.0f;
+    uint32_t scaleChanges = 0;
+    int renderWidth = 0, renderHeight = 0;
+    int targetWidth = 0, targetHeight = 0;
+    RenderGraph::Stats graphStats;
+    int taaPhases = 0;        // longueur de la suite de décalages, 0 sans TAA
+    float overdraw = 0.0f;    // fragments ombrés par pixel, mesurés en vue de surdessin
+    uint32_t shadowRenders = 0;       // cascades d'ombre redessinées par cette frame
+    uint32_t shadowTotalRenders = 0;  // et depuis le début
+    float frameMs = 0.0f;     // FramePacer, mesurés au swap
+    float latencyMs = 0.0f;
+};
+
+// Tout ce qu'il faut pour rendre une frame : construit par le thread principal (interface,
+// caméra, file de rendu triée, lot de benchmark), consommé par le thread qui possède le contexte
+// GL, puis rendu au thread principal avec les statistiques. Aucun état n'est partagé entre les
+// deux threads en dehors des paquets.
+struct FramePacket {
+    mat4 view;
+    mat4 projection;
+    float cameraPos[3] = { 0.0f, 0.0f, 0.0f };
+    int outputWidth = 0, outputHeight = 0;
+
+    // LUT d'étalonnage recalculée par le thread principal, seulement quand la chaîne change
+    bool uploadColorLut = false;
+    std::vector<uint8_t> colorLut;
+    int blurRadius = 0;
+    bool blurCompute = false;
+    HdrSettings hdr;
+    AntiAliasingSettings antiAliasing;
+    DepthSettings depth;
+
+    // Matrices de la grille instanciée, seulement quand le nombre d'instances change
+    bool uploadInstances = false;
+    std::vector<mat4> instanceTransforms;
+
+    RenderQueue queue;                 // objets opaques, déjà triés
+    bool benchScene = false;
+    bool benchIndirect = false;
+    double benchPrepareMs = 0.0;
+    MultiDrawBatch benchDraws;         // sans buffers GPU : échangé avec g_benchBatch au rendu
+    LightClusters lightClusters;       // idem avec g_lightClusters
+    bool clusteredLights = true;
+    bool deferred = false;             // G-buffer puis éclairage par pixel (g_deferredLighting)
+    ShadowCascades::Frame shadows;     // lumière principale, projections et réglages des cascades
+    bool uploadShadowCasters = false;  // objets de benchmark projetant une ombre, seulement s'ils changent
+    MultiDrawBatch shadowCasters;      // échangé avec g_shadowCasterBatch au rendu
+
+    std::vector<std::pair<uint16_t, MaterialParams>> materialEdits;
+    bool profilerEnabled = true;
+    ResolutionSettings resolution;
+    int vsyncMode = 1;
+    bool finishAfterSwap = false;
+    double inputSampleMs = 0.0;        // lecture des entrées de cette frame (latence)
+    bool benchmarkFrame = false;       // frame mesurée par g_benchmark sur le thread de rendu
+
+    ImGuiSnapshot ui;
+    bool uiTexturesPending = false;    // textures ImGui à créer : rendu synchrone de ce paquet
+
+    bool rendered = false;             // feedback rempli par le rendu
+    RenderFeedback feedback;
+};
+
+// Deux paquets : le thread principal prépare la frame N+1 pendant le rendu de la frame N
+const int FRAME_PACKET_COUNT = 2;
+FramePacket g_framePackets[FRAME_PACKET_COUNT];
+// Paquets à rendre (principal -> rendu ; nullptr arrête le thread) et paquets rendus (rendu -> principal)
+SpscQueue<FramePacket*, 4> g_submittedPackets;
+SpscQueue<FramePacket*, 4> g_freePackets;
+std::thread g_renderThread;
+bool g_renderThreadEnabled = false;
+// Thread principal : dernières statistiques reçues et temps de construction lissé
+RenderFeedback g_renderFeedback;
+float g_buildMs = 0.0f;
+
+// Ajoute un objet opaque à la file ; la profondeur est la distance caméra -> origine de l'objet
+void submitDraw(RenderQueue& queue, GLuint program, const Model& model, const mat4& transform, uint16_t material,
+                GLenum textureTarget, GLuint texture, GLuint textureUnit, const vec3& cameraPos, int instanceCount = 0) {
+    DrawItem item;
+    vec3 position(transform.m[12], transform.m[13], transform.m[14]);
+    uint32_t depth = RenderQueue::QuantizeDepth((position - cameraPos).length(), 0.01f, 100.0f);
+    item.key = RenderQueue::MakeKey(RenderQueue::PASS_OPAQUE, program, material, texture, model.vao, depth,
+                                    g_depthSettings.frontToBack);
+    item.program = program;
+    item.vao = model.vao;
+    item.textureTarget = textureTarget;
+    item.texture = texture;
+    item.textureUnit = textureUnit;
+    item.indexCount = model.indexCount;
+    item.firstIndex = model.mesh.firstIndex;
+    item.baseVertex = model.mesh.baseVertex;
+    item.instanceCount = instanceCount;
+    item.instanceBuffer = model.instanceVbo;
+    item.material = material;
+    item.model = transform;
+    queue.Submit(item);
+}
+
+// Face de cubemap décodée par une tâche ; l'envoi à GL reste sur le thread du contexte
+struct DecodedImage {
+    const char* path;
+    unsigned char* pixels;
+    int width, height;
+};
+
+void decodeImages(void* data, uint32_t begin, uint32_t end) {
+    DecodedImage* images = (DecodedImage*)data;
+    for (uint32_t i = begin; i < end; ++i) {
+        TRACE_SCOPE_DETAIL("stbi_load", images[i].path);
+        int n;
+        images[i].pixels = stbi_load(images[i].path, &images[i].width, &images[i].height, &n, STBI_rgb_alpha);
+    }
+}
+
 GLuint loadCubemap(const std::vector<std::string>& faces) {
+    TRACE_SCOPE_DETAIL("loadCubemap", faces.empty() ? "" : faces[0].c_str());
+    std::vector<DecodedImage> images(faces.size());
+    for (size_t i = 0; i < faces.size(); ++i) {
+        images[i].path = faces[i].c_str();
+    }
+    g_jobSystem.ParallelFor((uint32_t)images.size(), 1, decodeImages, images.data());
+
     GLuint texID;
     glGenTextures(1, &texID);
     glBindTexture(GL_TEXTURE_CUBE_MAP, texID);
-    int w, h, n;
-    for (GLuint i = 0; i < faces.size(); i++) {
-        unsigned char* data = stbi_load(faces[i].c_str(), &w, &h, &n, STBI_rgb_alpha);
-        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        stbi_image_free(data);
+    for (GLuint i = 0; i < images.size(); i++) {
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, images[i].width, images[i].height, 0, GL_RGBA, GL_UNSIGNED_BYTE, images[i].pixels);
+        stbi_image_free(images[i].pixels);
     }
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -224,9 +738,33 @@ GLuint loadCubemap(const std::vector<std::string>& faces) {
     return texID;
 }
 
+// Points de liaison des blocs uniformes (pas de layout(binding) en GLSL 330)
+void bindUniformBlocks(GLuint program) {
+    if (program == 0) {
+        return;
+    }
+    GLuint matricesIndex = glGetUniformBlockIndex(program, "Matrices");
+    if (matricesIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, matricesIndex, UNIFORM_BINDING_MATRICES);
+    }
+    GLuint objectIndex = glGetUniformBlockIndex(program, "Object");
+    if (objectIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, objectIndex, UNIFORM_BINDING_OBJECT);
+    }
+    GLuint materialsIndex = glGetUniformBlockIndex(program, "Materials");
+    if (materialsIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, materialsIndex, UNIFORM_BINDING_MATERIALS);
+    }
+    GLuint handlesIndex = glGetUniformBlockIndex(program, "MaterialHandles");
+    if (handlesIndex != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, handlesIndex, UNIFORM_BINDING_MATERIAL_HANDLES);
+    }
+}
+
 bool Initialise() {
-    g_BasicShader.LoadVertexShader("shaders/basic.vs");
-    g_BasicShader.LoadFragmentShader("shaders/basic.fs");
+    TRACE_SCOPE("Initialise");
+    g_BasicShader.LoadVertexShader("shaders/Basic.vs");
+    g_BasicShader.LoadFragmentShader("shaders/Basic.fs");
     g_BasicShader.Create();
 
     g_TextureShader.LoadVertexShader("shaders/texture.vs");
@@ -250,11 +788,76 @@ bool Initialise() {
     g_ScreenQuadShader.LoadFragmentShader("shaders/screen_quad.fs");
     g_ScreenQuadShader.Create();
 
-    glGenBuffers(1, &g_uboMatrices);
-    glBindBuffer(GL_UNIFORM_BUFFER, g_uboMatrices);
-    glBufferData(GL_UNIFORM_BUFFER, sizeof(UniformBlockMatrices), NULL, GL_DYNAMIC_DRAW);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
-    glBindBufferBase(GL_UNIFORM_BUFFER, 0, g_uboMatrices);
+    g_PhongInstancedShader.LoadVertexShader("shaders/phong_instanced.vs");
+    g_PhongInstancedShader.LoadFragmentShader("shaders/phong.fs");
+    g_PhongInstancedShader.Create();
+
+    g_TextureInstancedShader.LoadVertexShader("shaders/texture_instanced.vs");
+    g_TextureInstancedShader.LoadFragmentShader("shaders/texture.fs");
+    g_TextureInstancedShader.Create();
+
+    g_EnvInstancedShader.LoadVertexShader("shaders/env_instanced.vs");
+    g_EnvInstancedShader.LoadFragmentShader("shaders/env.fs");
+    g_EnvInstancedShader.Create();
+
+    DetectGLCaps();
+    if (GetGLCaps().multiDrawIndirect) {
+        g_PhongMdiShader.LoadVertexShader("shaders/phong_mdi.vs");
+        // Handles bindless si disponibles, sinon le tableau de textures partagé
+        g_bindlessMaterials = GetGLCaps().bindlessTexture && g_PhongMdiShader.LoadFragmentShader("shaders/phong_mdi_bindless.fs");
+        if (!g_bindlessMaterials) {
+            g_PhongMdiShader.LoadFragmentShader("shaders/phong_mdi.fs");
+        }
+        g_PhongMdiShader.Create();
+        g_DepthMdiShader.LoadVertexShader("shaders/depth_only_mdi.vs");
+        g_DepthMdiShader.LoadFragmentShader("shaders/depth_only.fs");
+        g_DepthMdiShader.Create();
+    }
+    g_DepthShader.LoadVertexShader("shaders/depth_only.vs");
+    g_DepthShader.LoadFragmentShader("shaders/depth_only.fs");
+    g_DepthShader.Create();
+    g_DepthInstancedShader.LoadVertexShader("shaders/depth_only_instanced.vs");
+    g_DepthInstancedShader.LoadFragmentShader("shaders/depth_only.fs");
+    g_DepthInstancedShader.Create();
+
+    // G-buffer : mêmes vertex shaders, une sortie par cible (DeferredLighting)
+    g_GBufferShader.LoadVertexShader("shaders/phong.vs");
+    g_GBufferShader.LoadFragmentShader("shaders/gbuffer.fs");
+    g_GBufferShader.Create();
+    g_GBufferInstancedShader.LoadVertexShader("shaders/phong_instanced.vs");
+    g_GBufferInstancedShader.LoadFragmentShader("shaders/gbuffer.fs");
+    g_GBufferInstancedShader.Create();
+    g_GBufferTextureShader.LoadVertexShader("shaders/texture.vs");
+    g_GBufferTextureShader.LoadFragmentShader("shaders/gbuffer_texture.fs");
+    g_GBufferTextureShader.Create();
+    g_GBufferTextureInstancedShader.LoadVertexShader("shaders/texture_instanced.vs");
+    g_GBufferTextureInstancedShader.LoadFragmentShader("shaders/gbuffer_texture.fs");
+    g_GBufferTextureInstancedShader.Create();
+    g_GBufferEnvShader.LoadVertexShader("shaders/env.vs");
+    g_GBufferEnvShader.LoadFragmentShader("shaders/gbuffer_env.fs");
+    g_GBufferEnvShader.Create();
+    g_GBufferEnvInstancedShader.LoadVertexShader("shaders/env_instanced.vs");
+    g_GBufferEnvInstancedShader.LoadFragmentShader("shaders/gbuffer_env.fs");
+    g_GBufferEnvInstancedShader.Create();
+    if (GetGLCaps().multiDrawIndirect) {
+        g_GBufferMdiShader.LoadVertexShader("shaders/phong_mdi.vs");
+        g_GBufferMdiShader.LoadFragmentShader("shaders/gbuffer_mdi.fs");
+        g_GBufferMdiShader.Create();
+    }
+    g_benchBatch.Create(GetGLCaps().multiDrawIndirect && g_PhongMdiShader.GetProgram() != 0);
+    g_shadowCasterBatch.Create(GetGLCaps().multiDrawIndirect && g_DepthMdiShader.GetProgram() != 0);
+
+    GLShader* blockShaders[] = { &g_BasicShader, &g_TextureShader, &g_EnvShader, &g_PhongShader,
+                                 &g_PhongInstancedShader, &g_TextureInstancedShader, &g_EnvInstancedShader, &g_PhongMdiShader,
+                                 &g_DepthShader, &g_DepthInstancedShader, &g_DepthMdiShader,
+                                 &g_GBufferShader, &g_GBufferInstancedShader, &g_GBufferTextureShader,
+                                 &g_GBufferTextureInstancedShader, &g_GBufferEnvShader, &g_GBufferEnvInstancedShader,
+                                 &g_GBufferMdiShader };
+    for (size_t i = 0; i < sizeof(blockShaders) / sizeof(blockShaders[0]); ++i) {
+        bindUniformBlocks(blockShaders[i]->GetProgram());
+    }
+    // 4 Mo par frame : ~16000 blocs Object avec un alignement de 256 octets
+    g_uniformRing.Create(4 * 1024 * 1024, GetGLCaps().bufferStorage);
 
     float skyboxVertices[] = {
         -1.0f,  1.0f, -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, -1.0f, -1.0f,
@@ -279,41 +882,60 @@ bool Initialise() {
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glBindVertexArray(0);
 
-    #ifdef WIN32
-    wglSwapIntervalEXT(1);
-    #endif
-
-    secondTex = loadTexture("assets/3DApple002_SQ-1K-PNG/3DApple002_SQ-1K-PNG_Color.png");    
-
-    g_mainModel = loadObjModel("assets/cube.obj");
-    g_secondModel = loadObjModel("assets/3DApple002_SQ-1K-PNG/3DApple002_SQ-1K-PNG.obj");
-    g_envModel = loadObjModel("assets/sphere.obj");
+    // Matériaux sans .mtl ; celui de la pomme vient de son fichier .mtl
+    g_materialSystem.Create(UNIFORM_BINDING_MATERIALS, UNIFORM_BINDING_MATERIAL_HANDLES, loadTexture);
+    uint16_t cubeMaterial = g_materialSystem.Add("cube", MaterialSystem::MakeParams(0.0f, 0.0f, 1.0f, 32.0f));
+    uint16_t chromeMaterial = g_materialSystem.Add("chrome", MaterialSystem::MakeParams(1.0f, 1.0f, 1.0f, 32.0f));
+    uint16_t defaultMaterial = g_materialSystem.Add("default", MaterialSystem::MakeParams(1.0f, 1.0f, 1.0f, 32.0f));
+    g_benchMaterials[0] = g_materialSystem.Add("bench_red", MaterialSystem::MakeParams(0.8f, 0.1f, 0.1f, 16.0f));
+    g_benchMaterials[1] = g_materialSystem.Add("bench_green", MaterialSystem::MakeParams(0.1f, 0.8f, 0.1f, 32.0f));
+    g_benchMaterials[2] = g_materialSystem.Add("bench_yellow", MaterialSystem::MakeParams(0.9f, 0.8f, 0.1f, 64.0f));
+    g_benchMaterials[3] = g_materialSystem.Add("bench_purple", MaterialSystem::MakeParams(0.8f, 0.1f, 0.8f, 8.0f));
+
+    // 256K sommets / 1M indices au départ ; le pool double de taille si nécessaire
+    g_meshPool.Create(sizeof(Vertex), 256 * 1024, 1024 * 1024, layout);
+    g_mainModel = loadObjModel("assets/cube.obj", cubeMaterial);
+    g_secondModel = loadObjModel("assets/3DApple002_SQ-1K-PNG/3DApple002_SQ-1K-PNG.obj", defaultMaterial);
+    g_envModel = loadObjModel("assets/sphere.obj", chromeMaterial);
+
+    // Deux matériaux du benchmark texturés : même taille que la pomme, donc dans le même tableau
+    g_materialSystem.SetDiffuseMap(g_benchMaterials[1], "assets/dragon.png");
+    g_materialSystem.SetDiffuseMap(g_benchMaterials[2], "assets/3DApple002_SQ-1K-PNG/3DApple002_SQ-1K-PNG_Color.png");
+    g_materialSystem.BuildTextureArray(g_bindlessMaterials);
+    for (size_t i = 0; i < g_materialSystem.GetCount(); ++i) {
+        g_materialEditorParams.push_back(g_materialSystem.Get((uint16_t)i).params);
+    }
+    // Créé d'avance : la file de rendu, construite sur le thread principal, lit son identifiant
+    glGenBuffers(1, &g_mainModel.instanceVbo);
     
     envCubemap = loadCubemap({ "assets/cloudy/bluecloud_rt.jpg", "assets/cloudy/bluecloud_lf.jpg", "assets/cloudy/bluecloud_up.jpg", "assets/cloudy/bluecloud_dn.jpg", "assets/cloudy/bluecloud_ft.jpg", "assets/cloudy/bluecloud_bk.jpg" });
     sphereCubemap = loadCubemap({ "assets/Yokohama3/posx.jpg", "assets/Yokohama3/negx.jpg", "assets/Yokohama3/posy.jpg", "assets/Yokohama3/negy.jpg", "assets/Yokohama3/posz.jpg", "assets/Yokohama3/negz.jpg" });
 
-    // FBO setup
-    glGenFramebuffers(1, &g_fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, g_fbo);
-
-    // Create a color attachment texture
-    glGenTextures(1, &g_fboTexture);
-    glBindTexture(GL_TEXTURE_2D, g_fboTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, FBO_WIDTH, FBO_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // Prevent sampling outside bounds
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE); // Prevent sampling outside bounds
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, g_fboTexture, 0);
-
-    // Create a renderbuffer object for depth and stencil attachment
-    glGenRenderbuffers(1, &g_rboDepthStencil);
-    glBindRenderbuffer(GL_RENDERBUFFER, g_rboDepthStencil);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, FBO_WIDTH, FBO_HEIGHT);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, g_rboDepthStencil);
-
-    glCheckFramebufferStatus(GL_FRAMEBUFFER);
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // Bind back to default framebuffer
+    // Cibles de scène : allouées par le graphe de rendu à la première frame
+    g_sceneTargetWidth = FBO_WIDTH;
+    g_sceneTargetHeight = FBO_HEIGHT;
+
+    // LUT d'étalonnage, remplie au premier paquet (identité tant qu'aucune opération n'est active)
+    glGenTextures(1, &g_colorLut);
+    glBindTexture(GL_TEXTURE_3D, g_colorLut);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA8, ColorGrading::LUT_SIZE, ColorGrading::LUT_SIZE, ColorGrading::LUT_SIZE, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_3D, 0);
+
+    g_blur.Create();
+    g_bloom.Create();
+    g_autoExposure.Create();
+    g_temporalAA.Create();
+    g_overdrawView.Create();
+    g_lightClusters.Create();
+    g_shadowCascades.Create();
+    g_deferredLighting.Create();
+    bindUniformBlocks(g_deferredLighting.GetProgram());
 
     // Screen quad setup
     float quadVertices[] = {
@@ -354,127 +976,1002 @@ bool Initialise() {
     ImGui::StyleColorsDark();
 
     // Setup Platform/Renderer backends - IMPORTANT: Pass false here to manually forward events
-    ImGui_ImplGlfw_InitForOpenGL(g_window, false);
+    if (!g_headless) {
+        ImGui_ImplGlfw_InitForOpenGL(g_window, false);
+    }
     ImGui_ImplOpenGL3_Init("#version 330 core");
     // ----------------------------
 
     return true;
 }
 
-void Render()
-{
+// Frise CPU/GPU de la dernière frame relue, moyennes et historique glissant
+void drawProfilerWindow() {
+    ImGui::SetNextWindowPos(ImVec2(714, 260), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(300, 490), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Profileur");
+    ImGui::Checkbox("Actif", &g_profilerEnabled);
+    ImGui::SameLine();
+    ImGui::Text("%u frames abandonnées", g_renderFeedback.profilerDroppedFrames);
+    if (!Trace::IsRecording()) {
+        if (ImGui::Button("Démarrer une trace")) {
+            Trace::Start();
+        }
+    } else if (ImGui::Button("Arrêter la trace")) {
+        Trace::Stop();
+        if (!Trace::WriteJson(g_tracePath)) {
+            fprintf(stderr, "impossible d'écrire %s\n", g_tracePath);
+        }
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled("%s", g_tracePath);
+    ImGui::Text("Thread principal : %.3f ms (%s)", g_buildMs, g_renderThreadEnabled ? "thread de rendu" : "thread unique");
+
+    const std::vector<ProfileScope>& scopes = g_renderFeedback.profilerScopes;
+    if (scopes.empty()) {
+        ImGui::TextDisabled("En attente des résultats GPU");
+        ImGui::End();
+        return;
+    }
+
+    // Une ligne par profondeur ; même échelle pour le CPU et le GPU
+    float frameMs = std::max(scopes[0].cpuMs, scopes[0].gpuMs);
+    int maxDepth = 0;
+    for (size_t i = 0; i < scopes.size(); ++i) {
+        maxDepth = std::max(maxDepth, scopes[i].depth);
+    }
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    float width = ImGui::GetContentRegionAvail().x;
+    const float rowHeight = 18.0f;
+    for (int track = 0; track < 2; ++track) {
+        ImGui::Text(track == 0 ? "CPU : %.3f ms" : "GPU : %.3f ms", track == 0 ? scopes[0].cpuMs : scopes[0].gpuMs);
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        for (size_t i = 0; i < scopes.size(); ++i) {
+            const ProfileScope& scope = scopes[i];
+            float start = track == 0 ? scope.cpuStartMs : scope.gpuStartMs;
+            float duration = track == 0 ? scope.cpuMs : scope.gpuMs;
+            ImVec2 min(origin.x + width * start / frameMs, origin.y + scope.depth * rowHeight);
+            ImVec2 max(std::max(min.x + 1.0f, min.x + width * duration / frameMs), min.y + rowHeight - 1.0f);
+            // Couleur stable par section : teinte dérivée de l'adresse du nom
+            float hue = (float)(((uintptr_t)scope.name >> 3) % 17) / 17.0f;
+            drawList->AddRectFilled(min, max, ImColor::HSV(hue, 0.55f, 0.75f));
+            ImVec2 textSize = ImGui::CalcTextSize(scope.name);
+            if (max.x - min.x > textSize.x + 4.0f) {
+                drawList->AddText(ImVec2(min.x + 2.0f, min.y + 1.0f), IM_COL32(255, 255, 255, 255), scope.name);
+            }
+            if (ImGui::IsMouseHoveringRect(min, max)) {
+                ImGui::SetTooltip("%s\nCPU %.3f ms  GPU %.3f ms", scope.name, scope.cpuMs, scope.gpuMs);
+            }
+        }
+        ImGui::Dummy(ImVec2(width, (maxDepth + 1) * rowHeight));
+    }
+
+    // Moyennes sur l'historique (frames où la section existe)
+    ImGui::Separator();
+    const std::vector<GpuProfiler::ScopeHistory>& history = g_renderFeedback.profilerHistory;
+    if (ImGui::BeginTable("passes", 3, ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Passe", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("CPU ms", ImGuiTableColumnFlags_WidthFixed, 55.0f);
+        ImGui::TableSetupColumn("GPU ms", ImGuiTableColumnFlags_WidthFixed, 55.0f);
+        ImGui::TableHeadersRow();
+        for (size_t h = 0; h < history.size(); ++h) {
+            float cpuTotal = 0.0f, gpuTotal = 0.0f;
+            int samples = 0;
+            for (uint32_t k = 0; k < GpuProfiler::HISTORY_SIZE; ++k) {
+                if (history[h].cpuMs[k] > 0.0f || history[h].gpuMs[k] > 0.0f) {
+                    cpuTotal += history[h].cpuMs[k];
+                    gpuTotal += history[h].gpuMs[k];
+                    samples++;
+                }
+            }
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(history[h].name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", samples ? cpuTotal / samples : 0.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", samples ? gpuTotal / samples : 0.0f);
+        }
+        ImGui::EndTable();
+    }
+
+    // Historique de la frame entière (première section enregistrée)
+    if (!history.empty()) {
+        ImGui::PlotLines("CPU", history[0].cpuMs, GpuProfiler::HISTORY_SIZE, g_renderFeedback.profilerHistoryOffset, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+        ImGui::PlotLines("GPU", history[0].gpuMs, GpuProfiler::HISTORY_SIZE, g_renderFeedback.profilerHistoryOffset, nullptr, 0.0f, FLT_MAX, ImVec2(0, 40));
+    }
+    ImGui::End();
+}
+
+// Temps GPU de la scène par chemin d'éclairage et par nombre d'échantillons, relevés dans chaque
+// nouvelle frame du profileur : chaque réglage garde sa dernière mesure pour comparer les coûts après coup
+void updateSceneTimings(const RenderFeedback& feedback) {
+    if (feedback.profilerResultFrame == g_sceneTimingsFrame) {
+        return;
+    }
+    g_sceneTimingsFrame = feedback.profilerResultFrame;
+    // Chemins d'éclairage : seul celui de la frame mesurée a des sections
+    float pathGpuMs[SHADING_PATH_COUNT] = { 0.0f, 0.0f };
+    bool pathMeasured[SHADING_PATH_COUNT] = { false, false };
+    for (size_t i = 0; i < feedback.profilerScopes.size(); ++i) {
+        const ProfileScope& scope = feedback.profilerScopes[i];
+        for (int mode = 0; mode < MSAA_MODE_COUNT; ++mode) {
+            if (scope.name == MSAA_SCENE_SCOPES[mode] || scope.name == MSAA_RESOLVE_SCOPES[mode]) {
+                pathGpuMs[0] += scope.gpuMs;
+                pathMeasured[0] = true;
+            }
+        }
+        for (size_t j = 0; j < sizeof(DEFERRED_SCOPES) / sizeof(DEFERRED_SCOPES[0]); ++j) {
+            if (scope.name == DEFERRED_SCOPES[j]) {
+                pathGpuMs[1] += scope.gpuMs;
+                pathMeasured[1] = true;
+            }
+        }
+    }
+    for (int path = 0; path < SHADING_PATH_COUNT; ++path) {
+        if (pathMeasured[path]) {
+            float& smoothed = g_shadingGpuMs[path];
+            smoothed = smoothed == 0.0f ? pathGpuMs[path] : smoothed * 0.9f + pathGpuMs[path] * 0.1f;
+        }
+    }
+
+    for (int mode = 0; mode < MSAA_MODE_COUNT; ++mode) {
+        float gpuMs = 0.0f;
+        bool measured = false;
+        for (size_t i = 0; i < feedback.profilerScopes.size(); ++i) {
+            const ProfileScope& scope = feedback.profilerScopes[i];
+            if (scope.name == MSAA_SCENE_SCOPES[mode] || scope.name == MSAA_RESOLVE_SCOPES[mode]) {
+                gpuMs += scope.gpuMs;
+                measured = true;
+            }
+        }
+        if (measured) {
+            g_msaaGpuMs[mode] = g_msaaGpuMs[mode] == 0.0f ? gpuMs : g_msaaGpuMs[mode] * 0.9f + gpuMs * 0.1f;
+        }
+    }
+}
+
+// Thread principal : interface, caméra et préparation de la scène dans le paquet, sans appel GL.
+// Les statistiques affichées sont celles du dernier rendu de ce paquet (une à deux frames de retard).
+void buildFramePacket(FramePacket& packet) {
+    TRACE_SCOPE("Construction de la frame");
+    double buildStart = Trace::NowUs() / 1000.0;
+    if (packet.rendered) {
+        std::swap(g_renderFeedback, packet.feedback);
+        packet.rendered = false;
+    }
+    packet.materialEdits.clear();
+    const RenderFeedback& feedback = g_renderFeedback;
+    updateSceneTimings(feedback);
+
     // --- ImGui New Frame ---
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
+    if (g_headless) {
+        // Pas de backend plateforme : taille et pas de temps fixes
+        ImGui::GetIO().DisplaySize = ImVec2((float)FBO_WIDTH, (float)FBO_HEIGHT);
+        ImGui::GetIO().DeltaTime = 1.0f / 60.0f;
+    } else {
+        ImGui_ImplGlfw_NewFrame();
+    }
     ImGui::NewFrame();
 
     // --- ImGui UI for Post-processing ---
     ImGui::SetNextWindowPos(ImVec2(10, 10), ImGuiCond_FirstUseEver); // Position (x, y) et condition
-    ImGui::SetNextWindowSize(ImVec2(300, 250), ImGuiCond_FirstUseEver); // Taille (largeur, hauteur) et condition
+    ImGui::SetNextWindowSize(ImVec2(300, 300), ImGuiCond_FirstUseEver); // Taille (largeur, hauteur) et condition
     ImGui::Begin("Options de Post-traitement");
     ImGui::Text("Choisissez un effet :");
     ImGui::RadioButton("Aucun", &g_selectedPostProcessEffect, 0);
     ImGui::RadioButton("Niveaux de gris", &g_selectedPostProcessEffect, 1);
     ImGui::RadioButton("Inverser couleurs", &g_selectedPostProcessEffect, 2);
     ImGui::RadioButton("Sépia", &g_selectedPostProcessEffect, 3);
-    
+
     ImGui::Separator(); // Add a separator for better visual organization
     ImGui::Text("Colorimétrie :");
     // Sliders for saturation and contrast
     ImGui::SliderFloat("Saturation", &g_saturation, 0.0f, 2.0f, "%.3f"); // Range from 0.0 (desaturated) to 2.0 (super saturated)
     ImGui::SliderFloat("Contraste", &g_contrast, 0.0f, 2.0f, "%.3f");   // Range from 0.0 (no contrast) to 2.0 (high contrast)
 
+    // Chaîne d'opérations : les réglages neutres sont omis
+    g_colorOperations.clear();
+    if (g_selectedPostProcessEffect >= 1 && g_selectedPostProcessEffect <= 3) {
+        const ColorOperationType effects[] = { COLOR_GRAYSCALE, COLOR_INVERT, COLOR_SEPIA };
+        ColorOperation effect = { effects[g_selectedPostProcessEffect - 1], 0.0f };
+        g_colorOperations.push_back(effect);
+    }
+    if (g_saturation != 1.0f) {
+        ColorOperation saturation = { COLOR_SATURATION, g_saturation };
+        g_colorOperations.push_back(saturation);
+    }
+    if (g_contrast != 1.0f) {
+        ColorOperation contrast = { COLOR_CONTRAST, g_contrast };
+        g_colorOperations.push_back(contrast);
+    }
+    packet.uploadColorLut = g_colorGrading.SetOperations(g_colorOperations);
+    if (packet.uploadColorLut) {
+        g_colorGrading.Bake(g_jobSystem, packet.colorLut);
+    }
+    ImGui::Text("LUT %d³ : %d op., %u calculs (%.2f ms)", ColorGrading::LUT_SIZE,
+                (int)g_colorOperations.size(), g_colorGrading.GetBakeCount(), g_colorGrading.GetBakeMs());
+
+    ImGui::Separator();
+    ImGui::SliderInt("Flou", &g_blurRadius, 0, SeparableBlur::MAX_RADIUS, g_blurRadius == 0 ? "aucun" : "%d px");
+    if (g_blur.HasCompute()) {
+        int blurPath = g_blurCompute ? 1 : 0;
+        ImGui::RadioButton("Fragment", &blurPath, 0);
+        ImGui::SameLine();
+        ImGui::RadioButton("Compute (tuiles)", &blurPath, 1);
+        g_blurCompute = blurPath == 1;
+    } else {
+        ImGui::TextDisabled("Compute shaders indisponibles : passes fragment");
+    }
+    packet.blurRadius = g_blurRadius;
+    packet.blurCompute = g_blurCompute && g_blur.HasCompute();
+
     ImGui::End();
     // ------------------------------------
 
-    // --- Pass 1: Render scene to FBO ---
-    glBindFramebuffer(GL_FRAMEBUFFER, g_fbo);
-    glViewport(0, 0, FBO_WIDTH, FBO_HEIGHT);
-    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // --- ImGui UI for the instanced grid ---
+    ImGui::SetNextWindowPos(ImVec2(10, 320), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(340, 440), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Rendu");
+    ImGui::SliderInt("Instances", &g_instanceCount, 0, 10000);
+    ImGui::RadioButton("Phong", &g_instanceShader, 0); ImGui::SameLine();
+    ImGui::RadioButton("Texture", &g_instanceShader, 1); ImGui::SameLine();
+    ImGui::RadioButton("Env map", &g_instanceShader, 2);
+    ImGui::Separator();
+    ImGui::Checkbox("Trier la file de rendu", &g_sortRenderQueue);
+    ImGui::SameLine();
+    ImGui::Checkbox("Avant-arrière", &g_depthSettings.frontToBack);
+    ImGui::Checkbox("Pré-passe de profondeur", &g_depthSettings.prepass);
+    ImGui::SameLine();
+    ImGui::Checkbox("Surdessin", &g_depthSettings.overdraw);
+    if (g_depthSettings.overdraw) {
+        ImGui::Text("Fragments ombrés : %.2f par pixel", feedback.overdraw);
+    }
+    int shadingPath = g_deferredShading ? 1 : 0;
+    ImGui::Text("Éclairage :");
+    ImGui::SameLine();
+    ImGui::RadioButton("Forward", &shadingPath, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Différé (G-buffer)", &shadingPath, 1);
+    g_deferredShading = shadingPath == 1;
+    if (ImGui::BeginTable("shading", 3, ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("GPU scène (ms)");
+        ImGui::TableSetupColumn("Forward");
+        ImGui::TableSetupColumn("Différé");
+        ImGui::TableHeadersRow();
+        ImGui::TableNextColumn();
+        ImGui::TextDisabled("passes de scène");
+        for (int path = 0; path < SHADING_PATH_COUNT; ++path) {
+            ImGui::TableNextColumn();
+            if (g_shadingGpuMs[path] > 0.0f) {
+                ImGui::Text("%.2f", g_shadingGpuMs[path]);
+            } else {
+                ImGui::TextDisabled("-");
+            }
+        }
+        ImGui::EndTable();
+    }
+    if (g_deferredShading && g_antiAliasingSettings.msaaSamples > 1) {
+        ImGui::TextDisabled("Rendu différé : MSAA ignoré");
+    }
+    const RenderQueueStats& queueStats = feedback.queueStats;
+    ImGui::Text("Dessins : %d", queueStats.draws);
+    ImGui::Text("Programmes : %d (%d évités)", queueStats.programBinds, queueStats.programBindsSaved);
+    ImGui::Text("Textures : %d (%d évitées)", queueStats.textureBinds, queueStats.textureBindsSaved);
+    ImGui::Text("VAO : %d (%d évités)", queueStats.vaoBinds, queueStats.vaoBindsSaved);
+    MeshPoolStats poolStats = g_meshPool.GetStats();
+    ImGui::Text("Mesh pool : %u/%u sommets", poolStats.verticesUsed, poolStats.vertexCapacity);
+    ImGui::Text("            %u/%u indices", poolStats.indicesUsed, poolStats.indexCapacity);
+    ImGui::Separator();
+    ImGui::Text("Contexte OpenGL %d.%d", GetGLCaps().major, GetGLCaps().minor);
+    ImGui::Checkbox("Scène benchmark", &g_benchScene);
+    ImGui::SliderInt("Objets", &g_benchObjectCount, 1000, 20000);
+    ImGui::RadioButton("Boucle", &g_submitMode, 0); ImGui::SameLine();
+    ImGui::RadioButton("MultiDraw indirect", &g_submitMode, 1);
+    if (!g_benchBatch.IsIndirectAvailable()) {
+        ImGui::TextDisabled("MultiDraw indirect indisponible : boucle utilisée");
+    }
+    ImGui::Text("Soumission CPU (boucle) : %.3f ms", feedback.submitTimeMs[0]);
+    ImGui::Text("Soumission CPU (MDI)    : %.3f ms", feedback.submitTimeMs[1]);
+    ImGui::Checkbox("Culling par frustum", &g_benchCulling);
+    ImGui::Text("Visibles : %u / %d", g_benchVisibleCount, (int)g_benchCullObjects.size());
+    JobSystem::Stats jobStats = g_jobSystem.GetStats();
+    ImGui::Text("Tâches : %u threads, %u exécutées (%u volées)", g_jobSystem.GetThreadCount(), jobStats.executed, jobStats.stolen);
+    ImGui::Separator();
+    ImGui::Text("Anneau d'uniforms : %s", g_uniformRing.IsPersistent() ? "mapping persistant" : "orphaning");
+    ImGui::Text("  %.1f Ko / %u Ko par frame, %u attentes GPU", feedback.ringFrameBytes / 1024.0f,
+                feedback.ringFrameSize / 1024, feedback.ringWaits);
+    ImGui::End();
 
-    float aspectRatio = (FBO_HEIGHT > 0) ? ((float)FBO_WIDTH / FBO_HEIGHT) : 1.0f;
+    // --- Éditeur de matériaux : seules les modifications effectives sont envoyées au rendu ---
+    ImGui::SetNextWindowPos(ImVec2(714, 10), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(300, 240), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Matériaux");
+    int materialCount = (int)g_materialEditorParams.size();
+    if (materialCount > 0) {
+        if (g_editedMaterial >= materialCount) {
+            g_editedMaterial = 0;
+        }
+        // Les noms ne changent plus après Initialise : lecture sans risque depuis ce thread
+        const Material& edited = g_materialSystem.Get((uint16_t)g_editedMaterial);
+        if (ImGui::BeginCombo("Matériau", edited.name.c_str())) {
+            for (int i = 0; i < materialCount; ++i) {
+                if (ImGui::Selectable(g_materialSystem.Get((uint16_t)i).name.c_str(), i == g_editedMaterial)) {
+                    g_editedMaterial = i;
+                }
+            }
+            ImGui::EndCombo();
+        }
+        MaterialParams& params = g_materialEditorParams[g_editedMaterial];
+        bool changed = ImGui::ColorEdit3("Diffuse", params.diffuse);
+        changed |= ImGui::ColorEdit3("Spéculaire", params.specular);
+        changed |= ImGui::SliderFloat("Brillance", &params.specular[3], 1.0f, 256.0f, "%.0f");
+        if (changed) {
+            packet.materialEdits.push_back(std::make_pair((uint16_t)g_editedMaterial, params));
+        }
+    }
+    const MaterialSystemStats& materialStats = feedback.materialStats;
+    ImGui::Text("Uploads : %d (dernier : %u octets)", materialStats.uploads, materialStats.lastUploadBytes);
+    ImGui::Text("Textures : %d chargées / %d demandées", materialStats.texturesLoaded, materialStats.textureRequests);
+    ImGui::Text("Tableau : %d couches (%d rejetées)", materialStats.arrayLayers, materialStats.arrayRejected);
+    ImGui::Text("Handles bindless : %s", g_materialSystem.IsBindless() ? "oui" : "non");
+    ImGui::End();
+
+    drawProfilerWindow();
+
+    // --- Cadence et latence (mode fenêtré) ---
+    if (!g_headless) {
+        ImGui::SetNextWindowPos(ImVec2(360, 10), ImGuiCond_FirstUseEver);
+        ImGui::SetNextWindowSize(ImVec2(300, 190), ImGuiCond_FirstUseEver);
+        ImGui::Begin("Cadence");
+        ImGui::Text("Vsync :");
+        ImGui::SameLine(); ImGui::RadioButton("Non", &g_vsyncMode, 0);
+        ImGui::SameLine(); ImGui::RadioButton("Oui", &g_vsyncMode, 1);
+        ImGui::SameLine(); ImGui::RadioButton("Adaptative", &g_vsyncMode, 2);
+        if (g_vsyncMode == 2 && !g_adaptiveVsyncSupported) {
+            ImGui::TextDisabled("Adaptative indisponible : vsync classique");
+        }
+        ImGui::SliderInt("Limite FPS", &g_fpsCap, 0, 240, g_fpsCap == 0 ? "aucune" : "%d");
+        ImGui::Checkbox("glFinish après le swap", &g_finishAfterSwap);
+        ImGui::Text("Frame : %.2f ms (%.0f fps)", feedback.frameMs, feedback.frameMs > 0.0f ? 1000.0f / feedback.frameMs : 0.0f);
+        ImGui::Text("Latence entrées -> swap : %.2f ms", feedback.latencyMs);
+        ImGui::Text("Attente : %.2f ms sommeil + %.2f ms active", g_framePacer.GetSleepMs(), g_framePacer.GetSpinMs());
+        ImGui::End();
+    }
+
+    // --- Résolution interne de la scène : l'upscale est fait par la passe du quad plein écran ---
+    ImGui::SetNextWindowPos(ImVec2(360, 500), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(340, 260), ImGuiCond_FirstUseEver);
+    ImGui::Begin("Résolution");
+    ResolutionSettings& resolution = g_resolutionSettings;
+    AntiAliasingSettings& antiAliasing = g_antiAliasingSettings;
+    int previousAntiAliasing = antiAliasing.mode;
+    ImGui::Text("Anti-aliasing :");
+    ImGui::SameLine(); ImGui::RadioButton("Aucun", &antiAliasing.mode, 0);
+    ImGui::SameLine(); ImGui::RadioButton("TAA", &antiAliasing.mode, 1);
+    ImGui::SameLine(); ImGui::RadioButton("Upscale", &antiAliasing.mode, 2);
+    // Passage à l'upscale depuis la pleine résolution : échelle de départ de 2/3 par axe
+    if (antiAliasing.mode == 2 && previousAntiAliasing != 2 && !resolution.dynamic && resolution.scale >= 1.0f) {
+        resolution.scale = 0.67f;
+    }
+    if (antiAliasing.mode != 0) {
+        ImGui::SliderFloat("Historique", &antiAliasing.feedback, 0.5f, 0.98f, "%.2f");
+        ImGui::Text("Décalages : suite de %d positions", feedback.taaPhases);
+    }
+    // MSAA : seuls les nombres d'échantillons acceptés par le contexte, avec le dernier coût mesuré
+    static const char* msaaLabels[MSAA_MODE_COUNT] = { "1x", "2x", "4x", "8x" };
+    int msaaModeCount = 1;
+    while (msaaModeCount < MSAA_MODE_COUNT && (1 << msaaModeCount) <= GetGLCaps().maxSamples) {
+        msaaModeCount++;
+    }
+    while (antiAliasing.msaaSamples >= (1 << msaaModeCount)) {
+        antiAliasing.msaaSamples >>= 1;
+    }
+    ImGui::Text("MSAA :");
+    for (int mode = 0; mode < msaaModeCount; ++mode) {
+        ImGui::SameLine();
+        ImGui::RadioButton(msaaLabels[mode], &antiAliasing.msaaSamples, 1 << mode);
+    }
+    if (ImGui::BeginTable("msaa", msaaModeCount + 1, ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("GPU scène (ms)");
+        for (int mode = 0; mode < msaaModeCount; ++mode) {
+            ImGui::TableSetupColumn(msaaLabels[mode]);
+        }
+        ImGui::TableHeadersRow();
+        ImGui::TableNextColumn();
+        ImGui::TextDisabled("scène + résolution");
+        for (int mode = 0; mode < msaaModeCount; ++mode) {
+            ImGui::TableNextColumn();
+            if (g_msaaGpuMs[mode] > 0.0f) {
+                ImGui::Text("%.2f", g_msaaGpuMs[mode]);
+            } else {
+                ImGui::TextDisabled("-");
+            }
+        }
+        ImGui::EndTable();
+    }
+    if (antiAliasing.mode == 1) {
+        ImGui::TextDisabled("TAA : résolution interne = sortie");
+    } else {
+        ImGui::Checkbox("Résolution dynamique", &resolution.dynamic);
+        if (resolution.dynamic) {
+            ImGui::SliderFloat("Budget GPU", &resolution.budgetMs, 2.0f, 50.0f, "%.1f ms");
+            float bounds[2] = { resolution.minScale, resolution.maxScale };
+            if (ImGui::SliderFloat2("Échelle min/max", bounds, 0.25f, 1.0f, "%.2f")) {
+                resolution.maxScale = bounds[1];
+                resolution.minScale = std::min(bounds[0], bounds[1]);
+            }
+            if (!g_profilerEnabled) {
+                ImGui::TextDisabled("Profileur désactivé : échelle figée");
+            }
+        } else {
+            ImGui::SliderFloat("Échelle", &resolution.scale, 0.25f, 1.0f, "%.2f");
+        }
+    }
+    ImGui::Text("Interne : %dx%d (%.0f %%)", feedback.renderWidth, feedback.renderHeight, feedback.renderScale * 100.0f);
+    ImGui::Text("Sortie  : %dx%d", feedback.targetWidth, feedback.targetHeight);
+    ImGui::Text("GPU : %.2f ms, %u changements d'échelle", feedback.resolutionGpuMs, feedback.scaleChanges);
+    // Graphe de rendu : passes retenues et mémoire des cibles transitoires après aliasing
+    const RenderGraph::Stats& graph = feedback.graphStats;
+    ImGui::Separator();
+    ImGui::Text("Graphe : %d passes (%d éliminées), %u compilations", graph.passes, graph.culledPasses, graph.compiles);
+    ImGui::Text("Cibles : %d transitoires -> %d textures, %d FBO", graph.transientTextures, graph.physicalTextures, graph.framebuffers);
+    ImGui::Text("Mémoire : %.1f Mo (%.1f Mo sans aliasing)", graph.physicalBytes / (1024.0 * 1024.0),
+                graph.transientBytes / (1024.0 * 1024.0));
+    ImGui::End();
+
+    // --- Scène HDR : bloom, exposition et tonemapping (fenêtre repliée au départ) ---
+    ImGui::SetNextWindowPos(ImVec2(360, 210), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(340, 250), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    ImGui::Begin("HDR");
+    HdrSettings& hdr = g_hdrSettings;
+    ImGui::Text("Tonemapping :");
+    ImGui::RadioButton("Écrêtage", &hdr.tonemap, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Reinhard", &hdr.tonemap, 1);
+    ImGui::SameLine();
+    ImGui::RadioButton("ACES", &hdr.tonemap, 2);
+    ImGui::SliderFloat("Exposition", &hdr.exposureEv, -4.0f, 4.0f, "%+.1f EV");
+    if (g_autoExposure.IsAvailable()) {
+        ImGui::Checkbox("Exposition automatique", &hdr.autoExposure);
+        if (hdr.autoExposure) {
+            ImGui::SliderFloat("Luminance visée", &hdr.targetLuminance, 0.05f, 1.0f, "%.2f");
+            ImGui::SliderFloat("Adaptation", &hdr.adaptationSpeed, 0.1f, 10.0f, "%.1f /s");
+        }
+    } else {
+        hdr.autoExposure = false;
+        ImGui::TextDisabled("Exposition automatique : compute shaders indisponibles");
+    }
+    ImGui::Checkbox("Bloom", &hdr.bloom);
+    if (hdr.bloom) {
+        ImGui::SliderFloat("Intensité du bloom", &hdr.bloomStrength, 0.0f, 0.3f, "%.3f");
+    }
+    ImGui::SliderFloat("Intensité du ciel", &hdr.skyIntensity, 0.0f, 8.0f, "%.2f");
+    ImGui::End();
+    packet.hdr = hdr;
+    // ------------------------------------
+
+    // --- Lumières dynamiques : éclairage par clusters (fenêtre repliée au départ) ---
+    ImGui::SetNextWindowPos(ImVec2(360, 470), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(340, 240), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    ImGui::Begin("Lumières");
+    LightSettings& lights = g_lightSettings;
+    ImGui::SliderInt("Nombre", &lights.count, 0, 4096);
+    ImGui::SliderFloat("Rayon", &lights.radius, 0.5f, 8.0f, "%.1f");
+    ImGui::SliderFloat("Intensité", &lights.intensity, 0.1f, 10.0f, "%.1f");
+    ImGui::Checkbox("Animation", &lights.animate);
+    int lightMode = lights.clustered ? 0 : 1;
+    ImGui::RadioButton("Clusters", &lightMode, 0);
+    ImGui::SameLine();
+    ImGui::RadioButton("Toutes par fragment", &lightMode, 1);
+    lights.clustered = lightMode == 0;
+    ImGui::Text("Grille : %dx%dx%d clusters", LightClusters::TILES_X, LightClusters::TILES_Y, LightClusters::SLICES);
+    ImGui::Text("Construction : %.3f ms (CPU)", g_lightStats.buildMs);
+    ImGui::Text("Indices : %u, max %u par cluster", g_lightStats.indices, g_lightStats.maxPerCluster);
+    ImGui::Text("Clusters occupés : %u / %d", g_lightStats.occupiedClusters, LightClusters::CLUSTER_COUNT);
+    if (g_lightStats.droppedIndices > 0) {
+        ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.3f, 1.0f), "Indices ignorés : %u", g_lightStats.droppedIndices);
+    }
+    ImGui::End();
+    // ------------------------------------
+
+    // --- Ombres de la lumière principale (fenêtre repliée au départ) ---
+    ImGui::SetNextWindowPos(ImVec2(710, 470), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(340, 260), ImGuiCond_FirstUseEver);
+    ImGui::SetNextWindowCollapsed(true, ImGuiCond_FirstUseEver);
+    ImGui::Begin("Ombres");
+    ShadowSettings& shadows = g_shadowSettings;
+    ImGui::Checkbox("Ombres en cascades", &shadows.enabled);
+    ImGui::SliderFloat("Azimut", &shadows.lightYaw, -180.0f, 180.0f, "%.0f°");
+    ImGui::SliderFloat("Élévation", &shadows.lightElevation, 5.0f, 90.0f, "%.0f°");
+    ImGui::SliderFloat("Distance", &shadows.distance, 5.0f, 100.0f, "%.0f");
+    ImGui::SliderFloat("Répartition", &shadows.splitLambda, 0.0f, 1.0f, "%.2f");
+    const char* pcfModes[] = { "Une lecture (2x2)", "PCF 3x3", "PCF 5x5" };
+    ImGui::Combo("Filtrage", &shadows.pcfRadius, pcfModes, 3);
+    ImGui::Checkbox("Cache des cascades", &shadows.cache);
+    ImGui::Checkbox("Couleur par cascade", &shadows.showCascades);
+    ImGui::Text("%d cascades de %dx%d", ShadowCascades::CASCADE_COUNT, ShadowCascades::RESOLUTION, ShadowCascades::RESOLUTION);
+    ImGui::Text("Redessinées : %u cette frame, %u au total", feedback.shadowRenders, feedback.shadowTotalRenders);
+    ImGui::End();
+    // ------------------------------------
+
+    // Taille de sortie : les cibles de scène la suivent (redimensionnement de la fenêtre)
+    packet.outputWidth = FBO_WIDTH;
+    packet.outputHeight = FBO_HEIGHT;
+    if (!g_headless) {
+        glfwGetFramebufferSize(g_window, &packet.outputWidth, &packet.outputHeight);
+    }
+
+    float aspectRatio = (packet.outputHeight > 0) ? ((float)packet.outputWidth / packet.outputHeight) : 1.0f;
     float camX = g_cameraDistance * sin(g_cameraYaw) * cos(g_cameraPitch);
     float camY = g_cameraDistance * sin(g_cameraPitch);
     float camZ = g_cameraDistance * cos(g_cameraYaw) * cos(g_cameraPitch);
-    mat4 viewMatrix = mat4::lookAt(vec3(camX, camY, camZ), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
-    mat4 projectionMatrix = mat4::perspective(45.0f * 3.14159f / 180.0f, aspectRatio, 0.01f, 100.0f);
-    
-    // Mise à jour de l'UBO pour le FBO rendering
-    UniformBlockMatrices uboData;
-    uboData.projection = projectionMatrix;
-    uboData.view = viewMatrix;
-    glBindBuffer(GL_UNIFORM_BUFFER, g_uboMatrices);
-    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(UniformBlockMatrices), &uboData);
-    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    packet.view = mat4::lookAt(vec3(camX, camY, camZ), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+    float fovY = 45.0f * 3.14159f / 180.0f;
+    packet.projection = mat4::perspective(fovY, aspectRatio, 0.01f, 100.0f);
+    packet.cameraPos[0] = camX;
+    packet.cameraPos[1] = camY;
+    packet.cameraPos[2] = camZ;
+    vec3 cameraPos(camX, camY, camZ);
+
+    // Lumières dynamiques : positions de la frame, puis répartition dans les clusters de la vue
+    if (g_lightSettings.animate) {
+        g_lightAnimationTime += 1.0f / 60.0f;
+    }
+    updateLights(g_lightSettings, g_lightAnimationTime);
+    packet.lightClusters.Build(g_jobSystem, g_lights, packet.view, packet.projection, 0.01f, 100.0f);
+    packet.clusteredLights = g_lightSettings.clustered;
+    g_lightStats = packet.lightClusters.GetStats();
+
+    // Les matrices d'instance sont statiques : on ne les renvoie que si le nombre change
+    packet.uploadInstances = g_instanceCount != g_instanceCountUploaded;
+    if (packet.uploadInstances) {
+        packet.instanceTransforms = buildInstanceGrid(g_instanceCount);
+        g_instanceCountUploaded = g_instanceCount;
+    }
+
+    // --- Préparation : tous les dessins de la frame sont connus avant d'écrire l'anneau ---
+    RenderQueue& queue = packet.queue;
+    queue.Clear();
+
+    // Rendu différé : mêmes dessins, avec les variantes qui écrivent le G-buffer
+    packet.deferred = g_deferredShading;
+    bool deferred = packet.deferred;
+    GLuint phongProgram = (deferred ? g_GBufferShader : g_PhongShader).GetProgram();
+    GLuint textureProgram = (deferred ? g_GBufferTextureShader : g_TextureShader).GetProgram();
+    GLuint envProgram = (deferred ? g_GBufferEnvShader : g_EnvShader).GetProgram();
+
+    float rotationXAngle = 20.0f * 3.1415926535f / 180.0f;
+    mat4 modelCube = mat4::translate(-2.0f, 0.0f, 0.0f) * mat4::rotateX(rotationXAngle) * mat4::scale(1.0f, 1.0f, 1.0f);
+    submitDraw(queue, phongProgram, g_mainModel, modelCube, g_mainModel.material, 0, 0, 0, cameraPos);
+
+    float rotationXAngleApple = 5.0f * 3.1415926535f / 180.0f;
+    mat4 modelApple = mat4::translate( 2.0f, -0.5f, 0.0f) * mat4::rotateX(rotationXAngleApple) * mat4::scale(20.0f, 20.0f, 20.0f);
+    submitDraw(queue, textureProgram, g_secondModel, modelApple, g_secondModel.material, 0, 0, 0, cameraPos);
+
+    mat4 modelEnv = mat4::translate(0.0f, 0.0f, 0.0f) * mat4::scale(.8f, .8f, .8f);
+    submitDraw(queue, envProgram, g_envModel, modelEnv, g_envModel.material, GL_TEXTURE_CUBE_MAP, sphereCubemap, 3, cameraPos);
+
+    // Grille instanciée : toutes les copies de g_mainModel en un seul appel
+    int gridCount = g_instanceCountUploaded;
+    if (gridCount > 0) {
+        if (g_instanceShader == 0) {
+            GLuint program = (deferred ? g_GBufferInstancedShader : g_PhongInstancedShader).GetProgram();
+            submitDraw(queue, program, g_mainModel, mat4(), g_mainModel.material, 0, 0, 0, cameraPos, gridCount);
+        } else if (g_instanceShader == 1) {
+            GLuint program = (deferred ? g_GBufferTextureInstancedShader : g_TextureInstancedShader).GetProgram();
+            submitDraw(queue, program, g_mainModel, mat4(), g_secondModel.material, 0, 0, 0, cameraPos, gridCount);
+        } else {
+            GLuint program = (deferred ? g_GBufferEnvInstancedShader : g_EnvInstancedShader).GetProgram();
+            submitDraw(queue, program, g_mainModel, mat4(), g_envModel.material, GL_TEXTURE_CUBE_MAP, sphereCubemap, 3, cameraPos, gridCount);
+        }
+    }
+
+    if (g_sortRenderQueue) {
+        queue.Sort();
+    }
+
+    packet.depth = g_depthSettings;
+    // Vue de surdessin : palette affichée telle quelle, sans exposition, bloom ni tonemapping
+    if (packet.depth.overdraw) {
+        packet.hdr.tonemap = 0;
+        packet.hdr.exposureEv = 0.0f;
+        packet.hdr.autoExposure = false;
+        packet.hdr.bloom = false;
+    }
+    packet.benchScene = g_benchScene;
+    packet.benchIndirect = false;
+    packet.benchPrepareMs = 0.0;
+    if (g_benchScene) {
+        if (g_benchObjectCount != g_benchObjectCountBuilt) {
+            buildBenchScene(g_benchObjectCount);
+            g_benchObjectCountBuilt = g_benchObjectCount;
+        }
+        std::chrono::high_resolution_clock::time_point benchStart = std::chrono::high_resolution_clock::now();
+        // Sans culling : frustum infini, tous les objets passent
+        Frustum frustum = Frustum::FromMatrix(packet.projection * packet.view);
+        if (!g_benchCulling) {
+            for (int p = 0; p < 6; ++p) {
+                frustum.planes[p][3] = std::numeric_limits<float>::max();
+            }
+        }
+        g_benchVisibleCount = g_benchCuller.Run(g_jobSystem, g_benchCullObjects.data(), (uint32_t)g_benchCullObjects.size(), frustum);
+        packet.benchDraws.Clear();
+        packet.benchDraws.Resize(g_benchVisibleCount);
+        BenchBatchFill fill = { &packet.benchDraws, &g_benchCuller };
+        g_jobSystem.ParallelFor(g_benchVisibleCount, 1024, fillBenchBatch, &fill);
+        packet.benchIndirect = g_submitMode == 1 && g_benchBatch.IsIndirectAvailable();
+        packet.benchPrepareMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - benchStart).count();
+    }
+
+    // Ombres : objets projetant une ombre (version), puis projections stables des cascades
+    if (packet.uploadInstances) {
+        g_shadowCasterVersion++;
+    }
+    int benchCasters = g_benchScene ? g_benchObjectCountBuilt : 0;
+    packet.uploadShadowCasters = benchCasters != g_shadowBenchCasters;
+    if (packet.uploadShadowCasters) {
+        // Tout le bloc de benchmark, frustum infini : les cascades débordent de la vue
+        packet.shadowCasters.Clear();
+        if (benchCasters > 0) {
+            Frustum everything = Frustum::FromMatrix(packet.projection * packet.view);
+            for (int p = 0; p < 6; ++p) {
+                everything.planes[p][3] = std::numeric_limits<float>::max();
+            }
+            uint32_t casterCount = g_shadowCasterCuller.Run(g_jobSystem, g_benchCullObjects.data(), (uint32_t)g_benchCullObjects.size(), everything);
+            packet.shadowCasters.Resize(casterCount);
+            BenchBatchFill fill = { &packet.shadowCasters, &g_shadowCasterCuller };
+            g_jobSystem.ParallelFor(casterCount, 1024, fillBenchBatch, &fill);
+        }
+        g_shadowBenchCasters = benchCasters;
+        g_shadowCasterVersion++;
+    }
+    const float degrees = 3.1415926535f / 180.0f;
+    float elevation = g_shadowSettings.lightElevation * degrees;
+    float yaw = g_shadowSettings.lightYaw * degrees;
+    vec3 lightDirection(std::cos(elevation) * std::sin(yaw), std::sin(elevation), std::cos(elevation) * std::cos(yaw));
+    ShadowCascades::Compute(packet.shadows, packet.view, fovY, aspectRatio, 0.01f, g_shadowSettings.distance,
+                            g_shadowSettings.splitLambda, lightDirection);
+    packet.shadows.casterVersion = g_shadowCasterVersion;
+    packet.shadows.enabled = g_shadowSettings.enabled;
+    packet.shadows.cached = g_shadowSettings.cache;
+    packet.shadows.pcfRadius = g_shadowSettings.pcfRadius;
+    packet.shadows.showCascades = g_shadowSettings.showCascades;
+
+    packet.profilerEnabled = g_profilerEnabled;
+    packet.resolution = g_resolutionSettings;
+    packet.antiAliasing = g_antiAliasingSettings;
+    // TAA sans upscale : la scène est rendue à la résolution de sortie
+    if (packet.antiAliasing.mode == 1) {
+        packet.resolution.dynamic = false;
+        packet.resolution.scale = 1.0f;
+    }
+    packet.vsyncMode = g_vsyncMode;
+    packet.finishAfterSwap = g_finishAfterSwap;
+
+    // Les listes de dessin d'ImGui sont copiées : le contexte les réutilise à la frame suivante
+    ImGui::Render();
+    packet.uiTexturesPending = packet.ui.Capture(ImGui::GetDrawData());
+
+    float buildMs = (float)(Trace::NowUs() / 1000.0 - buildStart);
+    g_buildMs = (g_buildMs == 0.0f) ? buildMs : g_buildMs * 0.95f + buildMs * 0.05f;
+}
+
+// Données des passes du graphe de rendu pour la frame en cours
+struct FramePassData {
+    FramePacket* packet = nullptr;
+    bool benchIndirect = false;
+    double benchPrepareMs = 0.0;
+    mat4 projection;                                           // décalée par le TAA
+    RenderGraph::Resource sceneColor = RenderGraph::INVALID;
+    RenderGraph::Resource sceneDepth = RenderGraph::INVALID;
+    RenderGraph::Resource gbufferAlbedo = RenderGraph::INVALID;    // rendu différé
+    RenderGraph::Resource gbufferNormal = RenderGraph::INVALID;
+    RenderGraph::Resource velocity = RenderGraph::INVALID;
+    RenderGraph::Resource taaHistory = RenderGraph::INVALID;
+    RenderGraph::Resource blurInput = RenderGraph::INVALID;
+    RenderGraph::Resource blurTemp = RenderGraph::INVALID;
+    RenderGraph::Resource blurOutput = RenderGraph::INVALID;
+    RenderGraph::Resource postInput = RenderGraph::INVALID;   // scène (TAA, flou) avant le post-traitement
+    // Zone valable de postInput : la zone rendue, ou toute la sortie après le TAA
+    int inputWidth = 0, inputHeight = 0;
+    int msaaMode = 0;                                          // indice dans MSAA_SCENE_SCOPES
+    bool resolveDepth = false;                                 // profondeur MSAA résolue pour le TAA
+    int bloomLevelCount = 0;
+    RenderGraph::Resource bloomLevels[Bloom::MAX_LEVELS];      // niveau 1 (moitié) en premier
+    RenderGraph::Resource averageLuminance = RenderGraph::INVALID;
+};
+
+// Étape de la pyramide de bloom : niveau écrit par la passe
+struct BloomStep {
+    FramePassData* frame;
+    int level;
+};
+
+// Pré-passe de profondeur : les objets opaques ne remplissent que le tampon de profondeur, la passe
+// couleur (ou le G-buffer) n'ombre ensuite que les fragments visibles (GL_LEQUAL, profondeur figée).
+// Renvoie vrai si les commandes indirectes du lot de benchmark ont déjà été envoyées.
+bool drawDepthPrepass(FramePassData& data) {
+    FramePacket& packet = *data.packet;
+    ProfileScopeGuard prepassScope(g_profiler, "Pré-passe profondeur");
+    bool benchUploaded = false;
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    packet.queue.FlushDepth(g_DepthShader.GetProgram(), g_DepthInstancedShader.GetProgram());
+    if (packet.benchScene) {
+        if (data.benchIndirect) {
+            glUseProgram(g_DepthMdiShader.GetProgram());
+            g_benchBatch.SubmitIndirect(g_meshPool.GetVao());
+            benchUploaded = true;
+        } else {
+            glUseProgram(g_DepthShader.GetProgram());
+            g_benchBatch.SubmitLoop(g_meshPool.GetVao());
+        }
+    }
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
+    return benchUploaded;
+}
+
+// File opaque puis scène de benchmark (un seul glMultiDrawElementsIndirect, ou une boucle sur GL 3.3),
+// avec les programmes de la passe de scène ou du G-buffer
+void drawOpaqueObjects(FramePassData& data, GLuint benchLoopProgram, GLuint benchIndirectProgram, bool benchUploaded) {
+    FramePacket& packet = *data.packet;
+    FrameUniforms frameUniforms = { { packet.cameraPos[0], packet.cameraPos[1], packet.cameraPos[2] },
+                                     { packet.shadows.lightDirection[0], packet.shadows.lightDirection[1], packet.shadows.lightDirection[2] },
+                                     packet.clusteredLights, false };
+    g_profiler.BeginScope("File opaque");
+    packet.queue.Flush(applyQueueProgram, &frameUniforms);
+    if (frameUniforms.profileScopeOpen) {
+        g_profiler.EndScope();
+    }
+    g_profiler.EndScope();
+
+    if (packet.benchScene) {
+        ProfileScopeGuard benchScope(g_profiler, "Benchmark");
+        std::chrono::high_resolution_clock::time_point benchStart = std::chrono::high_resolution_clock::now();
+
+        GLuint benchProgram = data.benchIndirect ? benchIndirectProgram : benchLoopProgram;
+        glUseProgram(benchProgram);
+        applyFrameUniforms(benchProgram, &frameUniforms);
+        if (data.benchIndirect) {
+            g_benchBatch.SubmitIndirect(g_meshPool.GetVao(), !benchUploaded);
+        } else {
+            g_benchBatch.SubmitLoop(g_meshPool.GetVao());
+        }
+
+        double submitMs = data.benchPrepareMs + std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - benchStart).count();
+        double& smoothed = g_submitTimeMs[data.benchIndirect ? 1 : 0];
+        smoothed = (smoothed == 0.0) ? submitMs : smoothed * 0.95 + submitMs * 0.05;
+    }
+    glDepthMask(GL_TRUE);
+}
 
-    // 1) DESSIN DU SKYBOX
+// Skybox à la profondeur maximale : elle n'ombre que les pixels restés découverts
+void drawSkybox(const FramePacket& packet, const mat4& projection) {
+    g_profiler.BeginScope("Skybox");
     glDepthFunc(GL_LEQUAL);
+    glDepthMask(GL_FALSE);
     glUseProgram(g_SkyboxShader.GetProgram());
-    
-    mat4 viewNoTrans = viewMatrix;
+
+    mat4 viewNoTrans = packet.view;
     float* p = const_cast<float*>(viewNoTrans.getPtr());
     p[12] = 0.0f; p[13] = 0.0f; p[14] = 0.0f;
 
     glUniformMatrix4fv(glGetUniformLocation(g_SkyboxShader.GetProgram(), "view"), 1, GL_FALSE, viewNoTrans.getPtr());
-    glUniformMatrix4fv(glGetUniformLocation(g_SkyboxShader.GetProgram(), "projection"), 1, GL_FALSE, projectionMatrix.getPtr());
-    
+    glUniformMatrix4fv(glGetUniformLocation(g_SkyboxShader.GetProgram(), "projection"), 1, GL_FALSE, projection.getPtr());
+
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_CUBE_MAP, envCubemap);
     glUniform1i(glGetUniformLocation(g_SkyboxShader.GetProgram(), "u_skybox"), 0);
-    
+    glUniform1f(glGetUniformLocation(g_SkyboxShader.GetProgram(), "u_intensity"), packet.hdr.skyIntensity);
+
     glBindVertexArray(skyboxVAO);
     glDrawArrays(GL_TRIANGLES, 0, 36);
-    
-    glDepthFunc(GL_LESS);
-    
-    // 2) DESSIN DU CUBE (AVEC ÉCLAIRAGE PHONG)
-    auto phongProgram = g_PhongShader.GetProgram();
-    glUseProgram(phongProgram);
-    float rotationXAngle = 20.0f * 3.1415926535f / 180.0f;
-    mat4 modelCube = mat4::translate(-2.0f, 0.0f, 0.0f) * mat4::rotateX(rotationXAngle) * mat4::scale(1.0f, 1.0f, 1.0f);
-    glUniformMatrix4fv(glGetUniformLocation(phongProgram, "u_model"), 1, GL_FALSE, modelCube.getPtr());
-    glUniform3f(glGetUniformLocation(phongProgram, "u_objectColor"), 0.0f, 0.0f, 1.0f);
-    glUniform3f(glGetUniformLocation(phongProgram, "u_lightColor"), 1.0f, 1.0f, 1.0f);
-    glUniform3f(glGetUniformLocation(phongProgram, "u_lightPos"), 0.0f, 5.0f, 2.0f);
-    glUniform3f(glGetUniformLocation(phongProgram, "u_viewPos"), camX, camY, camZ);
-    glUniform1f(glGetUniformLocation(phongProgram, "u_shininess"), 32.0f);
-    glBindVertexArray(g_mainModel.vao);
-    glDrawElements(GL_TRIANGLES, g_mainModel.indexCount, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 
-    // 3) DESSIN DE LA POMME
-    auto secondProgram = g_TextureShader.GetProgram();
-    glUseProgram(secondProgram);
-    float rotationXAngleApple = 5.0f * 3.1415926535f / 180.0f;
-    mat4 modelApple = mat4::translate( 2.0f, -0.5f, 0.0f) * mat4::rotateX(rotationXAngleApple) * mat4::scale(20.0f, 20.0f, 20.0f);
-    glUniformMatrix4fv(glGetUniformLocation(secondProgram, "u_model"), 1, GL_FALSE, modelApple.getPtr());
-    glUniform1i(glGetUniformLocation(secondProgram, "u_texture"), 0);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, secondTex);
-    glBindVertexArray(g_secondModel.vao);
-    glDrawElements(GL_TRIANGLES, g_secondModel.indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    glDepthMask(GL_TRUE);
+    glDepthFunc(GL_LESS);
+    g_profiler.EndScope();
+}
 
-    // 4) DESSIN DE LA SPHÈRE ENVMAP
-    glUseProgram(g_EnvShader.GetProgram());
-    mat4 modelEnv = mat4::translate(0.0f, 0.0f, 0.0f) * mat4::scale(.8f, .8f, .8f);
-    glUniformMatrix4fv(glGetUniformLocation(g_EnvShader.GetProgram(), "u_model"), 1, GL_FALSE, modelEnv.getPtr());
-    glUniform3f(glGetUniformLocation(g_EnvShader.GetProgram(), "u_cameraPos"), camX, camY, camZ);
-    glActiveTexture(GL_TEXTURE3);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, sphereCubemap);
-    glUniform1i(glGetUniformLocation(g_EnvShader.GetProgram(), "u_envMap"), 3);
-    glBindVertexArray(g_envModel.vao);
-    glDrawElements(GL_TRIANGLES, g_envModel.indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+// Cascades d'ombre à redessiner : profondeur de la file opaque et de tout le bloc de benchmark
+// vus de la lumière, avec les shaders de la pré-passe. Une cascade dont des dessins manquent
+// (anneau plein) est redessinée à la frame suivante.
+void renderShadowCascades(FramePacket& packet, uint32_t cascades, const uint32_t* matricesOffsets, bool objectsWritten) {
+    ProfileScopeGuard shadowScope(g_profiler, "Ombres");
+    bool uploaded = false;
+    for (int i = 0; i < ShadowCascades::CASCADE_COUNT; ++i) {
+        if (!(cascades & (1u << i))) {
+            continue;
+        }
+        g_shadowCascades.BeginCascade(i);
+        g_uniformRing.BindRange(UNIFORM_BINDING_MATRICES, matricesOffsets[i], sizeof(UniformBlockMatrices));
+        packet.queue.FlushDepth(g_DepthShader.GetProgram(), g_DepthInstancedShader.GetProgram());
+        if (g_shadowCasterBatch.IsIndirectAvailable()) {
+            glUseProgram(g_DepthMdiShader.GetProgram());
+            g_shadowCasterBatch.SubmitIndirect(g_meshPool.GetVao(), !uploaded);
+            uploaded = true;
+        } else {
+            glUseProgram(g_DepthShader.GetProgram());
+            g_shadowCasterBatch.SubmitLoop(g_meshPool.GetVao());
+        }
+        g_shadowCascades.EndCascade(i, objectsWritten);
+    }
+    g_shadowCascades.End();
+}
+
+// Passe "Scène" : skybox, file opaque et lot de benchmark dans les cibles de scène
+void executeScenePass(RenderGraph& graph, void* user) {
+    (void)graph;
+    FramePassData& data = *(FramePassData*)user;
+    FramePacket& packet = *data.packet;
+    ProfileScopeGuard sceneScope(g_profiler, MSAA_SCENE_SCOPES[data.msaaMode]);
+    glViewport(0, 0, g_renderWidth, g_renderHeight);
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    // 1) PRÉ-PASSE DE PROFONDEUR
+    bool benchUploaded = false;
+    if (packet.depth.prepass) {
+        benchUploaded = drawDepthPrepass(data);
+    }
+    if (packet.depth.overdraw) {
+        g_overdrawView.Begin(g_renderWidth, g_renderHeight, 1 << data.msaaMode);
+    }
 
-    glBindFramebuffer(GL_FRAMEBUFFER, 0); // Bind back to default framebuffer
+    // 2) OBJETS OPAQUES via la file de rendu, 3) SCÈNE DE BENCHMARK
+    drawOpaqueObjects(data, g_PhongShader.GetProgram(), g_PhongMdiShader.GetProgram(), benchUploaded);
 
+    // 4) SKYBOX en dernier
+    drawSkybox(packet, data.projection);
 
-    // --- Pass 2: Render FBO texture to screen ---
-    int width, height;
-    glfwGetFramebufferSize(glfwGetCurrentContext(), &width, &height);
-    glViewport(0, 0, width, height);
+    // 5) VUE DE SURDESSIN : le compteur de stencil de chaque pixel remplace la couleur
+    if (packet.depth.overdraw) {
+        g_overdrawView.End();
+        g_overdrawView.Draw();
+    }
+}
+
+// Passe "G-buffer" (rendu différé) : mêmes dessins que la passe de scène, sans éclairage, vers
+// l'albedo, les normales et la profondeur
+void executeGBufferPass(RenderGraph& graph, void* user) {
+    (void)graph;
+    FramePassData& data = *(FramePassData*)user;
+    FramePacket& packet = *data.packet;
+    ProfileScopeGuard gbufferScope(g_profiler, DEFERRED_SCOPES[0]);
+    glViewport(0, 0, g_renderWidth, g_renderHeight);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+    bool benchUploaded = false;
+    if (packet.depth.prepass) {
+        benchUploaded = drawDepthPrepass(data);
+    }
+    // Surdessin : seules les écritures du G-buffer sont comptées, l'éclairage ombre un fragment par pixel
+    if (packet.depth.overdraw) {
+        g_overdrawView.Begin(g_renderWidth, g_renderHeight, 1);
+    }
+    drawOpaqueObjects(data, g_GBufferShader.GetProgram(), g_GBufferMdiShader.GetProgram(), benchUploaded);
+    glDepthFunc(GL_LESS);
+    if (packet.depth.overdraw) {
+        g_overdrawView.End();
+    }
+}
+
+// Passe "Éclairage différé" : lumière principale et lumières des clusters, une fois par pixel rendu
+void executeDeferredLightingPass(RenderGraph& graph, void* user) {
+    FramePassData& data = *(FramePassData*)user;
+    const FramePacket& packet = *data.packet;
+    ProfileScopeGuard lightingScope(g_profiler, DEFERRED_SCOPES[1]);
+    FrameUniforms frameUniforms = { { packet.cameraPos[0], packet.cameraPos[1], packet.cameraPos[2] },
+                                     { packet.shadows.lightDirection[0], packet.shadows.lightDirection[1], packet.shadows.lightDirection[2] },
+                                     packet.clusteredLights, false };
+    g_deferredLighting.Draw(graph.GetTexture(data.gbufferAlbedo), graph.GetTexture(data.gbufferNormal),
+                            graph.GetTexture(data.sceneDepth), packet.view, data.projection, g_renderWidth, g_renderHeight,
+                            applyFrameUniforms, &frameUniforms);
+}
+
+// Passe "Ciel" (rendu différé) : skybox testée contre la profondeur du G-buffer, puis vue de surdessin
+void executeDeferredSkyPass(RenderGraph& graph, void* user) {
+    (void)graph;
+    FramePassData& data = *(FramePassData*)user;
+    const FramePacket& packet = *data.packet;
+    ProfileScopeGuard skyScope(g_profiler, DEFERRED_SCOPES[2]);
+    glViewport(0, 0, g_renderWidth, g_renderHeight);
+    drawSkybox(packet, data.projection);
+    if (packet.depth.overdraw) {
+        g_overdrawView.Draw();
+    }
+}
+
+// Passe "Résolution MSAA" : moyenne des échantillons de la zone rendue par glBlitFramebuffer
+void executeMsaaResolvePass(RenderGraph& graph, void* user) {
+    (void)graph;
+    FramePassData& data = *(FramePassData*)user;
+    ProfileScopeGuard resolveScope(g_profiler, MSAA_RESOLVE_SCOPES[data.msaaMode]);
+    GLbitfield mask = GL_COLOR_BUFFER_BIT | (data.resolveDepth ? GL_DEPTH_BUFFER_BIT : 0);
+    glBlitFramebuffer(0, 0, g_renderWidth, g_renderHeight, 0, 0, g_renderWidth, g_renderHeight, mask, GL_NEAREST);
+}
+
+// Passe "Vitesses" : déplacement écran de chaque pixel rendu depuis la frame précédente
+void executeVelocityPass(RenderGraph& graph, void* user) {
+    FramePassData& data = *(FramePassData*)user;
+    ProfileScopeGuard velocityScope(g_profiler, "Vitesses");
+    g_temporalAA.DrawVelocity(graph.GetTexture(data.sceneDepth));
+}
+
+// Passe "TAA" : historique reprojeté et borné, mélangé à la frame, à la résolution de sortie
+void executeTemporalAAPass(RenderGraph& graph, void* user) {
+    FramePassData& data = *(FramePassData*)user;
+    ProfileScopeGuard taaScope(g_profiler, "TAA");
+    g_temporalAA.Resolve(graph.GetTexture(data.sceneColor), graph.GetTexture(data.sceneDepth),
+                         graph.GetTexture(data.velocity), data.packet->antiAliasing.feedback);
+}
+
+// Passes "Flou" : une par axe, en compute (écriture par image) ou en fragment (FBO du graphe)
+void executeBlurPass(RenderGraph& graph, FramePassData& data, int axis, RenderGraph::Resource source,
+                     RenderGraph::Resource destination) {
+    ProfileScopeGuard blurScope(g_profiler, axis == 0 ? "Flou horizontal" : "Flou vertical");
+    if (data.packet->blurCompute) {
+        g_blur.DispatchCompute(axis, graph.GetTexture(source), graph.GetTexture(destination), data.inputWidth, data.inputHeight);
+    } else {
+        g_blur.DrawFragment(axis, graph.GetTexture(source), data.inputWidth, data.inputHeight);
+    }
+}
+
+void executeBlurHorizontalPass(RenderGraph& graph, void* user) {
+    FramePassData& data = *(FramePassData*)user;
+    executeBlurPass(graph, data, 0, data.blurInput, data.blurTemp);
+}
+
+void executeBlurVerticalPass(RenderGraph& graph, void* user) {
+    FramePassData& data = *(FramePassData*)user;
+    executeBlurPass(graph, data, 1, data.blurTemp, data.blurOutput);
+}
+
+// Passes "Bloom" : descente du niveau level - 1 (0 : la scène) vers level, puis remontée additive
+void executeBloomDownsamplePass(RenderGraph& graph, void* user) {
+    BloomStep& step = *(BloomStep*)user;
+    FramePassData& data = *step.frame;
+    ProfileScopeGuard bloomScope(g_profiler, "Bloom (descente)");
+    RenderGraph::Resource source = step.level == 1 ? data.postInput : data.bloomLevels[step.level - 2];
+    const RenderGraph::TextureDesc& sourceDesc = graph.GetDesc(source);
+    const RenderGraph::TextureDesc& targetDesc = graph.GetDesc(data.bloomLevels[step.level - 1]);
+    float uvScale[2] = { 1.0f, 1.0f };
+    if (step.level == 1) {
+        uvScale[0] = (float)data.inputWidth / sourceDesc.width;
+        uvScale[1] = (float)data.inputHeight / sourceDesc.height;
+    }
+    g_bloom.Downsample(graph.GetTexture(source), sourceDesc.width, sourceDesc.height, uvScale,
+                       targetDesc.width, targetDesc.height, step.level == 1);
+}
+
+void executeBloomUpsamplePass(RenderGraph& graph, void* user) {
+    BloomStep& step = *(BloomStep*)user;
+    FramePassData& data = *step.frame;
+    ProfileScopeGuard bloomScope(g_profiler, "Bloom (remontée)");
+    const RenderGraph::TextureDesc& sourceDesc = graph.GetDesc(data.bloomLevels[step.level]);
+    const RenderGraph::TextureDesc& targetDesc = graph.GetDesc(data.bloomLevels[step.level - 1]);
+    g_bloom.Upsample(graph.GetTexture(data.bloomLevels[step.level]), sourceDesc.width, sourceDesc.height,
+                     targetDesc.width, targetDesc.height);
+}
+
+// Passe "Exposition" : histogramme de luminance de la zone rendue et adaptation (compute)
+void executeExposurePass(RenderGraph& graph, void* user) {
+    FramePassData& data = *(FramePassData*)user;
+    ProfileScopeGuard exposureScope(g_profiler, "Exposition");
+    g_autoExposure.Update(graph.GetTexture(data.postInput), data.inputWidth, data.inputHeight, data.packet->hdr.adaptationSpeed);
+}
+
+// Passe "Post-traitement" : quad plein écran, upscale de la zone rendue, bloom, exposition,
+// tonemapping puis LUT d'étalonnage
+void executePostProcessPass(RenderGraph& graph, void* user) {
+    FramePassData& data = *(FramePassData*)user;
+    g_profiler.BeginScope("Post-traitement");
+    glViewport(0, 0, data.packet->outputWidth, data.packet->outputHeight);
     glClearColor(0.75f, 0.75f, 0.75f, 1.f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -482,23 +1979,374 @@ void Render()
 
     glUseProgram(g_ScreenQuadShader.GetProgram());
     glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, g_fboTexture);
+    glBindTexture(GL_TEXTURE_2D, graph.GetTexture(data.postInput));
     glUniform1i(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "screenTexture"), 0);
-    glUniform1i(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "u_postProcessEffect"), g_selectedPostProcessEffect);
-    // New: Pass saturation and contrast uniforms
-    glUniform1f(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "u_saturation"), g_saturation);
-    glUniform1f(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "u_contrast"), g_contrast);
+    glActiveTexture(GL_TEXTURE0 + ColorGrading::LUT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_3D, g_colorLut);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "u_colorLut"), ColorGrading::LUT_TEXTURE_UNIT);
+    glUniform1f(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "u_lutSize"), (float)ColorGrading::LUT_SIZE);
+    // Upscale : seule la zone rendue est échantillonnée, sans déborder d'un demi-texel (filtrage linéaire)
+    const RenderGraph::TextureDesc& scene = graph.GetDesc(data.postInput);
+    glUniform2f(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "u_uvScale"),
+                (float)data.inputWidth / scene.width, (float)data.inputHeight / scene.height);
+    glUniform2f(glGetUniformLocation(g_ScreenQuadShader.GetProgram(), "u_uvMax"),
+                (data.inputWidth - 0.5f) / scene.width, (data.inputHeight - 0.5f) / scene.height);
+
+    // Bloom (unité 3) et luminance adaptée (unité 4) ; 0 si absents de la frame
+    const HdrSettings& hdr = data.packet->hdr;
+    GLuint program = g_ScreenQuadShader.GetProgram();
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_2D, data.bloomLevelCount > 0 ? graph.GetTexture(data.bloomLevels[0]) : 0);
+    glActiveTexture(GL_TEXTURE4);
+    glBindTexture(GL_TEXTURE_2D, data.averageLuminance != RenderGraph::INVALID ? graph.GetTexture(data.averageLuminance) : 0);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(glGetUniformLocation(program, "u_bloom"), 3);
+    glUniform1f(glGetUniformLocation(program, "u_bloomStrength"), data.bloomLevelCount > 0 ? hdr.bloomStrength : 0.0f);
+    glUniform1i(glGetUniformLocation(program, "u_averageLuminance"), 4);
+    glUniform1i(glGetUniformLocation(program, "u_autoExposure"), data.averageLuminance != RenderGraph::INVALID ? 1 : 0);
+    glUniform1f(glGetUniformLocation(program, "u_targetLuminance"), hdr.targetLuminance);
+    glUniform1f(glGetUniformLocation(program, "u_exposure"), std::pow(2.0f, hdr.exposureEv));
+    glUniform1i(glGetUniformLocation(program, "u_tonemap"), hdr.tonemap);
 
     glBindVertexArray(g_screenQuadVAO);
     glDrawArrays(GL_TRIANGLES, 0, 6); // Draw the quad
     glBindVertexArray(0);
 
     glEnable(GL_DEPTH_TEST); // Re-enable depth testing
+    g_profiler.EndScope();
+}
 
-    // --- ImGui Rendering ---
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-    // -----------------------
+// Passe "ImGui" : interface par-dessus la sortie
+void executeImGuiPass(RenderGraph& graph, void* user) {
+    (void)graph;
+    FramePassData& data = *(FramePassData*)user;
+    g_profiler.BeginScope("ImGui");
+    ImGui_ImplOpenGL3_NewFrame(); // crée les objets GL du backend au premier appel
+    // Les captures headless ne montrent que la scène (l'interface change d'une frame à l'autre)
+    if (!g_headless) {
+        ImGui_ImplOpenGL3_RenderDrawData(data.packet->ui.GetDrawData());
+    }
+    g_profiler.EndScope();
+}
+
+// Thread du contexte GL : applique le paquet, rend la scène puis l'interface, et remplit
+// les statistiques renvoyées au thread principal
+void renderFramePacket(FramePacket& packet) {
+    g_profiler.SetEnabled(packet.profilerEnabled);
+    g_profiler.BeginFrame();
+    g_profiler.BeginScope("Préparation");
+
+    if (packet.uploadInstances) {
+        setInstanceTransforms(g_mainModel, packet.instanceTransforms);
+    }
+    if (packet.uploadColorLut) {
+        glBindTexture(GL_TEXTURE_3D, g_colorLut);
+        glTexSubImage3D(GL_TEXTURE_3D, 0, 0, 0, 0, ColorGrading::LUT_SIZE, ColorGrading::LUT_SIZE, ColorGrading::LUT_SIZE,
+                        GL_RGBA, GL_UNSIGNED_BYTE, packet.colorLut.data());
+        glBindTexture(GL_TEXTURE_3D, 0);
+    }
+    for (size_t i = 0; i < packet.materialEdits.size(); ++i) {
+        g_materialSystem.SetParams(packet.materialEdits[i].first, packet.materialEdits[i].second);
+    }
+
+    // Fenêtre réduite : taille nulle, on garde la taille des cibles
+    if (packet.outputWidth > 0 && packet.outputHeight > 0) {
+        g_sceneTargetWidth = packet.outputWidth;
+        g_sceneTargetHeight = packet.outputHeight;
+    }
+
+    // Résolution interne : temps GPU de la dernière frame relue par le profileur
+    const ResolutionSettings& resolution = packet.resolution;
+    g_dynamicResolution.SetEnabled(resolution.dynamic);
+    g_dynamicResolution.SetBudgetMs(resolution.budgetMs);
+    g_dynamicResolution.SetBounds(resolution.minScale, resolution.maxScale);
+    if (!resolution.dynamic) {
+        g_dynamicResolution.SetScale(resolution.scale, g_profiler.GetFrameIndex());
+    }
+    const std::vector<ProfileScope>& frameScopes = g_profiler.GetScopes();
+    if (!frameScopes.empty()) {
+        g_dynamicResolution.AddSample(g_profiler.GetResultFrame(), frameScopes[0].gpuMs);
+    }
+    float renderScale = g_dynamicResolution.Update(g_profiler.GetFrameIndex());
+    DynamicResolution::ScaledSize(g_sceneTargetWidth, g_sceneTargetHeight, renderScale, g_renderWidth, g_renderHeight);
+
+    // Lot de benchmark rempli par le thread principal : repris sans copie
+    FramePassData passData;
+    passData.packet = &packet;
+    // TAA : projection décalée pour toute la scène (bloc Matrices et skybox)
+    bool temporalAA = packet.antiAliasing.mode != 0;
+    passData.projection = packet.projection;
+    if (temporalAA) {
+        passData.projection = g_temporalAA.BeginFrame(g_sceneTargetWidth, g_sceneTargetHeight, g_renderWidth, g_renderHeight,
+                                                      packet.view, packet.projection);
+    } else {
+        g_temporalAA.Invalidate();
+    }
+    passData.benchIndirect = packet.benchScene && packet.benchIndirect;
+    passData.benchPrepareMs = packet.benchPrepareMs;
+    if (packet.benchScene) {
+        g_benchBatch.SwapDraws(packet.benchDraws);
+    }
+    if (packet.uploadShadowCasters) {
+        g_shadowCasterBatch.SwapDraws(packet.shadowCasters);
+    }
+    // Cascades dont la projection ou les objets ont changé depuis leur dernier rendu
+    uint32_t shadowCascades = g_shadowCascades.BeginFrame(packet.shadows);
+
+    // --- Données uniformes de la frame : écriture linéaire dans l'anneau puis Commit ---
+    g_uniformRing.BeginFrame();
+    UniformBlockMatrices uboData;
+    uboData.projection = passData.projection;
+    uboData.view = packet.view;
+    uint32_t matricesOffset = 0;
+    g_uniformRing.Write(&uboData, sizeof(UniformBlockMatrices), matricesOffset);
+    bool shadowObjectsWritten = packet.queue.WriteObjectData(g_uniformRing);
+    if (packet.benchScene && !passData.benchIndirect) {
+        std::chrono::high_resolution_clock::time_point benchStart = std::chrono::high_resolution_clock::now();
+        g_benchBatch.WriteObjectData(g_uniformRing);
+        passData.benchPrepareMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - benchStart).count();
+    }
+    // Ombres : matrices de la lumière des seules cascades à redessiner ; sans place, la cascade attend
+    uint32_t shadowMatricesOffsets[ShadowCascades::CASCADE_COUNT];
+    for (int i = 0; i < ShadowCascades::CASCADE_COUNT; ++i) {
+        if (shadowCascades & (1u << i)) {
+            UniformBlockMatrices cascadeMatrices;
+            cascadeMatrices.projection = packet.shadows.cascades[i].projection;
+            cascadeMatrices.view = packet.shadows.cascades[i].view;
+            if (!g_uniformRing.Write(&cascadeMatrices, sizeof(UniformBlockMatrices), shadowMatricesOffsets[i])) {
+                shadowCascades &= ~(1u << i);
+            }
+        }
+    }
+    if (shadowCascades != 0 && !g_shadowCasterBatch.IsIndirectAvailable()) {
+        shadowObjectsWritten = g_shadowCasterBatch.WriteObjectData(g_uniformRing) && shadowObjectsWritten;
+    }
+    g_uniformRing.Commit();
+    // Ré-upload des seuls matériaux modifiés (éditeur ImGui)
+    g_materialSystem.Upload();
+    if (shadowCascades != 0) {
+        renderShadowCascades(packet, shadowCascades, shadowMatricesOffsets, shadowObjectsWritten);
+    }
+    g_shadowCascades.BindTexture();
+    g_uniformRing.BindRange(UNIFORM_BINDING_MATRICES, matricesOffset, sizeof(UniformBlockMatrices));
+    // Tableau des cartes de matériaux : lié une fois pour toute la frame
+    glActiveTexture(GL_TEXTURE0 + MaterialSystem::TEXTURE_ARRAY_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, g_materialSystem.GetTextureArray());
+    // Lumières dynamiques et leurs clusters, construits par le thread principal
+    g_lightClusters.SwapData(packet.lightClusters);
+    g_lightClusters.Upload();
+    g_lightClusters.BindTextures();
+
+    // --- Graphe de la frame : scène -> TAA -> flou -> bloom, exposition -> post-traitement -> interface ---
+    // Recompilé seulement si la déclaration change (taille de sortie, passes)
+    g_renderGraph.Reset();
+    // Cible HDR : R11F_G11F_B10F, 4 octets par pixel comme le RGBA8 précédent, et format d'image des compute shaders
+    RenderGraph::TextureDesc colorDesc = { g_sceneTargetWidth, g_sceneTargetHeight, GL_R11F_G11F_B10F, 1 };
+    RenderGraph::TextureDesc depthDesc = { g_sceneTargetWidth, g_sceneTargetHeight, GL_DEPTH24_STENCIL8, 1 };
+    RenderGraph::Resource output = g_renderGraph.ImportFramebuffer("Sortie", g_outputFbo, packet.outputWidth, packet.outputHeight);
+
+    // MSAA : la scène est rendue dans des renderbuffers multiéchantillonnés, résolus avant le
+    // post-traitement ; la profondeur ne l'est que si le TAA la lit. Le G-buffer du rendu différé
+    // reste à un échantillon (l'éclairage par pixel ne lit qu'un échantillon)
+    int samples = packet.deferred ? 1 : packet.antiAliasing.msaaSamples;
+    while (samples > GetGLCaps().maxSamples) {
+        samples >>= 1;
+    }
+    passData.msaaMode = 0;
+    while ((1 << passData.msaaMode) < samples && passData.msaaMode + 1 < MSAA_MODE_COUNT) {
+        passData.msaaMode++;
+    }
+    bool msaa = passData.msaaMode > 0;
+    passData.resolveDepth = msaa && temporalAA;
+    passData.sceneColor = g_renderGraph.CreateTexture("Couleur scène", colorDesc);
+    passData.sceneDepth = RenderGraph::INVALID;
+    if (!msaa || passData.resolveDepth) {
+        passData.sceneDepth = g_renderGraph.CreateTexture("Profondeur scène", depthDesc);
+    }
+
+    if (packet.deferred) {
+        // Rendu différé : G-buffer, éclairage plein écran qui le lit, puis ciel testé contre sa profondeur
+        RenderGraph::TextureDesc albedoDesc = { g_sceneTargetWidth, g_sceneTargetHeight, GL_RGBA8, 1 };
+        RenderGraph::TextureDesc normalDesc = { g_sceneTargetWidth, g_sceneTargetHeight, GL_RGB10_A2, 1 };
+        passData.gbufferAlbedo = g_renderGraph.CreateTexture("G-buffer albedo", albedoDesc);
+        passData.gbufferNormal = g_renderGraph.CreateTexture("G-buffer normales", normalDesc);
+        RenderGraph::Pass gbufferPass = g_renderGraph.AddPass("G-buffer", executeGBufferPass, &passData);
+        g_renderGraph.Write(gbufferPass, passData.gbufferAlbedo);
+        g_renderGraph.Write(gbufferPass, passData.gbufferNormal);
+        g_renderGraph.Write(gbufferPass, passData.sceneDepth);
+        RenderGraph::Pass lightingPass = g_renderGraph.AddPass("Éclairage différé", executeDeferredLightingPass, &passData);
+        g_renderGraph.Read(lightingPass, passData.gbufferAlbedo);
+        g_renderGraph.Read(lightingPass, passData.gbufferNormal);
+        g_renderGraph.Read(lightingPass, passData.sceneDepth);
+        g_renderGraph.Write(lightingPass, passData.sceneColor);
+        RenderGraph::Pass skyPass = g_renderGraph.AddPass("Ciel", executeDeferredSkyPass, &passData);
+        g_renderGraph.Write(skyPass, passData.sceneColor);
+        g_renderGraph.Write(skyPass, passData.sceneDepth);
+    } else if (msaa) {
+        RenderGraph::Pass scenePass = g_renderGraph.AddPass("Scène", executeScenePass, &passData);
+        RenderGraph::TextureDesc msaaColorDesc = colorDesc;
+        RenderGraph::TextureDesc msaaDepthDesc = depthDesc;
+        msaaColorDesc.samples = msaaDepthDesc.samples = 1 << passData.msaaMode;
+        RenderGraph::Resource msaaColor = g_renderGraph.CreateTexture("Couleur scène MSAA", msaaColorDesc);
+        RenderGraph::Resource msaaDepth = g_renderGraph.CreateTexture("Profondeur scène MSAA", msaaDepthDesc);
+        g_renderGraph.Write(scenePass, msaaColor);
+        g_renderGraph.Write(scenePass, msaaDepth);
+        RenderGraph::Pass resolvePass = g_renderGraph.AddPass("Résolution MSAA", executeMsaaResolvePass, &passData);
+        g_renderGraph.ReadFramebuffer(resolvePass, msaaColor);
+        g_renderGraph.Write(resolvePass, passData.sceneColor);
+        if (passData.resolveDepth) {
+            g_renderGraph.ReadFramebuffer(resolvePass, msaaDepth);
+            g_renderGraph.Write(resolvePass, passData.sceneDepth);
+        }
+    } else {
+        RenderGraph::Pass scenePass = g_renderGraph.AddPass("Scène", executeScenePass, &passData);
+        g_renderGraph.Write(scenePass, passData.sceneColor);
+        g_renderGraph.Write(scenePass, passData.sceneDepth);
+    }
+    passData.postInput = passData.sceneColor;
+    passData.inputWidth = g_renderWidth;
+    passData.inputHeight = g_renderHeight;
+    if (temporalAA) {
+        // Historique importé : les deux textures échangées chaque frame ne recompilent pas le graphe
+        RenderGraph::TextureDesc velocityDesc = { g_sceneTargetWidth, g_sceneTargetHeight, GL_RG16F, 1 };
+        RenderGraph::TextureDesc historyDesc = { g_sceneTargetWidth, g_sceneTargetHeight, GL_RGBA16F, 1 };
+        passData.velocity = g_renderGraph.CreateTexture("Vitesses", velocityDesc);
+        passData.taaHistory = g_renderGraph.ImportTexture("Historique TAA", g_temporalAA.GetHistoryTexture(), historyDesc);
+        RenderGraph::Resource taaOutput = g_renderGraph.ImportTexture("TAA", g_temporalAA.GetOutputTexture(), historyDesc,
+                                                                      g_temporalAA.GetOutputFramebuffer());
+        RenderGraph::Pass velocityPass = g_renderGraph.AddPass("Vitesses", executeVelocityPass, &passData);
+        g_renderGraph.Read(velocityPass, passData.sceneDepth);
+        g_renderGraph.Write(velocityPass, passData.velocity);
+        RenderGraph::Pass taaPass = g_renderGraph.AddPass("TAA", executeTemporalAAPass, &passData);
+        g_renderGraph.Read(taaPass, passData.sceneColor);
+        g_renderGraph.Read(taaPass, passData.sceneDepth);
+        g_renderGraph.Read(taaPass, passData.velocity);
+        g_renderGraph.Read(taaPass, passData.taaHistory);
+        g_renderGraph.Write(taaPass, taaOutput);
+        passData.postInput = taaOutput;
+        passData.inputWidth = g_sceneTargetWidth;
+        passData.inputHeight = g_sceneTargetHeight;
+    }
+    if (packet.blurRadius > 0) {
+        // La sortie du flou vertical réutilise la texture de la scène, libre après le flou horizontal
+        g_blur.SetRadius(packet.blurRadius);
+        passData.blurInput = passData.postInput;
+        passData.blurTemp = g_renderGraph.CreateTexture("Flou intermédiaire", colorDesc);
+        passData.blurOutput = g_renderGraph.CreateTexture("Flou", colorDesc);
+        RenderGraph::Pass blurPasses[2] = {
+            g_renderGraph.AddPass("Flou horizontal", executeBlurHorizontalPass, &passData),
+            g_renderGraph.AddPass("Flou vertical", executeBlurVerticalPass, &passData)
+        };
+        RenderGraph::Resource blurTargets[2] = { passData.blurTemp, passData.blurOutput };
+        g_renderGraph.Read(blurPasses[0], passData.blurInput);
+        g_renderGraph.Read(blurPasses[1], passData.blurTemp);
+        for (int axis = 0; axis < 2; ++axis) {
+            if (packet.blurCompute) {
+                g_renderGraph.WriteStorage(blurPasses[axis], blurTargets[axis]);
+            } else {
+                g_renderGraph.Write(blurPasses[axis], blurTargets[axis]);
+            }
+        }
+        passData.postInput = passData.blurOutput;
+    }
+
+    // Pyramide de bloom : tailles tirées de la cible (et non de la zone rendue) pour que le
+    // graphe compilé reste valable quand l'échelle de la résolution dynamique change
+    static const char* bloomDownNames[Bloom::MAX_LEVELS] = { "Bloom 1/2", "Bloom 1/4", "Bloom 1/8", "Bloom 1/16", "Bloom 1/32", "Bloom 1/64" };
+    static const char* bloomUpNames[Bloom::MAX_LEVELS] = { "Bloom 1/2 +", "Bloom 1/4 +", "Bloom 1/8 +", "Bloom 1/16 +", "Bloom 1/32 +", "Bloom 1/64 +" };
+    BloomStep bloomSteps[Bloom::MAX_LEVELS];
+    passData.bloomLevelCount = 0;
+    if (packet.hdr.bloom) {
+        for (int level = 1; level <= Bloom::MAX_LEVELS; ++level) {
+            RenderGraph::TextureDesc levelDesc = colorDesc;
+            Bloom::LevelSize(colorDesc.width, colorDesc.height, level, levelDesc.width, levelDesc.height);
+            if (levelDesc.width < 4 || levelDesc.height < 4) {
+                break;
+            }
+            passData.bloomLevels[passData.bloomLevelCount++] = g_renderGraph.CreateTexture(bloomDownNames[level - 1], levelDesc);
+        }
+        for (int level = 1; level <= passData.bloomLevelCount; ++level) {
+            BloomStep step = { &passData, level };
+            bloomSteps[level - 1] = step;
+            RenderGraph::Pass pass = g_renderGraph.AddPass(bloomDownNames[level - 1], executeBloomDownsamplePass, &bloomSteps[level - 1]);
+            g_renderGraph.Read(pass, level == 1 ? passData.postInput : passData.bloomLevels[level - 2]);
+            g_renderGraph.Write(pass, passData.bloomLevels[level - 1]);
+        }
+        // Remontée : bloomSteps[level - 1] sert aussi à la passe qui ajoute le niveau level + 1 au niveau level
+        for (int level = passData.bloomLevelCount - 1; level >= 1; --level) {
+            RenderGraph::Pass pass = g_renderGraph.AddPass(bloomUpNames[level - 1], executeBloomUpsamplePass, &bloomSteps[level - 1]);
+            g_renderGraph.Read(pass, passData.bloomLevels[level]);
+            g_renderGraph.Write(pass, passData.bloomLevels[level - 1]);
+        }
+    }
+
+    passData.averageLuminance = RenderGraph::INVALID;
+    if (packet.hdr.autoExposure && g_autoExposure.IsAvailable()) {
+        RenderGraph::TextureDesc luminanceDesc = { 1, 1, GL_R32F, 1 };
+        passData.averageLuminance = g_renderGraph.ImportTexture("Luminance adaptée", g_autoExposure.GetTexture(), luminanceDesc);
+        RenderGraph::Pass exposurePass = g_renderGraph.AddPass("Exposition", executeExposurePass, &passData);
+        g_renderGraph.Read(exposurePass, passData.postInput);
+        g_renderGraph.WriteStorage(exposurePass, passData.averageLuminance);
+    }
+
+    RenderGraph::Pass postPass = g_renderGraph.AddPass("Post-traitement", executePostProcessPass, &passData);
+    g_renderGraph.Read(postPass, passData.postInput);
+    if (passData.bloomLevelCount > 0) {
+        g_renderGraph.Read(postPass, passData.bloomLevels[0]);
+    }
+    if (passData.averageLuminance != RenderGraph::INVALID) {
+        g_renderGraph.Read(postPass, passData.averageLuminance);
+    }
+    g_renderGraph.Write(postPass, output);
+    RenderGraph::Pass uiPass = g_renderGraph.AddPass("ImGui", executeImGuiPass, &passData);
+    g_renderGraph.Write(uiPass, output);
+    g_renderGraph.Compile();
+    g_profiler.EndScope();
+
+    g_renderGraph.Execute();
+    if (temporalAA) {
+        g_temporalAA.EndFrame();
+    }
+
+    // Fence du segment de l'anneau utilisé par cette frame
+    g_uniformRing.EndFrame();
+    g_profiler.EndFrame();
+
+    RenderFeedback& feedback = packet.feedback;
+    feedback.queueStats = packet.queue.GetStats();
+    feedback.materialStats = g_materialSystem.GetStats();
+    feedback.ringFrameBytes = g_uniformRing.GetLastFrameBytes();
+    feedback.ringFrameSize = g_uniformRing.GetFrameSize();
+    feedback.ringWaits = g_uniformRing.GetWaitCount();
+    feedback.submitTimeMs[0] = g_submitTimeMs[0];
+    feedback.submitTimeMs[1] = g_submitTimeMs[1];
+    feedback.profilerScopes = g_profiler.GetScopes();
+    feedback.profilerHistory = g_profiler.GetHistory();
+    feedback.profilerHistoryOffset = g_profiler.GetHistoryOffset();
+    feedback.profilerDroppedFrames = g_profiler.GetDroppedFrames();
+    feedback.profilerResultFrame = g_profiler.GetResultFrame();
+    feedback.renderScale = renderScale;
+    feedback.resolutionGpuMs = g_dynamicResolution.GetGpuMs();
+    feedback.scaleChanges = g_dynamicResolution.GetChangeCount();
+    feedback.renderWidth = g_renderWidth;
+    feedback.renderHeight = g_renderHeight;
+    feedback.targetWidth = g_sceneTargetWidth;
+    feedback.targetHeight = g_sceneTargetHeight;
+    feedback.graphStats = g_renderGraph.GetStats();
+    feedback.taaPhases = temporalAA ? g_temporalAA.GetPhaseCount() : 0;
+    feedback.overdraw = g_overdrawView.GetFragmentsPerPixel();
+    feedback.shadowRenders = g_shadowCascades.GetFrameRenders();
+    feedback.shadowTotalRenders = g_shadowCascades.GetTotalRenders();
+    packet.rendered = true;
+}
+
+// Frame complète sur un seul thread (mode headless et --single-thread)
+void Render()
+{
+    FramePacket& packet = g_framePackets[0];
+    buildFramePacket(packet);
+    renderFramePacket(packet);
 }
 
 // All custom GLFW callbacks explicitly forward to ImGui backend and then check if ImGui wants to capture input
@@ -555,55 +2403,487 @@ void char_callback(GLFWwindow* window, unsigned int c) {
 void Terminate()
 {
     // --- ImGui Shutdown ---
+    for (int i = 0; i < FRAME_PACKET_COUNT; ++i) {
+        g_framePackets[i].ui.Release();
+    }
     ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
+    if (!g_headless) {
+        ImGui_ImplGlfw_Shutdown();
+    }
     ImGui::DestroyContext();
     // ----------------------
 
-    glDeleteBuffers(1, &g_mainModel.vbo);
-    glDeleteBuffers(1, &g_mainModel.ibo);
-    glDeleteVertexArrays(1, &g_mainModel.vao);
+    g_meshPool.Release(g_mainModel.mesh);
+    glDeleteBuffers(1, &g_mainModel.instanceVbo);
     g_BasicShader.Destroy();
-
-    glDeleteBuffers(1, &g_secondModel.vbo);
-    glDeleteBuffers(1, &g_secondModel.ibo);
-    glDeleteVertexArrays(1, &g_secondModel.vao);
-    glDeleteTextures(1, &secondTex);
+    g_PhongInstancedShader.Destroy();
+    g_TextureInstancedShader.Destroy();
+    g_EnvInstancedShader.Destroy();
+    g_PhongMdiShader.Destroy();
+    g_DepthShader.Destroy();
+    g_DepthInstancedShader.Destroy();
+    g_DepthMdiShader.Destroy();
+    g_GBufferShader.Destroy();
+    g_GBufferInstancedShader.Destroy();
+    g_GBufferTextureShader.Destroy();
+    g_GBufferTextureInstancedShader.Destroy();
+    g_GBufferEnvShader.Destroy();
+    g_GBufferEnvInstancedShader.Destroy();
+    g_GBufferMdiShader.Destroy();
+    g_benchBatch.Destroy();
+    g_shadowCasterBatch.Destroy();
+
+    g_meshPool.Release(g_secondModel.mesh);
+    g_materialSystem.Destroy();
     g_TextureShader.Destroy();
 
-    glDeleteBuffers(1, &g_envModel.vbo);
-    glDeleteBuffers(1, &g_envModel.ibo);
-    glDeleteVertexArrays(1, &g_envModel.vao);
+    g_meshPool.Release(g_envModel.mesh);
+    g_meshPool.Destroy();
     glDeleteTextures(1, &envCubemap);
     g_EnvShader.Destroy();
     g_PhongShader.Destroy();
 
-    glDeleteBuffers(1, &g_uboMatrices);
+    g_uniformRing.Destroy();
+    g_benchmark.Destroy();
+    g_profiler.Destroy();
     glDeleteVertexArrays(1, &skyboxVAO);
     glDeleteBuffers(1, &skyboxVBO);
 
-    // FBO and screen quad cleanup
-    glDeleteFramebuffers(1, &g_fbo);
-    glDeleteTextures(1, &g_fboTexture);
-    glDeleteRenderbuffers(1, &g_rboDepthStencil);
+    // Render targets and screen quad cleanup
+    g_renderGraph.Destroy();
+    glDeleteTextures(1, &g_colorLut);
+    g_blur.Destroy();
+    g_bloom.Destroy();
+    g_autoExposure.Destroy();
+    g_temporalAA.Destroy();
+    g_overdrawView.Destroy();
+    g_lightClusters.Destroy();
+    g_shadowCascades.Destroy();
+    g_deferredLighting.Destroy();
     g_ScreenQuadShader.Destroy();
     glDeleteVertexArrays(1, &g_screenQuadVAO);
     glDeleteBuffers(1, &g_screenQuadVBO);
 }
 
-int main(void)
-{
+// Options de ligne de commande des modes benchmark et headless
+struct RunOptions {
+    bool headless = false;
+    bool benchmark = false;              // implicite en headless
+    bool benchScene = false;             // active la scène de benchmark (10 000 objets)
+    int warmupFrames = 60;
+    int frames = 300;
+    const char* cameraPath = nullptr;    // trajectoire enregistrée, sinon orbite procédurale
+    const char* jsonPath = nullptr;      // résultats du benchmark
+    const char* recordPath = nullptr;    // enregistre la caméra de la session (mode fenêtré)
+    const char* capturePrefix = nullptr; // captures PNG "<prefix>_<frame>.png" (headless)
+    int captureEvery = 0;                // 0 : dernière frame seulement
+    const char* tracePath = nullptr;     // trace Chrome de toute la session
+    int vsyncMode = 1;                   // --vsync off|on|adaptive
+    int fpsCap = 0;
+    float dynamicResolutionMs = 0.0f;    // budget GPU de la résolution dynamique, 0 : désactivée
+    bool singleThread = false;           // rendu sur le thread principal (mode fenêtré)
+    int jobThreads = 0;                  // threads du JobSystem, appelant compris ; 0 : un par cœur
+    bool jobBenchmark = false;           // montée en charge du JobSystem, sans contexte GL
+    bool postBenchmark = false;          // flou compute contre fragment, hors écran en 1080p et 4K
+    int blurRadius = 0;                  // --blur : flou du post-traitement au démarrage
+    int antiAliasing = 0;                // --taa : 1, --upscale ÉCHELLE : 2
+    int msaaSamples = 1;                 // --msaa N
+    bool depthPrepass = false;           // --prepass
+    bool overdrawView = false;           // --overdraw : palette de surdessin dans les captures
+    int lightCount = 0;                  // --lights N : lumières dynamiques
+    bool deferred = false;               // --deferred : G-buffer et éclairage par pixel
+    bool allLights = false;              // --all-lights : sans clusters (comparaison)
+    bool shadows = true;                 // --no-shadows : sans ombres de la lumière principale
+    int pcfRadius = 1;                   // --pcf RAYON : 0 (une lecture), 1 (3x3) ou 2 (5x5)
+    bool shadowCache = true;             // --no-shadow-cache : cascades redessinées à chaque frame
+    bool showCascades = false;           // --show-cascades : teinte de chaque cascade
+    float upscaleScale = 1.0f;
+};
+
+void applyCameraPose(const CameraPose& pose) {
+    g_cameraYaw = pose.yaw;
+    g_cameraPitch = pose.pitch;
+    g_cameraDistance = pose.distance;
+}
+
+bool startBenchmark(const RunOptions& options) {
+    CameraPath path = CameraPath::MakeOrbit();
+    if (options.cameraPath && !path.Load(options.cameraPath)) {
+        fprintf(stderr, "benchmark: trajectoire illisible : %s\n", options.cameraPath);
+        return false;
+    }
+    if (options.benchScene) {
+        g_benchScene = true;
+    }
+    g_benchmark.Start(path, options.warmupFrames, options.frames);
+    return true;
+}
+
+void finishBenchmark(const RunOptions& options) {
+    g_benchmark.Finish();
+    printf("renderer: %s\n", (const char*)glGetString(GL_RENDERER));
+    g_benchmark.PrintSummary();
+    if (options.jsonPath && !g_benchmark.WriteJson(options.jsonPath, (const char*)glGetString(GL_RENDERER),
+                                                   (const char*)glGetString(GL_VERSION))) {
+        fprintf(stderr, "benchmark: impossible d'écrire %s\n", options.jsonPath);
+    }
+}
+
+void captureOutput(const char* prefix, int frame) {
+    std::vector<unsigned char> pixels(FBO_WIDTH * FBO_HEIGHT * 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, g_outputFbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, FBO_WIDTH, FBO_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    char path[512];
+    snprintf(path, sizeof(path), "%s_%04d.png", prefix, frame);
+    if (!WritePng(path, FBO_WIDTH, FBO_HEIGHT, pixels.data(), true)) {
+        fprintf(stderr, "headless: impossible d'écrire %s\n", path);
+    }
+}
+
+// Contexte EGL sans surface, le plus récent disponible
+bool createHeadlessContext(HeadlessContext& context) {
+    const int contextVersions[][2] = { { 4, 6 }, { 4, 5 }, { 4, 3 }, { 3, 3 } };
+    for (int i = 0; i < 4 && !context.IsValid(); ++i) {
+        context.Create(contextVersions[i][0], contextVersions[i][1]);
+    }
+    if (!context.IsValid()) {
+        fprintf(stderr, "headless: aucun contexte OpenGL 3.3+ disponible\n");
+        return false;
+    }
+    return true;
+}
+
+// Benchmark sans fenêtre (EGL surfaceless), pour les machines de CI sans GPU.
+// Chaque frame est terminée par glFinish : le temps mesuré inclut le travail GPU, comme un swap sans vsync.
+int runHeadless(const RunOptions& options) {
+    HeadlessContext context;
+    if (!createHeadlessContext(context)) {
+        return -1;
+    }
+
+    g_headless = true;
+    if (!Initialise() || !startBenchmark(options)) {
+        Terminate();
+        context.Destroy();
+        return -1;
+    }
+
+    // Remplace le framebuffer par défaut, inexistant sans surface
+    glGenRenderbuffers(1, &g_outputColor);
+    glBindRenderbuffer(GL_RENDERBUFFER, g_outputColor);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, FBO_WIDTH, FBO_HEIGHT);
+    glGenFramebuffers(1, &g_outputFbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_outputFbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, g_outputColor);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    while (!g_benchmark.IsFinished()) {
+        applyCameraPose(g_benchmark.BeginFrame());
+        Render();
+        glFinish();
+        g_benchmark.EndFrame();
+
+        int frame = g_benchmark.GetMeasuredFrame();
+        bool capture = frame == options.frames - 1 || (options.captureEvery > 0 && frame >= 0 && frame % options.captureEvery == 0);
+        if (options.capturePrefix && capture) {
+            captureOutput(options.capturePrefix, frame);
+        }
+    }
+    finishBenchmark(options);
+
+    glDeleteFramebuffers(1, &g_outputFbo);
+    glDeleteRenderbuffers(1, &g_outputColor);
+    Terminate();
+    context.Destroy();
+    return 0;
+}
+
+// Intervalle de swap du mode choisi ; -1 demande la vsync adaptative (EXT_swap_control_tear)
+void applyVsyncMode(int mode) {
+    int interval = mode == 0 ? 0 : 1;
+    if (mode == 2 && g_adaptiveVsyncSupported) {
+        interval = -1;
+    }
+    glfwSwapInterval(interval);
+    g_vsyncModeApplied = mode;
+}
+
+// Thread du contexte GL : swap de la frame rendue
+void presentFramePacket(FramePacket& packet) {
+    if (packet.vsyncMode != g_vsyncModeApplied) {
+        applyVsyncMode(packet.vsyncMode);
+    }
+    {
+        TRACE_SCOPE("SwapBuffers");
+        glfwSwapBuffers(g_window);
+        if (packet.finishAfterSwap) {
+            glFinish();
+        }
+    }
+    g_framePacer.MarkPresented(packet.inputSampleMs);
+    packet.feedback.frameMs = g_framePacer.GetFrameMs();
+    packet.feedback.latencyMs = g_framePacer.GetLatencyMs();
+}
+
+// Thread de rendu : possède le contexte GL et rend les paquets dans l'ordre de soumission
+void renderThreadMain() {
+    Trace::SetThreadName("Rendu");
+    glfwMakeContextCurrent(g_window);
+    for (;;) {
+        FramePacket* packet = g_submittedPackets.Pop();
+        if (!packet) {
+            break;
+        }
+        // Temps CPU mesuré côté rendu : la construction du paquet se recouvre avec la frame précédente
+        if (packet->benchmarkFrame) {
+            g_benchmark.BeginFrame();
+        }
+        renderFramePacket(*packet);
+        presentFramePacket(*packet);
+        if (packet->benchmarkFrame) {
+            g_benchmark.EndFrame();
+        }
+        g_freePackets.Push(packet);
+    }
+    glfwMakeContextCurrent(NULL);
+}
+
+// Attend que tous les paquets soumis soient rendus (le thread principal n'en détient aucun)
+void waitForRenderThread() {
+    FramePacket* packets[FRAME_PACKET_COUNT];
+    for (int i = 0; i < FRAME_PACKET_COUNT; ++i) {
+        packets[i] = g_freePackets.Pop();
+    }
+    for (int i = 0; i < FRAME_PACKET_COUNT; ++i) {
+        g_freePackets.Push(packets[i]);
+    }
+}
+
+// Montée en charge du JobSystem : culling et matrices d'un million d'objets avec 1, 2, 4... threads.
+// Le temps médian de chaque configuration est comparé à celui d'un seul thread.
+int runJobBenchmark(const RunOptions& options) {
+    const uint32_t objectCount = 1000000;
+    const int warmup = 5;
+    const int iterations = 50;
+
+    // Nuage d'objets déterministe autour d'une caméra à l'origine qui regarde vers -Z
+    std::vector<CullObject> objects(objectCount);
+    uint32_t seed = 12345;
+    for (uint32_t i = 0; i < objectCount; ++i) {
+        CullObject& object = objects[i];
+        for (int k = 0; k < 3; ++k) {
+            seed = seed * 1664525u + 1013904223u;
+            object.position[k] = ((seed >> 8) / 16777216.0f) * 200.0f - 100.0f;
+        }
+        object.angle = 0.37f * i;
+        object.scale = 0.5f + (i % 11) * 0.1f;
+        object.radius = 1.0f;
+    }
+    mat4 view = mat4::lookAt(vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+    mat4 projection = mat4::perspective(60.0f * 3.14159f / 180.0f, 16.0f / 9.0f, 0.1f, 200.0f);
+    Frustum frustum = Frustum::FromMatrix(projection * view);
+
+    uint32_t maxThreads = options.jobThreads > 0 ? (uint32_t)options.jobThreads : std::thread::hardware_concurrency();
+    maxThreads = std::max(1u, std::min(maxThreads, JobSystem::MAX_THREADS));
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t n = 1; n < maxThreads; n *= 2) {
+        threadCounts.push_back(n);
+    }
+    threadCounts.push_back(maxThreads);
+
+    printf("jobs: culling + matrices, %u objets, %d itérations, %u cœurs\n", objectCount, iterations, std::thread::hardware_concurrency());
+    std::vector<double> medians;
+    double baseline = 0.0;
+    for (size_t c = 0; c < threadCounts.size(); ++c) {
+        JobSystem jobs;
+        jobs.Create(threadCounts[c]);
+        ObjectCuller culler;
+        uint32_t visible = 0;
+        for (int i = 0; i < warmup; ++i) {
+            visible = culler.Run(jobs, objects.data(), objectCount, frustum);
+        }
+        std::vector<double> times;
+        for (int i = 0; i < iterations; ++i) {
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            visible = culler.Run(jobs, objects.data(), objectCount, frustum);
+            times.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+        }
+        JobSystem::Stats stats = jobs.GetStats();
+        jobs.Destroy();
+
+        std::sort(times.begin(), times.end());
+        double median = times[times.size() / 2];
+        if (c == 0) {
+            baseline = median;
+        }
+        double speedup = baseline / median;
+        medians.push_back(median);
+        printf("  %2u threads : %8.3f ms  x%.2f  efficacité %3.0f %%  (%u visibles, %u tâches, %u volées)\n",
+               threadCounts[c], median, speedup, 100.0 * speedup / threadCounts[c], visible, stats.executed, stats.stolen);
+    }
+
+    if (options.jsonPath) {
+        FILE* file = fopen(options.jsonPath, "w");
+        if (!file) {
+            fprintf(stderr, "jobs: impossible d'écrire %s\n", options.jsonPath);
+            return -1;
+        }
+        fprintf(file, "{\n  \"objects\": %u,\n  \"iterations\": %d,\n  \"runs\": [\n", objectCount, iterations);
+        for (size_t c = 0; c < threadCounts.size(); ++c) {
+            fprintf(file, "    { \"threads\": %u, \"medianMs\": %.4f, \"speedup\": %.3f }%s\n", threadCounts[c], medians[c],
+                    baseline / medians[c], c + 1 < threadCounts.size() ? "," : "");
+        }
+        fprintf(file, "  ]\n}\n");
+        fclose(file);
+    }
+    return 0;
+}
+
+// Flou séparable hors écran en 1080p et 4K : chemin fragment contre chemin compute à tuiles.
+// Temps des deux passes encadrées par glFinish (médiane) : les requêtes GL_TIME_ELAPSED ne couvrent
+// pas les dispatchs sur tous les pilotes. Affiche aussi l'écart maximal entre les deux sorties.
+int runPostBenchmark(const RunOptions& options) {
+    const int warmup = 3;
+    const int iterations = 20;
+    const int radius = 8;
+    const int sizes[][2] = { { 1920, 1080 }, { 3840, 2160 } };
+
+    HeadlessContext context;
+    if (!createHeadlessContext(context)) {
+        return -1;
+    }
+    DetectGLCaps();
+    SeparableBlur blur;
+    if (!blur.Create()) {
+        fprintf(stderr, "post: shaders du flou introuvables\n");
+        context.Destroy();
+        return -1;
+    }
+    blur.SetRadius(radius);
+    const char* pathNames[2] = { "fragment", "compute" };
+    int pathCount = blur.HasCompute() ? 2 : 1;
+    printf("renderer: %s\n", (const char*)glGetString(GL_RENDERER));
+    printf("post: flou séparable rayon %d, %d itérations%s\n", radius, iterations,
+           blur.HasCompute() ? "" : " (compute indisponible)");
+
+    double medians[2][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };
+    int maxDifference[2] = { 0, 0 };
+    for (int s = 0; s < 2; ++s) {
+        int width = sizes[s][0], height = sizes[s][1];
+
+        // Source : bruit déterministe (pas de compression ni d'effacement rapide possible)
+        std::vector<uint8_t> pixels((size_t)width * height * 4);
+        uint32_t seed = 12345;
+        for (size_t i = 0; i < pixels.size(); ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            pixels[i] = (uint8_t)(seed >> 24);
+        }
+        GLuint textures[3];
+        glGenTextures(3, textures);
+        for (int t = 0; t < 3; ++t) {
+            glBindTexture(GL_TEXTURE_2D, textures[t]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R11F_G11F_B10F, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, t == 0 ? pixels.data() : NULL);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        GLuint framebuffers[2];
+        glGenFramebuffers(2, framebuffers);
+        for (int f = 0; f < 2; ++f) {
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[f]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, textures[f + 1], 0);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        std::vector<uint8_t> results[2];
+        for (int path = 0; path < pathCount; ++path) {
+            std::vector<double> times;
+            for (int i = 0; i < warmup + iterations; ++i) {
+                glFinish();
+                std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+                if (path == 0) {
+                    glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[0]);
+                    blur.DrawFragment(0, textures[0], width, height);
+                    glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[1]);
+                    blur.DrawFragment(1, textures[1], width, height);
+                    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                } else {
+#ifdef GL_VERSION_4_3
+                    blur.DispatchCompute(0, textures[0], textures[1], width, height);
+                    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+                    blur.DispatchCompute(1, textures[1], textures[2], width, height);
+                    glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+#endif
+                }
+                glFinish();
+                if (i >= warmup) {
+                    times.push_back(std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+                }
+            }
+            std::sort(times.begin(), times.end());
+            medians[s][path] = times[times.size() / 2];
+
+            results[path].resize(pixels.size());
+            glBindTexture(GL_TEXTURE_2D, textures[2]);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, results[path].data());
+            printf("  %4dx%-4d %-8s : %8.3f ms  (%.0f Mpixels/s)\n", width, height, pathNames[path], medians[s][path],
+                   (double)width * height / (medians[s][path] * 1000.0));
+        }
+        if (pathCount == 2) {
+            for (size_t i = 0; i < pixels.size(); ++i) {
+                maxDifference[s] = std::max(maxDifference[s], std::abs((int)results[0][i] - (int)results[1][i]));
+            }
+            printf("  %4dx%-4d compute x%.2f, écart max %d/255\n", width, height, medians[s][0] / medians[s][1], maxDifference[s]);
+        }
+        glDeleteFramebuffers(2, framebuffers);
+        glDeleteTextures(3, textures);
+    }
+
+    if (options.jsonPath) {
+        FILE* file = fopen(options.jsonPath, "w");
+        if (!file) {
+            fprintf(stderr, "post: impossible d'écrire %s\n", options.jsonPath);
+        } else {
+            fprintf(file, "{\n  \"renderer\": \"%s\",\n  \"radius\": %d,\n  \"iterations\": %d,\n  \"runs\": [\n",
+                    (const char*)glGetString(GL_RENDERER), radius, iterations);
+            for (int s = 0; s < 2; ++s) {
+                for (int path = 0; path < pathCount; ++path) {
+                    bool last = s == 1 && path == pathCount - 1;
+                    fprintf(file, "    { \"width\": %d, \"height\": %d, \"path\": \"%s\", \"medianMs\": %.4f }%s\n",
+                            sizes[s][0], sizes[s][1], pathNames[path], medians[s][path], last ? "" : ",");
+                }
+            }
+            fprintf(file, "  ]\n}\n");
+            fclose(file);
+        }
+    }
+    blur.Destroy();
+    context.Destroy();
+    return 0;
+}
+
+// Mode fenêtré (GLFW), avec benchmark et enregistrement de trajectoire optionnels.
+// Par défaut, le contexte GL appartient à un thread de rendu qui a une frame de retard sur le
+// thread principal (entrées, interface, préparation de la scène) ; --single-thread fait tout
+// sur le thread principal.
+int runWindowed(const RunOptions& options) {
     if (!glfwInit()){
         return -1;
     }
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
     #endif
 
-    g_window = glfwCreateWindow(FBO_WIDTH, FBO_HEIGHT, "Projet Computer Graphics", NULL, NULL);
+    // Contexte le plus récent disponible : les chemins 4.3+ (MDI, SSBO) sont choisis à l'exécution
+    const int contextVersions[][2] = { { 4, 6 }, { 4, 5 }, { 4, 3 }, { 3, 3 } };
+    for (int i = 0; i < 4 && !g_window; ++i) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, contextVersions[i][0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, contextVersions[i][1]);
+        g_window = glfwCreateWindow(FBO_WIDTH, FBO_HEIGHT, "Projet Computer Graphics", NULL, NULL);
+    }
     if (!g_window) {
         glfwTerminate();
         return -1;
@@ -611,7 +2891,6 @@ int main(void)
     glfwMakeContextCurrent(g_window);
 
     // --- Set GLFW callbacks to also be handled by ImGui ---
-    glfwSetWindowSizeCallback(g_window, window_size_callback);
     glfwSetMouseButtonCallback(g_window, mouse_button_callback);
     glfwSetCursorPosCallback(g_window, cursor_position_callback);
     glfwSetScrollCallback(g_window, scroll_callback);
@@ -620,6 +2899,7 @@ int main(void)
     // ----------------------------------------------------
 
     #ifdef _WIN32
+    glewExperimental = GL_TRUE; // nécessaire pour charger les points d'entrée en profil core
     glewInit();
     #endif
     
@@ -629,13 +2909,208 @@ int main(void)
         return -1;
     }
     
-    while (!glfwWindowShouldClose(g_window)) {
-        Render();
-        glfwSwapBuffers(g_window);
+    if (options.benchmark && !startBenchmark(options)) {
+        Terminate();
+        glfwTerminate();
+        return -1;
+    }
+
+    g_adaptiveVsyncSupported = glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear");
+    g_vsyncMode = options.vsyncMode;
+    g_fpsCap = options.fpsCap;
+    g_framePacer.Create();
+
+    g_renderThreadEnabled = !options.singleThread;
+    if (g_renderThreadEnabled) {
+        for (int i = 0; i < FRAME_PACKET_COUNT; ++i) {
+            g_freePackets.Push(&g_framePackets[i]);
+        }
+        glfwMakeContextCurrent(NULL);
+        g_renderThread = std::thread(renderThreadMain);
+    }
+
+    // Benchmark fenêtré : la caméra suit la trajectoire et la frame inclut le swap (donc la vsync)
+    CameraPath recordedPath;
+    int builtFrames = 0;
+    while (!glfwWindowShouldClose(g_window) &&
+           !(g_benchmark.IsRunning() && builtFrames >= g_benchmark.GetFrameCount())) {
+        g_framePacer.SetTargetFps((float)g_fpsCap);
+        {
+            TRACE_SCOPE("FramePacer::Wait");
+            g_framePacer.Wait();
+        }
+        // Paquet libre : avec le thread de rendu, attend que la frame N-1 soit rendue
+        FramePacket* packet = g_renderThreadEnabled ? g_freePackets.Pop() : &g_framePackets[0];
+        // Entrées lues au dernier moment, après l'attente, juste avant de construire la frame
         glfwPollEvents();
+        packet->inputSampleMs = g_framePacer.MarkInputSampled();
+
+        packet->benchmarkFrame = g_renderThreadEnabled && g_benchmark.IsRunning();
+        if (packet->benchmarkFrame) {
+            applyCameraPose(g_benchmark.GetPose(builtFrames));
+        } else if (g_benchmark.IsRunning()) {
+            applyCameraPose(g_benchmark.BeginFrame());
+        }
+        buildFramePacket(*packet);
+        builtFrames++;
+
+        if (g_renderThreadEnabled) {
+            g_submittedPackets.Push(packet);
+            // Textures ImGui partagées avec le contexte : mises à jour avant le NewFrame suivant
+            if (packet->uiTexturesPending) {
+                waitForRenderThread();
+            }
+        } else {
+            renderFramePacket(*packet);
+            presentFramePacket(*packet);
+            if (g_benchmark.IsRunning()) {
+                g_benchmark.EndFrame();
+            }
+        }
+        if (options.recordPath) {
+            CameraPose pose = { g_cameraYaw, g_cameraPitch, g_cameraDistance };
+            recordedPath.Add(pose);
+        }
+    }
+    if (g_renderThreadEnabled) {
+        g_submittedPackets.Push(nullptr);
+        g_renderThread.join();
+        glfwMakeContextCurrent(g_window);
+    }
+    if (g_benchmark.IsFinished()) {
+        finishBenchmark(options);
+    }
+    if (options.recordPath && !recordedPath.Save(options.recordPath)) {
+        fprintf(stderr, "impossible d'écrire %s\n", options.recordPath);
     }
 
+    g_framePacer.Destroy();
     Terminate();
     glfwTerminate();
     return 0;
 }
+
+int main(int argc, char** argv)
+{
+    RunOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            options.headless = true;
+        } else if (strcmp(argv[i], "--benchmark") == 0) {
+            options.benchmark = true;
+        } else if (strcmp(argv[i], "--bench-scene") == 0) {
+            options.benchScene = true;
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            options.warmupFrames = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            options.frames = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--path") == 0 && i + 1 < argc) {
+            options.cameraPath = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            options.jsonPath = argv[++i];
+        } else if (strcmp(argv[i], "--record-path") == 0 && i + 1 < argc) {
+            options.recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            options.capturePrefix = argv[++i];
+        } else if (strcmp(argv[i], "--capture-every") == 0 && i + 1 < argc) {
+            options.captureEvery = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            options.tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--vsync") == 0 && i + 1 < argc) {
+            ++i;
+            options.vsyncMode = strcmp(argv[i], "off") == 0 ? 0 : (strcmp(argv[i], "adaptive") == 0 ? 2 : 1);
+        } else if (strcmp(argv[i], "--fps-cap") == 0 && i + 1 < argc) {
+            options.fpsCap = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--single-thread") == 0) {
+            options.singleThread = true;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            options.jobThreads = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--job-benchmark") == 0) {
+            options.jobBenchmark = true;
+        } else if (strcmp(argv[i], "--post-benchmark") == 0) {
+            options.postBenchmark = true;
+        } else if (strcmp(argv[i], "--blur") == 0 && i + 1 < argc) {
+            options.blurRadius = std::max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--msaa") == 0 && i + 1 < argc) {
+            options.msaaSamples = std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--prepass") == 0) {
+            options.depthPrepass = true;
+        } else if (strcmp(argv[i], "--overdraw") == 0) {
+            options.overdrawView = true;
+        } else if (strcmp(argv[i], "--lights") == 0 && i + 1 < argc) {
+            options.lightCount = std::min(4096, std::max(0, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--all-lights") == 0) {
+            options.allLights = true;
+        } else if (strcmp(argv[i], "--deferred") == 0) {
+            options.deferred = true;
+        } else if (strcmp(argv[i], "--no-shadows") == 0) {
+            options.shadows = false;
+        } else if (strcmp(argv[i], "--pcf") == 0 && i + 1 < argc) {
+            options.pcfRadius = std::min(2, std::max(0, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "--no-shadow-cache") == 0) {
+            options.shadowCache = false;
+        } else if (strcmp(argv[i], "--show-cascades") == 0) {
+            options.showCascades = true;
+        } else if (strcmp(argv[i], "--taa") == 0) {
+            options.antiAliasing = 1;
+        } else if (strcmp(argv[i], "--upscale") == 0 && i + 1 < argc) {
+            options.antiAliasing = 2;
+            options.upscaleScale = std::min(1.0f, std::max(0.25f, (float)atof(argv[++i])));
+        } else if (strcmp(argv[i], "--dynamic-resolution") == 0 && i + 1 < argc) {
+            options.dynamicResolutionMs = std::max(0.0f, (float)atof(argv[++i]));
+        } else {
+            fprintf(stderr, "usage: %s [--headless | --benchmark | --record-path FICHIER]\n"
+                            "         [--warmup N] [--frames M] [--path FICHIER] [--json FICHIER] [--bench-scene]\n"
+                            "         [--capture PREFIXE] [--capture-every K] [--trace FICHIER]\n"
+                            "         [--vsync off|on|adaptive] [--fps-cap N] [--dynamic-resolution MS]\n"
+                            "         [--single-thread] [--jobs N] [--job-benchmark]\n"
+                            "         [--blur RAYON] [--post-benchmark] [--taa | --upscale ÉCHELLE] [--msaa 2|4|8]\n"
+                            "         [--prepass] [--overdraw] [--lights N] [--all-lights] [--deferred]\n"
+                            "         [--no-shadows] [--pcf 0|1|2] [--no-shadow-cache] [--show-cascades]\n", argv[0]);
+            return -1;
+        }
+    }
+
+    g_blurRadius = options.blurRadius > SeparableBlur::MAX_RADIUS ? SeparableBlur::MAX_RADIUS : options.blurRadius;
+    g_antiAliasingSettings.mode = options.antiAliasing;
+    g_antiAliasingSettings.msaaSamples = options.msaaSamples;
+    g_depthSettings.prepass = options.depthPrepass;
+    g_depthSettings.overdraw = options.overdrawView;
+    g_lightSettings.count = options.lightCount;
+    g_lightSettings.clustered = !options.allLights;
+    g_deferredShading = options.deferred;
+    g_shadowSettings.enabled = options.shadows;
+    g_shadowSettings.pcfRadius = options.pcfRadius;
+    g_shadowSettings.cache = options.shadowCache;
+    g_shadowSettings.showCascades = options.showCascades;
+    if (options.antiAliasing == 2) {
+        g_resolutionSettings.scale = options.upscaleScale;
+    }
+    if (options.dynamicResolutionMs > 0.0f) {
+        g_resolutionSettings.dynamic = true;
+        g_resolutionSettings.budgetMs = options.dynamicResolutionMs;
+    }
+
+    Trace::SetThreadName("Principal");
+    if (options.tracePath) {
+        g_tracePath = options.tracePath;
+        Trace::Start();
+    }
+    int result;
+    if (options.jobBenchmark) {
+        result = runJobBenchmark(options);
+    } else if (options.postBenchmark) {
+        result = runPostBenchmark(options);
+    } else {
+        g_jobSystem.Create((uint32_t)options.jobThreads);
+        result = options.headless ? runHeadless(options) : runWindowed(options);
+        g_jobSystem.Destroy();
+    }
+    if (Trace::IsRecording()) {
+        Trace::Stop();
+        if (!Trace::WriteJson(g_tracePath)) {
+            fprintf(stderr, "impossible d'écrire %s\n", g_tracePath);
+        }
+    }
+    return result;
+}
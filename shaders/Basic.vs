@@ -6,8 +6,12 @@ layout(location = 2) in vec2 a_uv;
 
 out vec2 v_uv;
 
-// La matrice modèle reste une uniform individuelle
-uniform mat4 u_model;
+// Données par objet, écrites dans l'anneau d'uniforms et liées par glBindBufferRange
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo; // x : indice du matériau
+};
 
 // Définition du bloc UBO partagé pour les matrices
 layout (std140) uniform Matrices
@@ -0,0 +1,57 @@
+#version 330 core
+// Descente du bloom (Bloom::Downsample) : 13 lectures bilinéaires autour du texel cible,
+// regroupées en cinq carrés de 4 texels (un central de poids 0.5, quatre en coin de poids 0.125)
+out vec4 FragColor;
+
+uniform sampler2D u_source;
+uniform vec2 u_sourceTexel;     // 1 / taille de la source
+uniform vec2 u_targetSize;
+uniform vec2 u_uvScale;         // zone lue de la source
+uniform vec2 u_uvMax;
+uniform int u_karisAverage;     // premier niveau : moyenne pondérée par 1 / (1 + luminance)
+
+vec3 fetch(vec2 uv, vec2 offset)
+{
+    return texture(u_source, clamp(uv + offset * u_sourceTexel, 0.5 * u_sourceTexel, u_uvMax)).rgb;
+}
+
+float karisWeight(vec3 color)
+{
+    return 1.0 / (1.0 + dot(color, vec3(0.2126, 0.7152, 0.0722)));
+}
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / u_targetSize * u_uvScale;
+
+    vec3 a = fetch(uv, vec2(-2.0, 2.0));
+    vec3 b = fetch(uv, vec2(0.0, 2.0));
+    vec3 c = fetch(uv, vec2(2.0, 2.0));
+    vec3 d = fetch(uv, vec2(-2.0, 0.0));
+    vec3 e = fetch(uv, vec2(0.0, 0.0));
+    vec3 f = fetch(uv, vec2(2.0, 0.0));
+    vec3 g = fetch(uv, vec2(-2.0, -2.0));
+    vec3 h = fetch(uv, vec2(0.0, -2.0));
+    vec3 i = fetch(uv, vec2(2.0, -2.0));
+    vec3 j = fetch(uv, vec2(-1.0, 1.0));
+    vec3 k = fetch(uv, vec2(1.0, 1.0));
+    vec3 l = fetch(uv, vec2(-1.0, -1.0));
+    vec3 m = fetch(uv, vec2(1.0, -1.0));
+
+    vec3 groups[5];
+    groups[0] = (j + k + l + m) * 0.25;
+    groups[1] = (a + b + d + e) * 0.25;
+    groups[2] = (b + c + e + f) * 0.25;
+    groups[3] = (d + e + g + h) * 0.25;
+    groups[4] = (e + f + h + i) * 0.25;
+    float weights[5] = float[](0.5, 0.125, 0.125, 0.125, 0.125);
+
+    vec3 color = vec3(0.0);
+    float total = 0.0;
+    for (int n = 0; n < 5; ++n) {
+        float weight = weights[n] * (u_karisAverage != 0 ? karisWeight(groups[n]) : 1.0);
+        color += groups[n] * weight;
+        total += weight;
+    }
+    FragColor = vec4(color / total, 1.0);
+}
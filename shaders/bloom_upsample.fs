@@ -0,0 +1,21 @@
+#version 330 core
+// Remontée du bloom (Bloom::Upsample) : filtre tente 3x3 du niveau inférieur, ajouté au niveau
+// courant par blending additif
+out vec4 FragColor;
+
+uniform sampler2D u_source;
+uniform vec2 u_sourceTexel;     // 1 / taille de la source
+uniform vec2 u_targetSize;
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / u_targetSize;
+    vec2 t = u_sourceTexel;
+
+    vec3 color = texture(u_source, uv).rgb * 4.0;
+    color += (texture(u_source, uv + vec2(-t.x, 0.0)).rgb + texture(u_source, uv + vec2(t.x, 0.0)).rgb +
+              texture(u_source, uv + vec2(0.0, -t.y)).rgb + texture(u_source, uv + vec2(0.0, t.y)).rgb) * 2.0;
+    color += texture(u_source, uv + vec2(-t.x, -t.y)).rgb + texture(u_source, uv + vec2(t.x, -t.y)).rgb +
+             texture(u_source, uv + vec2(-t.x, t.y)).rgb + texture(u_source, uv + vec2(t.x, t.y)).rgb;
+    FragColor = vec4(color / 16.0, 1.0);
+}
@@ -0,0 +1,24 @@
+#version 330 core
+// Chemin fragment du flou séparable (repli sans compute shaders) : mêmes poids que blur.comp,
+// mais chaque pixel relit ses 2 * rayon + 1 voisins dans la texture
+#define MAX_RADIUS 16
+
+out vec4 FragColor;
+
+uniform sampler2D u_source;
+uniform ivec2 u_direction;      // (1, 0) horizontal, (0, 1) vertical
+uniform ivec2 u_size;           // zone lue (résolution dynamique)
+uniform int u_radius;
+uniform float u_weights[MAX_RADIUS + 1];
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    ivec2 maxTexel = u_size - 1;
+    vec4 sum = texelFetch(u_source, texel, 0) * u_weights[0];
+    for (int k = 1; k <= u_radius; ++k) {
+        sum += texelFetch(u_source, clamp(texel - u_direction * k, ivec2(0), maxTexel), 0) * u_weights[k];
+        sum += texelFetch(u_source, clamp(texel + u_direction * k, ivec2(0), maxTexel), 0) * u_weights[k];
+    }
+    FragColor = sum;
+}
@@ -0,0 +1,74 @@
+#version 330 core
+// Éclairage différé (DeferredLighting) : un fragment par pixel rendu, mêmes formules que phong.fs
+out vec4 fragColor;
+
+// G-buffer (voir gbuffer.fs) et profondeur de la scène
+uniform sampler2D u_gbufferAlbedo;   // rgb : racine de l'albedo, a : intensité spéculaire
+uniform sampler2D u_gbufferNormal;   // rg : normale (octaédrique), b : rugosité, a : éclairé
+uniform sampler2D u_depth;
+uniform mat4 u_inverseViewProjection; // clip (projection de la frame, décalée par le TAA) -> monde
+uniform vec2 u_renderSize;
+
+// Propriétés de la lumière
+uniform vec3 u_lightDir;     // vers la lumière (directionnelle, unitaire)
+uniform vec3 u_lightColor;
+
+// Position de la caméra
+uniform vec3 u_viewPos;
+
+#include "lighting.glsl"
+
+// Inverse de encodeNormal (gbuffer.fs)
+vec3 decodeNormal(vec2 encoded)
+{
+    vec2 p = encoded * 2.0 - 1.0;
+    vec3 n = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(u_depth, pixel, 0).r;
+    // Aucun objet : couleur d'effacement du rendu forward, recouverte ensuite par la skybox
+    if (depth == 1.0) {
+        fragColor = vec4(0.1, 0.1, 0.1, 1.0);
+        return;
+    }
+    vec4 albedoSpecular = texelFetch(u_gbufferAlbedo, pixel, 0);
+    vec4 normalRoughness = texelFetch(u_gbufferNormal, pixel, 0);
+    if (normalRoughness.a < 0.5) {
+        fragColor = vec4(albedoSpecular.rgb * albedoSpecular.rgb, 1.0);
+        return;
+    }
+
+    vec4 clip = vec4(gl_FragCoord.xy / u_renderSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 world = u_inverseViewProjection * clip;
+    vec3 worldPos = world.xyz / world.w;
+    vec3 norm = decodeNormal(normalRoughness.rg);
+    float roughness = max(normalRoughness.b, 0.01);
+    vec4 specularShininess = vec4(vec3(albedoSpecular.a), 2.0 / (roughness * roughness) - 2.0);
+    vec3 albedo = albedoSpecular.rgb * albedoSpecular.rgb;
+
+    float ambientStrength = 0.1;
+    vec3 ambient = ambientStrength * u_lightColor;
+
+    vec3 lightDir = u_lightDir;
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * u_lightColor;
+
+    vec3 viewDir = normalize(u_viewPos - worldPos);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(norm, halfwayDir), 0.0), specularShininess.a);
+    vec3 specular = spec * u_lightColor * specularShininess.rgb;
+
+    vec3 lights = dynamicLights(worldPos, norm, viewDir, specularShininess);
+    int cascade;
+    float shadow = keyLightShadow(worldPos, norm, -(view * vec4(worldPos, 1.0)).z, cascade);
+    vec3 result = (ambient + shadow * (diffuse + specular) + lights) * albedo;
+    if (u_showCascades != 0)
+        result *= cascadeTint(cascade);
+    fragColor = vec4(result, 1.0);
+}
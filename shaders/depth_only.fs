@@ -0,0 +1,5 @@
+#version 330 core
+// Pré-passe de profondeur : aucune couleur écrite, seul le test et l'écriture de profondeur comptent
+void main()
+{
+}
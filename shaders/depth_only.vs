@@ -0,0 +1,23 @@
+#version 330 core
+// Pré-passe de profondeur : position seule, avec la même expression que les shaders d'objets
+layout(location = 0) in vec3 a_position;
+
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo;
+};
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = u_model * vec4(a_position, 1.0);
+    gl_Position = projection * view * worldPos;
+}
@@ -0,0 +1,18 @@
+#version 330 core
+// Pré-passe de profondeur, variante instanciée (matrice par instance aux locations 3 à 6)
+layout(location = 0) in vec3 a_position;
+layout(location = 3) in mat4 a_instanceModel;
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = a_instanceModel * vec4(a_position, 1.0);
+    gl_Position = projection * view * worldPos;
+}
@@ -0,0 +1,29 @@
+#version 430 core
+// Pré-passe de profondeur, variante MDI (matrice lue dans le SSBO de MultiDrawBatch)
+layout(location = 0) in vec3 a_position;
+layout(location = 7) in uint a_drawId;
+
+struct DrawRecord
+{
+    mat4 model;
+    uvec4 info;
+};
+
+layout(std430, binding = 0) readonly buffer DrawRecords
+{
+    DrawRecord draws[];
+};
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = draws[a_drawId].model * vec4(a_position, 1.0);
+    gl_Position = projection * view * worldPos;
+}
@@ -3,8 +3,12 @@
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_normal;
 
-// La matrice modèle reste une uniform individuelle
-uniform mat4 u_model;
+// Données par objet, écrites dans l'anneau d'uniforms et liées par glBindBufferRange
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo; // x : indice du matériau
+};
 
 // Définition du bloc UBO partagé pour les matrices
 layout (std140) uniform Matrices
@@ -16,6 +20,9 @@ layout (std140) uniform Matrices
 out vec3 v_worldPos;
 out vec3 v_worldNormal;
 
+// Position identique à la pré-passe de profondeur (depth_only.vs) : même expression, invariante
+invariant gl_Position;
+
 void main()
 {
     vec4 worldPos = u_model * vec4(a_position, 1.0);
@@ -0,0 +1,28 @@
+#version 330 core
+
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec3 a_normal;
+
+// Matrice modèle par instance (divisor 1, occupe les locations 3 à 6)
+layout(location = 3) in mat4 a_instanceModel;
+
+// Définition du bloc UBO partagé pour les matrices
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+out vec3 v_worldPos;
+out vec3 v_worldNormal;
+
+// Position identique à la pré-passe de profondeur (depth_only.vs) : même expression, invariante
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = a_instanceModel * vec4(a_position, 1.0);
+    v_worldPos    = worldPos.xyz;
+    v_worldNormal = mat3(a_instanceModel) * a_normal;
+    gl_Position   = projection * view * worldPos;
+}
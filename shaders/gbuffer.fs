@@ -0,0 +1,58 @@
+#version 330 core
+// G-buffer des surfaces Phong (phong.vs, phong_instanced.vs), éclairées par deferred_lighting.fs
+// Cibles du G-buffer (DeferredLighting)
+layout(location = 0) out vec4 g_albedo;  // rgb : racine de l'albedo (sombres plus précis sur 8 bits), a : intensité spéculaire
+layout(location = 1) out vec4 g_normal;  // rg : normale (octaédrique), b : rugosité, a : 1 éclairé, 0 couleur telle quelle
+
+in vec3 v_worldNormal;
+in vec2 v_uv;
+
+// Cartes des matériaux, une couche par texture (MaterialSystem::TEXTURE_ARRAY_UNIT)
+uniform sampler2DArray u_materialTextures;
+
+// Données par objet (même déclaration que dans le vertex shader)
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo; // x : indice du matériau
+};
+
+// Table des matériaux (MaterialSystem)
+struct Material
+{
+    vec4 diffuse;   // rgb : Kd, a : opacité
+    vec4 specular;  // rgb : Ks, a : brillance (Ns)
+    vec4 ambient;   // rgb : Ka
+    ivec4 maps;     // textures diffuse, normale, occlusion, rugosité (-1 : absente)
+};
+
+layout (std140) uniform Materials
+{
+    Material u_materials[256];
+};
+
+// Normale unitaire -> carré [0, 1]² (projection octaédrique, repliée pour z < 0)
+vec2 encodeNormal(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 p = n.xy;
+    if (n.z < 0.0)
+        p = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return p * 0.5 + 0.5;
+}
+
+// Surface éclairée : la brillance Ns devient une rugosité dans [0, 1], plus précise sur 10 bits
+void writeSurface(Material material, vec3 normal, vec2 uv)
+{
+    vec3 albedo = material.diffuse.rgb;
+    if (material.maps.x >= 0)
+        albedo *= texture(u_materialTextures, vec3(uv, float(material.maps.x))).rgb;
+    float specular = max(material.specular.r, max(material.specular.g, material.specular.b));
+    g_albedo = vec4(sqrt(albedo), specular);
+    g_normal = vec4(encodeNormal(normalize(normal)), sqrt(2.0 / (material.specular.a + 2.0)), 1.0);
+}
+
+void main()
+{
+    writeSurface(u_materials[u_objectInfo.x], v_worldNormal, v_uv);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+// G-buffer des objets réfléchissants (env.vs, env_instanced.vs) : la réflexion est la couleur finale
+// Cibles du G-buffer (DeferredLighting)
+layout(location = 0) out vec4 g_albedo;  // rgb : racine de l'albedo (sombres plus précis sur 8 bits), a : intensité spéculaire
+layout(location = 1) out vec4 g_normal;  // rg : normale (octaédrique), b : rugosité, a : 1 éclairé, 0 couleur telle quelle
+
+in vec3 v_worldPos;
+in vec3 v_worldNormal;
+
+uniform samplerCube u_envMap;
+uniform vec3        u_cameraPos;
+
+void main()
+{
+    vec3 I = normalize(v_worldPos - u_cameraPos);
+    vec3 R = reflect(I, normalize(v_worldNormal));
+    g_albedo = vec4(sqrt(texture(u_envMap, R).rgb), 0.0);
+    g_normal = vec4(0.5, 0.5, 0.0, 0.0);
+}
@@ -0,0 +1,41 @@
+#version 330 core
+// G-buffer des objets texturés sans éclairage (texture.vs, texture_instanced.vs)
+// Cibles du G-buffer (DeferredLighting)
+layout(location = 0) out vec4 g_albedo;  // rgb : racine de l'albedo (sombres plus précis sur 8 bits), a : intensité spéculaire
+layout(location = 1) out vec4 g_normal;  // rg : normale (octaédrique), b : rugosité, a : 1 éclairé, 0 couleur telle quelle
+
+in vec2 v_uv;
+
+// Cartes des matériaux, une couche par texture (MaterialSystem::TEXTURE_ARRAY_UNIT)
+uniform sampler2DArray u_materialTextures;
+
+// Données par objet (même déclaration que dans le vertex shader)
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo; // x : indice du matériau
+};
+
+// Table des matériaux (MaterialSystem)
+struct Material
+{
+    vec4 diffuse;   // rgb : Kd, a : opacité
+    vec4 specular;  // rgb : Ks, a : brillance (Ns)
+    vec4 ambient;   // rgb : Ka
+    ivec4 maps;     // textures diffuse, normale, occlusion, rugosité (-1 : absente)
+};
+
+layout (std140) uniform Materials
+{
+    Material u_materials[256];
+};
+
+void main()
+{
+    Material material = u_materials[u_objectInfo.x];
+    vec3 albedo = material.diffuse.rgb;
+    if (material.maps.x >= 0)
+        albedo *= texture(u_materialTextures, vec3(v_uv, float(material.maps.x))).rgb;
+    g_albedo = vec4(sqrt(albedo), 0.0);
+    g_normal = vec4(0.5, 0.5, 0.0, 0.0);
+}
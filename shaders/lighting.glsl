@@ -0,0 +1,104 @@
+// Éclairage commun à phong.fs, à ses variantes MDI et à deferred_lighting.fs, inclus par
+// GLShader (#include "lighting.glsl") : lumières dynamiques des clusters et ombres de la
+// lumière principale
+
+// Matrices de la frame (profondeur en vue du fragment, pour retrouver sa tranche)
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+// Lumières dynamiques (LightClusters), en texture buffers
+uniform samplerBuffer u_lights;        // deux texels par lumière : position + rayon, couleur
+uniform usamplerBuffer u_clusters;     // (premier indice, nombre de lumières) par cluster
+uniform usamplerBuffer u_lightIndices;
+uniform int u_lightCount;
+uniform int u_clusteredLights;         // 0 : toutes les lumières pour chaque fragment (comparaison)
+uniform ivec3 u_clusterGrid;           // tuiles en x, en y, tranches de profondeur
+uniform vec2 u_clusterTileScale;       // tuiles par pixel rendu
+uniform vec2 u_clusterDepth;           // fin de la première tranche, tranches par unité de log(profondeur)
+
+// Diffus et spéculaire (Blinn-Phong) d'une lumière ponctuelle, atténuée jusqu'à zéro à son rayon
+vec3 pointLight(int light, vec3 worldPos, vec3 norm, vec3 viewDir, vec4 specular)
+{
+    vec4 positionRadius = texelFetch(u_lights, 2 * light);
+    vec3 toLight = positionRadius.xyz - worldPos;
+    float distance2 = dot(toLight, toLight);
+    float radius2 = positionRadius.w * positionRadius.w;
+    if (distance2 >= radius2)
+        return vec3(0.0);
+    float falloff = 1.0 - (distance2 * distance2) / (radius2 * radius2);
+    float attenuation = falloff * falloff / (distance2 + 1.0);
+    vec3 lightDir = toLight * inversesqrt(distance2);
+    float diff = max(dot(norm, lightDir), 0.0);
+    float spec = pow(max(dot(norm, normalize(lightDir + viewDir)), 0.0), specular.a);
+    return attenuation * texelFetch(u_lights, 2 * light + 1).rgb * (diff + spec * specular.rgb);
+}
+
+// Somme des lumières du cluster du fragment (tuile écran, tranche de profondeur)
+vec3 dynamicLights(vec3 worldPos, vec3 norm, vec3 viewDir, vec4 specular)
+{
+    vec3 result = vec3(0.0);
+    if (u_clusteredLights == 0) {
+        for (int i = 0; i < u_lightCount; ++i)
+            result += pointLight(i, worldPos, norm, viewDir, specular);
+        return result;
+    }
+    if (u_lightCount == 0)
+        return result;
+    ivec2 tile = min(ivec2(gl_FragCoord.xy * u_clusterTileScale), u_clusterGrid.xy - 1);
+    float depth = -(view * vec4(worldPos, 1.0)).z;
+    int slice = 0;
+    if (depth > u_clusterDepth.x)
+        slice = min(1 + int(log(depth / u_clusterDepth.x) * u_clusterDepth.y), u_clusterGrid.z - 1);
+    uvec2 range = texelFetch(u_clusters, (slice * u_clusterGrid.y + tile.y) * u_clusterGrid.x + tile.x).rg;
+    for (uint i = 0u; i < range.y; ++i)
+        result += pointLight(int(texelFetch(u_lightIndices, int(range.x + i)).r), worldPos, norm, viewDir, specular);
+    return result;
+}
+
+// Ombres de la lumière principale (ShadowCascades), une couche de texture par cascade
+uniform sampler2DArrayShadow u_shadowMap;
+uniform mat4 u_shadowMatrices[3];      // ShadowCascades::CASCADE_COUNT ; monde -> coordonnées de texture et profondeur [0, 1]
+uniform vec4 u_cascadeSplits;          // profondeur en vue de fin de chaque cascade
+uniform vec4 u_cascadeTexels;          // taille d'un texel en unités monde, par cascade
+uniform int u_cascadeCount;            // 0 : pas d'ombres
+uniform int u_shadowPcf;               // rayon du filtre en texels (0 : une lecture, filtrée sur 2x2)
+uniform int u_showCascades;            // teinte de la cascade lue (réglage des cascades)
+
+// Part de la lumière principale qui atteint le point (1 : éclairé) ; "cascade" reçoit la cascade
+// lue (-1 : au-delà de la distance d'ombre)
+float keyLightShadow(vec3 worldPos, vec3 norm, float viewDepth, out int cascade)
+{
+    cascade = -1;
+    if (u_cascadeCount == 0)
+        return 1.0;
+    int c = 0;
+    while (c < u_cascadeCount && viewDepth > u_cascadeSplits[c])
+        ++c;
+    if (c == u_cascadeCount)
+        return 1.0;
+    cascade = c;
+
+    // Décalage le long de la normale, à l'échelle des texels de la cascade (acné)
+    vec4 coord = u_shadowMatrices[c] * vec4(worldPos + norm * (1.5 * u_cascadeTexels[c]), 1.0);
+    vec2 texel = 1.0 / vec2(textureSize(u_shadowMap, 0).xy);
+    float lit = 0.0;
+    for (int y = -u_shadowPcf; y <= u_shadowPcf; ++y)
+        for (int x = -u_shadowPcf; x <= u_shadowPcf; ++x)
+            lit += texture(u_shadowMap, vec4(coord.xy + vec2(x, y) * texel, float(c), coord.z));
+    float taps = float(2 * u_shadowPcf + 1);
+    lit /= taps * taps;
+
+    // Fondu sur le dernier dixième de la distance d'ombre : pas de limite nette
+    float shadowDistance = u_cascadeSplits[u_cascadeCount - 1];
+    return mix(1.0, lit, clamp((shadowDistance - viewDepth) / (0.1 * shadowDistance), 0.0, 1.0));
+}
+
+vec3 cascadeTint(int cascade)
+{
+    if (cascade < 0)
+        return vec3(1.0);
+    return mix(vec3(0.4), vec3(1.0), vec3(equal(ivec3(cascade), ivec3(0, 1, 2))));
+}
@@ -0,0 +1,10 @@
+#version 330 core
+// Vue de surdessin (OverdrawView) : couleur d'un niveau, le test de stencil choisit les pixels
+out vec4 FragColor;
+
+uniform vec3 u_color;
+
+void main()
+{
+    FragColor = vec4(u_color, 1.0);
+}
@@ -1,9 +1,14 @@
 #version 330 core
 layout(location = 0) in vec3 a_position;
 layout(location = 1) in vec3 a_normal;
+layout(location = 2) in vec2 a_uv;
 
-// La matrice modèle reste une uniform individuelle
-uniform mat4 u_model;
+// Données par objet, écrites dans l'anneau d'uniforms et liées par glBindBufferRange
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo; // x : indice du matériau
+};
 
 // Définition du bloc UBO partagé pour les matrices
 layout (std140) uniform Matrices
@@ -15,15 +20,21 @@ layout (std140) uniform Matrices
 // Données à passer au Fragment Shader
 out vec3 v_worldPos;
 out vec3 v_worldNormal;
+out vec2 v_uv;
+
+// Position identique à la pré-passe de profondeur (depth_only.vs) : même expression, invariante
+invariant gl_Position;
 
 void main()
 {
+    v_uv = a_uv;
     // Calcule la position du sommet dans l'espace monde
-    v_worldPos = vec3(u_model * vec4(a_position, 1.0));
+    vec4 worldPos = u_model * vec4(a_position, 1.0);
+    v_worldPos = worldPos.xyz;
     
     // Correction: Utilisation d'une transformation de normale plus simple et robuste
     v_worldNormal = normalize(mat3(u_model) * a_normal);
     
     // Position finale du sommet pour le rendu en utilisant les matrices de l'UBO
-    gl_Position = projection * view * vec4(v_worldPos, 1.0);
+    gl_Position = projection * view * worldPos;
 }
@@ -0,0 +1,34 @@
+#version 330 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec3 a_normal;
+layout(location = 2) in vec2 a_uv;
+
+// Matrice modèle par instance (divisor 1, occupe les locations 3 à 6)
+layout(location = 3) in mat4 a_instanceModel;
+
+// Définition du bloc UBO partagé pour les matrices
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+// Données à passer au Fragment Shader
+out vec3 v_worldPos;
+out vec3 v_worldNormal;
+out vec2 v_uv;
+
+// Position identique à la pré-passe de profondeur (depth_only.vs) : même expression, invariante
+invariant gl_Position;
+
+void main()
+{
+    v_uv = a_uv;
+    // Calcule la position du sommet dans l'espace monde
+    vec4 worldPos = a_instanceModel * vec4(a_position, 1.0);
+    v_worldPos = worldPos.xyz;
+    v_worldNormal = normalize(mat3(a_instanceModel) * a_normal);
+
+    // Position finale du sommet pour le rendu en utilisant les matrices de l'UBO
+    gl_Position = projection * view * worldPos;
+}
@@ -0,0 +1,63 @@
+#version 330 core
+out vec4 fragColor;
+
+// Données reçues du Vertex Shader
+in vec3 v_worldPos;
+in vec3 v_worldNormal;
+in vec2 v_uv;
+flat in uint v_materialIndex; // indice dans le bloc Materials
+
+// Table des matériaux (MaterialSystem)
+struct Material
+{
+    vec4 diffuse;   // rgb : Kd, a : opacité
+    vec4 specular;  // rgb : Ks, a : brillance (Ns)
+    vec4 ambient;   // rgb : Ka
+    ivec4 maps;     // textures diffuse, normale, occlusion, rugosité (-1 : absente)
+};
+
+layout (std140) uniform Materials
+{
+    Material u_materials[256];
+};
+
+// Cartes des matériaux, une couche par texture (MaterialSystem::TEXTURE_ARRAY_UNIT)
+uniform sampler2DArray u_materialTextures;
+
+// Propriétés de la lumière
+uniform vec3 u_lightDir;     // vers la lumière (directionnelle, unitaire)
+uniform vec3 u_lightColor;
+
+// Position de la caméra
+uniform vec3 u_viewPos;
+
+#include "lighting.glsl"
+
+void main()
+{
+    Material material = u_materials[v_materialIndex];
+
+    float ambientStrength = 0.1;
+    vec3 ambient = ambientStrength * u_lightColor;
+
+    vec3 norm = normalize(v_worldNormal);
+    vec3 lightDir = u_lightDir;
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * u_lightColor;
+
+    vec3 viewDir = normalize(u_viewPos - v_worldPos);
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float spec = pow(max(dot(norm, halfwayDir), 0.0), material.specular.a);
+    vec3 specular = spec * u_lightColor * material.specular.rgb;
+
+    vec3 albedo = material.diffuse.rgb;
+    if (material.maps.x >= 0)
+        albedo *= texture(u_materialTextures, vec3(v_uv, float(material.maps.x))).rgb;
+    vec3 lights = dynamicLights(v_worldPos, norm, viewDir, material.specular);
+    int cascade;
+    float shadow = keyLightShadow(v_worldPos, norm, -(view * vec4(v_worldPos, 1.0)).z, cascade);
+    vec3 result = (ambient + shadow * (diffuse + specular) + lights) * albedo;
+    if (u_showCascades != 0)
+        result *= cascadeTint(cascade);
+    fragColor = vec4(result, 1.0);
+}
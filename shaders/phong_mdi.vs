@@ -0,0 +1,45 @@
+#version 430 core
+layout(location = 0) in vec3 a_position;
+layout(location = 1) in vec3 a_normal;
+layout(location = 2) in vec2 a_uv;
+
+// Indice du dessin : attribut par instance (divisor 1) décalé par baseInstance de la commande indirecte
+layout(location = 7) in uint a_drawId;
+
+// Données par dessin, remplies par MultiDrawBatch
+struct DrawRecord
+{
+    mat4 model;
+    uvec4 info; // x : indice du matériau
+};
+
+layout(std430, binding = 0) readonly buffer DrawRecords
+{
+    DrawRecord draws[];
+};
+
+// Définition du bloc UBO partagé pour les matrices
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+out vec3 v_worldPos;
+out vec3 v_worldNormal;
+out vec2 v_uv;
+flat out uint v_materialIndex;
+
+// Position identique à la pré-passe de profondeur (depth_only_mdi.vs) : même expression, invariante
+invariant gl_Position;
+
+void main()
+{
+    v_uv = a_uv;
+    mat4 model = draws[a_drawId].model;
+    v_materialIndex = draws[a_drawId].info.x;
+    vec4 worldPos = model * vec4(a_position, 1.0);
+    v_worldPos = worldPos.xyz;
+    v_worldNormal = normalize(mat3(model) * a_normal);
+    gl_Position = projection * view * worldPos;
+}
@@ -3,40 +3,43 @@ out vec4 FragColor;
 
 in vec2 TexCoords;
 
-uniform sampler2D screenTexture;
-uniform int u_postProcessEffect; // 0: None, 1: Grayscale, 2: Invert, 3: Sepia
-uniform float u_saturation;      // Saturation uniform
-uniform float u_contrast;        // Contrast uniform
+uniform sampler2D screenTexture; // scène HDR (R11F_G11F_B10F)
+uniform sampler3D u_colorLut;    // effet, saturation et contraste précalculés (ColorGrading)
+uniform float u_lutSize;         // nœuds par axe de la LUT
+uniform vec2 u_uvScale;          // part de la texture rendue (résolution dynamique)
+uniform vec2 u_uvMax;            // dernier centre de texel rendu
+
+uniform sampler2D u_bloom;       // premier niveau de la pyramide de bloom (toute la zone rendue)
+uniform float u_bloomStrength;   // 0 : pas de bloom
+uniform float u_exposure;        // 2^EV
+uniform sampler2D u_averageLuminance; // luminance adaptée (AutoExposure), 1x1
+uniform int u_autoExposure;
+uniform float u_targetLuminance; // luminance moyenne visée par l'exposition automatique
+uniform int u_tonemap;           // 0 : écrêtage, 1 : Reinhard, 2 : ACES (approximation de Narkowicz)
+
+vec3 tonemap(vec3 color)
+{
+    if (u_tonemap == 1)
+        return color / (1.0 + color);
+    if (u_tonemap == 2)
+        return clamp((color * (2.51 * color + 0.03)) / (color * (2.43 * color + 0.59) + 0.14), 0.0, 1.0);
+    return clamp(color, 0.0, 1.0);
+}
 
 void main()
 {
-    vec4 color = texture(screenTexture, TexCoords);
-    vec3 processedColor = color.rgb;
-
-    // Apply selected post-process effect first
-    if (u_postProcessEffect == 1) { // Grayscale
-        float grayscale = dot(processedColor, vec3(0.2126, 0.7152, 0.0722));
-        processedColor = vec3(grayscale);
-    } else if (u_postProcessEffect == 2) { // Invert Colors
-        processedColor = vec3(1.0 - processedColor);
-    } else if (u_postProcessEffect == 3) { // Sepia
-        processedColor = vec3(
-            dot(processedColor, vec3(0.393, 0.769, 0.189)),
-            dot(processedColor, vec3(0.349, 0.686, 0.168)),
-            dot(processedColor, vec3(0.272, 0.534, 0.131))
-        );
-        processedColor = clamp(processedColor, 0.0, 1.0); // Clamp values to stay in [0,1] range
-    }
-
-    // Apply saturation adjustment
-    // Formula: mix(luminance, color, saturation)
-    float luminance = dot(processedColor, vec3(0.2126, 0.7152, 0.0722));
-    processedColor = mix(vec3(luminance), processedColor, u_saturation);
-
-    // Apply contrast adjustment
-    // Formula: (color - 0.5) * contrast + 0.5
-    processedColor = ((processedColor - 0.5) * u_contrast) + 0.5;
-    processedColor = clamp(processedColor, 0.0, 1.0); // Clamp values to stay in [0,1] range
-
-    FragColor = vec4(processedColor, color.a);
+    // Upscale bilinéaire de la zone rendue vers toute la sortie
+    vec3 hdr = texture(screenTexture, min(TexCoords * u_uvScale, u_uvMax)).rgb;
+    hdr = mix(hdr, texture(u_bloom, TexCoords).rgb, u_bloomStrength);
+
+    float exposure = u_exposure;
+    if (u_autoExposure != 0)
+        exposure *= u_targetLuminance / max(texelFetch(u_averageLuminance, ivec2(0), 0).r, 1e-4);
+    vec3 color = tonemap(hdr * exposure);
+
+    // Les nœuds extrêmes de la LUT sont au centre des texels de bord : [0, 1] -> [0.5, N - 0.5] / N
+    vec3 lutCoords = color * ((u_lutSize - 1.0) / u_lutSize) + 0.5 / u_lutSize;
+    vec3 processedColor = texture(u_colorLut, lutCoords).rgb;
+
+    FragColor = vec4(processedColor, 1.0);
 }
@@ -4,8 +4,9 @@ out vec4 FragColor;
 in vec3 v_TexCoords;
 
 uniform samplerCube u_skybox;
+uniform float u_intensity;   // ciel HDR : la cubemap LDR peut dépasser 1 dans la cible de scène
 
 void main()
 {
-    FragColor = texture(u_skybox, v_TexCoords);
+    FragColor = texture(u_skybox, v_TexCoords) * u_intensity;
 }
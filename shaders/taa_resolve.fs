@@ -0,0 +1,83 @@
+#version 330 core
+// Résolution du TAA (TemporalAA), à la résolution de sortie
+out vec4 FragColor;
+
+uniform sampler2D u_current;     // scène de la frame, zone [0, u_renderSize]
+uniform sampler2D u_depth;
+uniform sampler2D u_velocity;    // déplacement en UV écran depuis la frame précédente
+uniform sampler2D u_history;     // sortie de la frame précédente
+uniform ivec2 u_renderSize;
+uniform vec2 u_outputSize;
+uniform vec2 u_jitter;           // décalage des échantillons de la frame, en pixels internes
+uniform float u_feedback;        // poids de l'historique
+uniform int u_historyValid;
+
+// Pondération 1 / (1 + max) : un pixel HDR très lumineux ne domine pas le mélange (moins de
+// scintillement sur les arêtes contrastées), inversée à la sortie
+vec3 compress(vec3 color)
+{
+    return color / (1.0 + max(color.r, max(color.g, color.b)));
+}
+
+vec3 uncompress(vec3 color)
+{
+    return color / max(1.0 - max(color.r, max(color.g, color.b)), 1e-4);
+}
+
+vec3 toYCoCg(vec3 c)
+{
+    return vec3(0.25 * c.r + 0.5 * c.g + 0.25 * c.b, 0.5 * c.r - 0.5 * c.b, -0.25 * c.r + 0.5 * c.g - 0.25 * c.b);
+}
+
+vec3 fromYCoCg(vec3 c)
+{
+    return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+void main()
+{
+    vec2 uv = gl_FragCoord.xy / u_outputSize;
+    vec2 renderPosition = uv * vec2(u_renderSize);
+    // Texel dont l'échantillon décalé est le plus proche du centre du pixel de sortie
+    ivec2 center = clamp(ivec2(floor(renderPosition - u_jitter)), ivec2(0), u_renderSize - 1);
+
+    // Voisinage 3x3 : moments de la couleur et profondeur la plus proche
+    vec3 current = vec3(0.0);
+    vec3 moment1 = vec3(0.0);
+    vec3 moment2 = vec3(0.0);
+    float closestDepth = 2.0;
+    ivec2 closest = center;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            ivec2 texel = clamp(center + ivec2(x, y), ivec2(0), u_renderSize - 1);
+            vec3 color = toYCoCg(compress(texelFetch(u_current, texel, 0).rgb));
+            moment1 += color;
+            moment2 += color * color;
+            if (x == 0 && y == 0)
+                current = color;
+            float depth = texelFetch(u_depth, texel, 0).r;
+            if (depth < closestDepth) {
+                closestDepth = depth;
+                closest = texel;
+            }
+        }
+    }
+    vec3 mean = moment1 / 9.0;
+    vec3 sigma = sqrt(max(moment2 / 9.0 - mean * mean, 0.0));
+    vec3 boxMin = mean - 1.25 * sigma;
+    vec3 boxMax = mean + 1.25 * sigma;
+
+    // Vitesse du pixel le plus proche : les bords d'un objet au premier plan suivent l'objet
+    vec2 historyUv = uv - texelFetch(u_velocity, closest, 0).rg;
+    vec3 history = clamp(toYCoCg(compress(texture(u_history, historyUv).rgb)), boxMin, boxMax);
+
+    // Poids de l'échantillon courant : gaussienne de sa distance au centre du pixel de sortie
+    vec2 offset = vec2(center) + 0.5 + u_jitter - renderPosition;
+    float alpha = (1.0 - u_feedback) * exp(-2.29 * dot(offset, offset));
+    bool outside = any(lessThan(historyUv, vec2(0.0))) || any(greaterThan(historyUv, vec2(1.0)));
+    if (u_historyValid == 0 || outside)
+        alpha = 1.0;
+
+    vec3 result = max(fromYCoCg(mix(history, current, alpha)), vec3(0.0));
+    FragColor = vec4(uncompress(result), 1.0);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+// Vitesses écran (TemporalAA) : chaque pixel de la zone rendue est replacé dans le monde depuis sa
+// profondeur, puis projeté avec les matrices de la frame et de la frame précédente
+out vec2 FragVelocity;
+
+uniform sampler2D u_depth;
+uniform vec2 u_renderSize;
+uniform mat4 u_toCurrent;     // clip décalé de la frame -> clip sans décalage
+uniform mat4 u_toPrevious;    // clip décalé de la frame -> clip de la frame précédente
+
+void main()
+{
+    float depth = texelFetch(u_depth, ivec2(gl_FragCoord.xy), 0).r;
+    vec4 clip = vec4(gl_FragCoord.xy / u_renderSize * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
+    vec4 current = u_toCurrent * clip;
+    vec4 previous = u_toPrevious * clip;
+    // En UV écran : position courante - position précédente
+    FragVelocity = (current.xy / current.w - previous.xy / previous.w) * 0.5;
+}
@@ -2,11 +2,37 @@
 
 in vec2 v_uv;
 
-uniform sampler2D u_texture;
+// Cartes des matériaux, une couche par texture (MaterialSystem::TEXTURE_ARRAY_UNIT)
+uniform sampler2DArray u_materialTextures;
+
+// Données par objet (même déclaration que dans le vertex shader)
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo; // x : indice du matériau
+};
+
+// Table des matériaux (MaterialSystem)
+struct Material
+{
+    vec4 diffuse;   // rgb : Kd, a : opacité
+    vec4 specular;  // rgb : Ks, a : brillance (Ns)
+    vec4 ambient;   // rgb : Ka
+    ivec4 maps;     // textures diffuse, normale, occlusion, rugosité (-1 : absente)
+};
+
+layout (std140) uniform Materials
+{
+    Material u_materials[256];
+};
 
 out vec4 FragColor;
 
 void main()
 {
-    FragColor = texture(u_texture, v_uv);
+    Material material = u_materials[u_objectInfo.x];
+    vec4 albedo = vec4(material.diffuse.rgb, 1.0);
+    if (material.maps.x >= 0)
+        albedo *= texture(u_materialTextures, vec3(v_uv, float(material.maps.x)));
+    FragColor = albedo;
 }
\ No newline at end of file
@@ -5,8 +5,12 @@ layout(location = 2) in vec2 a_uv;
 
 out vec2 v_uv;
 
-// La matrice modèle reste une uniform individuelle
-uniform mat4 u_model;
+// Données par objet, écrites dans l'anneau d'uniforms et liées par glBindBufferRange
+layout (std140) uniform Object
+{
+    mat4 u_model;
+    uvec4 u_objectInfo; // x : indice du matériau
+};
 
 // Définition du bloc UBO partagé pour les matrices
 layout (std140) uniform Matrices
@@ -15,9 +19,13 @@ layout (std140) uniform Matrices
     mat4 view;
 };
 
+// Position identique à la pré-passe de profondeur (depth_only.vs) : même expression, invariante
+invariant gl_Position;
+
 void main()
 {
     v_uv = a_uv;
     // On utilise les matrices du bloc UBO
-    gl_Position = projection * view * u_model * vec4(a_position, 1.0);
+    vec4 worldPos = u_model * vec4(a_position, 1.0);
+    gl_Position = projection * view * worldPos;
 }
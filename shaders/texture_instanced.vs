@@ -0,0 +1,26 @@
+#version 330 core
+
+layout(location = 0) in vec3 a_position;
+layout(location = 2) in vec2 a_uv;
+
+// Matrice modèle par instance (divisor 1, occupe les locations 3 à 6)
+layout(location = 3) in mat4 a_instanceModel;
+
+out vec2 v_uv;
+
+// Définition du bloc UBO partagé pour les matrices
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+// Position identique à la pré-passe de profondeur (depth_only.vs) : même expression, invariante
+invariant gl_Position;
+
+void main()
+{
+    v_uv = a_uv;
+    vec4 worldPos = a_instanceModel * vec4(a_position, 1.0);
+    gl_Position = projection * view * worldPos;
+}